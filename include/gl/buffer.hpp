@@ -93,6 +93,18 @@ namespace gl {
             );
         }
 
+        // Read back part of the buffer (offset in bytes)
+        template<typename T>
+        void getSubData(T* data, size_t count, size_t offset = 0) const {
+            bind();
+            glGetBufferSubData(
+                static_cast<GLenum>(type_),
+                offset,
+                count * sizeof(T),
+                data
+            );
+        }
+
         // Get buffer size
         GLint getSize() const {
             GLint size = 0;
@@ -0,0 +1,271 @@
+#ifndef GL_COMPUTE_HOMOGRAPHY_HPP
+#define GL_COMPUTE_HOMOGRAPHY_HPP
+
+#include "common.hpp"
+#include "buffer.hpp"
+#include "shader.hpp"
+#include "texture.hpp"
+#include "warp.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+
+    namespace detail {
+
+        // One invocation per system. Each system is four vec4 corners packed
+        // as (src.x, src.y, dst.x, dst.y); the result is written as three
+        // vec4 columns so the std430 layout matches on every implementation.
+        // Elimination mirrors solveHomographyLanes: partial pivoting, and a
+        // zero matrix for singular systems.
+        inline const char* HOMOGRAPHY_SOLVE_SHADER = R"(#version 430
+layout(local_size_x = 64) in;
+
+layout(std430, binding = 0) readonly buffer Correspondences { vec4 corners[]; };
+layout(std430, binding = 1) writeonly buffer Homographies { vec4 columns[]; };
+
+uniform uint u_count;
+
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= u_count) return;
+
+    float A[8][9];
+    for (int i = 0; i < 4; ++i) {
+        vec4 c = corners[id * 4u + uint(i)];
+        A[i * 2][0] = c.x;  A[i * 2][1] = c.y;  A[i * 2][2] = 1.0;
+        A[i * 2][3] = 0.0;  A[i * 2][4] = 0.0;  A[i * 2][5] = 0.0;
+        A[i * 2][6] = -c.x * c.z;  A[i * 2][7] = -c.y * c.z;  A[i * 2][8] = c.z;
+
+        A[i * 2 + 1][0] = 0.0;  A[i * 2 + 1][1] = 0.0;  A[i * 2 + 1][2] = 0.0;
+        A[i * 2 + 1][3] = c.x;  A[i * 2 + 1][4] = c.y;  A[i * 2 + 1][5] = 1.0;
+        A[i * 2 + 1][6] = -c.x * c.w;  A[i * 2 + 1][7] = -c.y * c.w;  A[i * 2 + 1][8] = c.w;
+    }
+
+    for (int col = 0; col < 8; ++col) {
+        int pivot = col;
+        float best = abs(A[col][col]);
+        for (int r = col + 1; r < 8; ++r) {
+            if (abs(A[r][col]) > best) {
+                best = abs(A[r][col]);
+                pivot = r;
+            }
+        }
+        if (best < 1e-10) {
+            columns[id * 3u] = vec4(0.0);
+            columns[id * 3u + 1u] = vec4(0.0);
+            columns[id * 3u + 2u] = vec4(0.0);
+            return;
+        }
+        if (pivot != col) {
+            for (int k = col; k < 9; ++k) {
+                float t = A[col][k];
+                A[col][k] = A[pivot][k];
+                A[pivot][k] = t;
+            }
+        }
+        float inv = 1.0 / A[col][col];
+        for (int r = col + 1; r < 8; ++r) {
+            float f = A[r][col] * inv;
+            for (int k = col + 1; k < 9; ++k) {
+                A[r][k] -= f * A[col][k];
+            }
+        }
+    }
+
+    float h[8];
+    for (int r = 7; r >= 0; --r) {
+        float x = A[r][8];
+        for (int k = r + 1; k < 8; ++k) {
+            x -= A[r][k] * h[k];
+        }
+        h[r] = x / A[r][r];
+    }
+
+    columns[id * 3u] = vec4(h[0], h[3], h[6], 0.0);
+    columns[id * 3u + 1u] = vec4(h[1], h[4], h[7], 0.0);
+    columns[id * 3u + 2u] = vec4(h[2], h[5], 1.0, 0.0);
+}
+)";
+
+        // One invocation per destination pixel. Same conventions as the CPU
+        // warpPerspective: H maps destination pixel centres (integer
+        // coordinates) to source pixel coordinates, and samples outside the
+        // source take the border colour.
+        inline const char* HOMOGRAPHY_WARP_SHADER = R"(#version 430
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(std430, binding = 1) readonly buffer Homographies { vec4 columns[]; };
+layout(binding = 0) uniform sampler2D u_source;
+layout(rgba8, binding = 0) writeonly uniform image2D u_destination;
+
+uniform uint u_index;
+uniform bool u_nearest;
+uniform vec4 u_borderColor;
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(u_destination);
+    if (pixel.x >= size.x || pixel.y >= size.y) return;
+
+    uint base = u_index * 3u;
+    mat3 H = mat3(columns[base].xyz, columns[base + 1u].xyz, columns[base + 2u].xyz);
+    vec3 p = H * vec3(vec2(pixel), 1.0);
+
+    vec4 color = u_borderColor;
+    vec2 sourceSize = vec2(textureSize(u_source, 0));
+    if (p.z != 0.0) {
+        vec2 uv = p.xy / p.z;
+        bool inside = u_nearest
+            ? all(greaterThanEqual(uv, vec2(-0.5))) && all(lessThan(uv, sourceSize - 0.5))
+            : all(greaterThanEqual(uv, vec2(0.0))) && all(lessThanEqual(uv, sourceSize - 1.0));
+        if (inside) {
+            color = textureLod(u_source, (uv + 0.5) / sourceSize, 0.0);
+        }
+    }
+    imageStore(u_destination, pixel, color);
+}
+)";
+
+    } // namespace detail
+
+    // Solves batches of 4-point homographies on the GPU, one compute shader
+    // invocation per system. Results stay resident in an SSBO (three vec4
+    // columns per matrix) so they can feed ComputeWarp without a round trip.
+    // Requires a current OpenGL 4.3+ context.
+    class ComputeHomographySolver {
+    public:
+        static constexpr GLuint WORKGROUP_SIZE = 64;
+
+        ComputeHomographySolver()
+            : program_(Shader::fromComputeSource(detail::HOMOGRAPHY_SOLVE_SHADER)) {
+        }
+
+        // Upload the correspondences and dispatch the solve (src -> dst per system)
+        void dispatch(std::span<const std::array<glm::vec2, 4>> src,
+            std::span<const std::array<glm::vec2, 4>> dst) {
+            if (src.size() != dst.size()) {
+                throw std::invalid_argument("Compute homography batch size mismatch");
+            }
+            count_ = src.size();
+            if (count_ == 0) return;
+
+            packed_.resize(count_ * 4);
+            for (std::size_t i = 0; i < count_; ++i) {
+                for (int c = 0; c < 4; ++c) {
+                    packed_[i * 4 + c] = glm::vec4(src[i][c], dst[i][c]);
+                }
+            }
+            correspondences_.setData(packed_, BufferUsage::StreamDraw);
+
+            if (count_ > capacity_) {
+                homographies_.setData<glm::vec4>(nullptr, count_ * 3, BufferUsage::DynamicCopy);
+                capacity_ = count_;
+            }
+
+            program_.use();
+            program_.setUint("u_count", static_cast<unsigned int>(count_));
+            correspondences_.bindBase(0);
+            homographies_.bindBase(1);
+            program_.dispatch(static_cast<GLuint>((count_ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE));
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        }
+
+        // Copy the results of the last dispatch back (singular systems are zero matrices)
+        void readResults(std::span<glm::mat3> out) const {
+            if (out.size() != count_) {
+                throw std::invalid_argument("Compute homography result size mismatch");
+            }
+            if (count_ == 0) return;
+
+            readback_.resize(count_ * 3);
+            homographies_.getSubData(readback_.data(), readback_.size());
+            for (std::size_t i = 0; i < count_; ++i) {
+                out[i] = glm::mat3(glm::vec3(readback_[i * 3]), glm::vec3(readback_[i * 3 + 1]),
+                    glm::vec3(readback_[i * 3 + 2]));
+            }
+        }
+
+        // dispatch() followed by readResults()
+        void solve(std::span<const std::array<glm::vec2, 4>> src,
+            std::span<const std::array<glm::vec2, 4>> dst, std::span<glm::mat3> out) {
+            dispatch(src, dst);
+            readResults(out);
+        }
+
+        const ShaderStorageBuffer& getResultBuffer() const { return homographies_; }
+        std::size_t getCount() const { return count_; }
+
+    private:
+        Shader program_;
+        ShaderStorageBuffer correspondences_;
+        ShaderStorageBuffer homographies_;
+        std::vector<glm::vec4> packed_;
+        mutable std::vector<glm::vec4> readback_;
+        std::size_t count_ = 0;
+        std::size_t capacity_ = 0;
+    };
+
+    // Perspective warp on the GPU driven by a homography that lives in a
+    // solver result buffer. The destination must be an RGBA8 texture with
+    // immutable storage (Texture::allocate).
+    class ComputeWarp {
+    public:
+        static constexpr GLuint WORKGROUP_SIZE = 16;
+
+        ComputeWarp()
+            : program_(Shader::fromComputeSource(detail::HOMOGRAPHY_WARP_SHADER)) {
+            glGenSamplers(1, &sampler_);
+            if (sampler_ == 0) {
+                throw GLException("Failed to create sampler");
+            }
+            glSamplerParameteri(sampler_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glSamplerParameteri(sampler_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        ~ComputeWarp() {
+            if (sampler_ != 0) {
+                glDeleteSamplers(1, &sampler_);
+            }
+        }
+
+        // Prevent copying (owns a sampler object)
+        ComputeWarp(const ComputeWarp&) = delete;
+        ComputeWarp& operator=(const ComputeWarp&) = delete;
+
+        // Warp source into destination with homography `index` of the buffer
+        void dispatch(const Texture& source, Texture& destination, const ShaderStorageBuffer& homographies,
+            std::size_t index, WarpFilter filter = WarpFilter::Bilinear,
+            const glm::vec4& borderColor = glm::vec4(0.0f)) {
+            GLint mode = filter == WarpFilter::Nearest ? GL_NEAREST : GL_LINEAR;
+            glSamplerParameteri(sampler_, GL_TEXTURE_MIN_FILTER, mode);
+            glSamplerParameteri(sampler_, GL_TEXTURE_MAG_FILTER, mode);
+
+            program_.use();
+            program_.setUint("u_index", static_cast<unsigned int>(index));
+            program_.setBool("u_nearest", filter == WarpFilter::Nearest);
+            program_.setVec4("u_borderColor", borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
+            source.bind(0);
+            glBindSampler(0, sampler_);
+            destination.bindImage(0, GL_WRITE_ONLY);
+            homographies.bindBase(1);
+
+            program_.dispatch((destination.getWidth() + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+                (destination.getHeight() + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+            glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            glBindSampler(0, 0);
+        }
+
+    private:
+        Shader program_;
+        GLuint sampler_ = 0;
+    };
+
+} // namespace gl
+
+#endif // GL_COMPUTE_HOMOGRAPHY_HPP
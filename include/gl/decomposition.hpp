@@ -0,0 +1,253 @@
+#ifndef GL_DECOMPOSITION_HPP
+#define GL_DECOMPOSITION_HPP
+
+#include "simd.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+namespace gl {
+
+    // Pinhole intrinsics for image coordinates with the origin at the bottom
+    // left and y up (OpenGL window convention). The camera frame is OpenGL
+    // view space: x right, y up, looking down -z. A view-space point P
+    // projects to u = fx * P.x / -P.z + cx, v = fy * P.y / -P.z + cy.
+    struct CameraIntrinsics {
+        float fx = 1.0f;
+        float fy = 1.0f;
+        float cx = 0.0f;
+        float cy = 0.0f;
+
+        // K with (u w, v w, w) = K * P, where w = -P.z
+        glm::mat3 toMatrix() const {
+            glm::mat3 K(0.0f);
+            K[0][0] = fx;
+            K[1][1] = fy;
+            K[2] = glm::vec3(-cx, -cy, -1.0f);
+            return K;
+        }
+    };
+
+    // Intrinsics matching an OpenGL projection matrix (e.g.
+    // CameraComponent::getProjectionMatrix) for images of imageSize units:
+    // the viewport size for window pixels, (1, 1) for [0,1] screen coordinates
+    inline CameraIntrinsics intrinsicsFromProjection(const glm::mat4& projection, const glm::vec2& imageSize) {
+        CameraIntrinsics K;
+        K.fx = 0.5f * imageSize.x * projection[0][0];
+        K.fy = 0.5f * imageSize.y * projection[1][1];
+        K.cx = 0.5f * imageSize.x * (1.0f - projection[2][0]);
+        K.cy = 0.5f * imageSize.y * (1.0f - projection[2][1]);
+        return K;
+    }
+
+    // Pose of a plane relative to the camera, in view space. The plane's
+    // (x, y) coordinates are the source coordinates of the homography and
+    // its z = 0 plane maps through [R | t].
+    struct HomographyPose {
+        glm::mat3 rotation = glm::mat3(1.0f);
+        glm::vec3 translation = glm::vec3(0.0f);
+        glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f); // plane +z axis (third column of R)
+        float distance = 0.0f;                          // camera centre to plane
+        bool valid = false;
+
+        // Model-view matrix that places plane geometry; draw it with the
+        // projection the intrinsics came from for an AR overlay
+        glm::mat4 toModelView() const {
+            glm::mat4 M(rotation);
+            M[3] = glm::vec4(translation, 1.0f);
+            return M;
+        }
+    };
+
+    // Both solutions of a plane-to-image homography. H ~ K [r1 r2 t] fixes
+    // the pose up to the sign of the scale; the candidates are that pair,
+    // and best is the one that puts the reference point in front of the
+    // camera (-1 when the homography is degenerate).
+    struct HomographyDecomposition {
+        std::array<HomographyPose, 2> candidates;
+        int best = -1;
+
+        const HomographyPose* pose() const { return best >= 0 ? &candidates[best] : nullptr; }
+    };
+
+    namespace detail {
+
+        template<typename V>
+        struct Vec3Lanes {
+            V x, y, z;
+        };
+
+        template<typename V>
+        Vec3Lanes<V> laneCross(const Vec3Lanes<V>& a, const Vec3Lanes<V>& b) {
+            return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        }
+
+        template<typename V>
+        V laneDot(const Vec3Lanes<V>& a, const Vec3Lanes<V>& b) {
+            return simd::fmadd(a.x, b.x, simd::fmadd(a.y, b.y, a.z * b.z));
+        }
+
+        template<typename V>
+        Vec3Lanes<V> laneScale(const Vec3Lanes<V>& a, V s) {
+            return { a.x * s, a.y * s, a.z * s };
+        }
+
+        // Positive-scale decomposition of V::Width homographies. h[c][r] holds
+        // element [c][r] (glm column-major) of every lane. Outputs the
+        // orthonormalized columns of R and t, plus the camera-space depth of
+        // the plane point (refX, refY), which is negative when it lies in
+        // front of the camera. Lanes where K^-1 H has no scale are zeroed and
+        // flagged in the returned mask.
+        template<typename V>
+        typename V::Mask decomposeLanes(const V h[3][3], const CameraIntrinsics& K, V refX, V refY,
+            Vec3Lanes<V>& r1, Vec3Lanes<V>& r2, Vec3Lanes<V>& r3, Vec3Lanes<V>& t, V& depth) {
+            const V ifx(1.0f / K.fx), ify(1.0f / K.fy);
+            const V cx(K.cx), cy(K.cy);
+            const V zero(0.0f);
+            const V invSqrt2(0.70710678f);
+
+            // M = K^-1 H
+            Vec3Lanes<V> m[3];
+            for (int c = 0; c < 3; ++c) {
+                m[c].x = (h[c][0] - cx * h[c][2]) * ifx;
+                m[c].y = (h[c][1] - cy * h[c][2]) * ify;
+                m[c].z = -h[c][2];
+            }
+
+            // Average the two column norms for the scale
+            const V norms = simd::sqrt(laneDot(m[0], m[0])) + simd::sqrt(laneDot(m[1], m[1]));
+            const auto degenerate = norms <= V(1e-12f);
+            const V lambda = simd::select(degenerate, zero, V(2.0f) / norms);
+
+            r1 = laneScale(m[0], lambda);
+            r2 = laneScale(m[1], lambda);
+            t = laneScale(m[2], lambda);
+            depth = simd::fmadd(refX, r1.z, simd::fmadd(refY, r2.z, t.z));
+
+            // Nearest orthonormal pair, symmetric in r1 and r2: split the
+            // bisector c and its in-plane perpendicular d evenly
+            const Vec3Lanes<V> c = { r1.x + r2.x, r1.y + r2.y, r1.z + r2.z };
+            const Vec3Lanes<V> d = laneCross(c, laneCross(r1, r2));
+            const V cn = laneDot(c, c), dn = laneDot(d, d);
+            const V ic = simd::select(degenerate, zero, invSqrt2 / simd::sqrt(simd::select(degenerate, V(1.0f), cn)));
+            const V id = simd::select(degenerate, zero, invSqrt2 / simd::sqrt(simd::select(degenerate, V(1.0f), dn)));
+            r1 = { c.x * ic + d.x * id, c.y * ic + d.y * id, c.z * ic + d.z * id };
+            r2 = { c.x * ic - d.x * id, c.y * ic - d.y * id, c.z * ic - d.z * id };
+            r3 = laneCross(r1, r2);
+            return degenerate;
+        }
+
+        inline HomographyPose makePose(const glm::vec3& r1, const glm::vec3& r2, const glm::vec3& r3,
+            const glm::vec3& t, bool valid) {
+            HomographyPose pose;
+            pose.rotation = glm::mat3(r1, r2, r3);
+            pose.translation = t;
+            pose.normal = r3;
+            pose.distance = glm::abs(glm::dot(r3, t));
+            pose.valid = valid;
+            return pose;
+        }
+
+    } // namespace detail
+
+    // Recover the plane pose from a homography mapping plane coordinates
+    // (for example the unit square passed to computeHomography) to image
+    // coordinates in the convention of K. The reference point, in plane
+    // coordinates, decides which candidate is in front of the camera.
+    inline HomographyDecomposition decomposeHomography(const glm::mat3& H, const CameraIntrinsics& K,
+        const glm::vec2& reference = glm::vec2(0.0f)) {
+        using V = simd::FloatX1;
+        V h[3][3];
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                h[c][r] = H[c][r];
+            }
+        }
+
+        detail::Vec3Lanes<V> r1, r2, r3, t;
+        V depth;
+        const bool degenerate = detail::decomposeLanes(h, K, V(reference.x), V(reference.y), r1, r2, r3, t, depth);
+
+        const glm::vec3 a(r1.x.v, r1.y.v, r1.z.v);
+        const glm::vec3 b(r2.x.v, r2.y.v, r2.z.v);
+        const glm::vec3 n(r3.x.v, r3.y.v, r3.z.v);
+        const glm::vec3 p(t.x.v, t.y.v, t.z.v);
+
+        // Negating the scale flips r1, r2 and t; r3 = r1 x r2 is unchanged
+        HomographyDecomposition result;
+        result.candidates[0] = detail::makePose(a, b, n, p, !degenerate);
+        result.candidates[1] = detail::makePose(-a, -b, n, -p, !degenerate);
+        if (!degenerate && depth.v != 0.0f) {
+            result.best = depth.v < 0.0f ? 0 : 1;
+        }
+        return result;
+    }
+
+    // Decompose many homographies sharing one camera, V::Width at a time,
+    // keeping only the candidate in front of the camera. Returns the number
+    // of degenerate homographies, whose pose has valid == false.
+    template<typename V = simd::NativeFloat>
+    std::size_t decomposeHomographyBatch(std::span<const glm::mat3> homographies, const CameraIntrinsics& K,
+        std::span<HomographyPose> out, const glm::vec2& reference = glm::vec2(0.0f)) {
+        if (homographies.size() != out.size()) {
+            throw std::invalid_argument("Decomposition batch spans must have the same length");
+        }
+
+        constexpr int W = V::Width;
+        alignas(64) float hs[3][3][W];
+        alignas(64) float rs[4][3][W];
+        std::size_t degenerateCount = 0;
+
+        for (std::size_t base = 0; base < homographies.size(); base += W) {
+            const std::size_t lanes = std::min<std::size_t>(W, homographies.size() - base);
+
+            // Transpose into SoA; pad the tail with the identity
+            for (int lane = 0; lane < W; ++lane) {
+                const glm::mat3 H = static_cast<std::size_t>(lane) < lanes ? homographies[base + lane] : glm::mat3(1.0f);
+                for (int c = 0; c < 3; ++c) {
+                    for (int r = 0; r < 3; ++r) {
+                        hs[c][r][lane] = H[c][r];
+                    }
+                }
+            }
+
+            V h[3][3];
+            for (int c = 0; c < 3; ++c) {
+                for (int r = 0; r < 3; ++r) {
+                    h[c][r] = V::load(hs[c][r]);
+                }
+            }
+
+            detail::Vec3Lanes<V> r1, r2, r3, t;
+            V depth;
+            const unsigned degenerate = simd::maskBits(
+                detail::decomposeLanes(h, K, V(reference.x), V(reference.y), r1, r2, r3, t, depth));
+
+            // Take the negative-scale candidate where the reference is behind the camera
+            const auto behind = depth > V(0.0f);
+            const V sign = simd::select(behind, V(-1.0f), V(1.0f));
+            const detail::Vec3Lanes<V> columns[4] = {
+                detail::laneScale(r1, sign), detail::laneScale(r2, sign), r3, detail::laneScale(t, sign)
+            };
+            for (int c = 0; c < 4; ++c) {
+                columns[c].x.store(rs[c][0]);
+                columns[c].y.store(rs[c][1]);
+                columns[c].z.store(rs[c][2]);
+            }
+
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                auto column = [&](int c) { return glm::vec3(rs[c][0][lane], rs[c][1][lane], rs[c][2][lane]); };
+                const bool valid = !(degenerate & (1u << lane));
+                out[base + lane] = detail::makePose(column(0), column(1), column(2), column(3), valid);
+                degenerateCount += valid ? 0 : 1;
+            }
+        }
+        return degenerateCount;
+    }
+
+} // namespace gl
+
+#endif // GL_DECOMPOSITION_HPP
@@ -0,0 +1,666 @@
+#ifndef GL_FEATURES_HPP
+#define GL_FEATURES_HPP
+
+#include "image.hpp"
+#include "projection.hpp"
+#include "ransac.hpp"
+#include "refine.hpp"
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+
+    // 256-bit binary descriptor (steered BRIEF)
+    using Descriptor = std::array<std::uint64_t, 4>;
+
+    // Keypoints closer than this to the image edge have no descriptor:
+    // orientation patch radius 15 plus one pixel of slack for the sample boxes
+    constexpr int FEATURE_MARGIN = 16;
+
+    struct Keypoint {
+        glm::vec2 position = glm::vec2(0.0f);
+        float score = 0.0f; // FAST score: largest threshold the corner still passes
+        float angle = 0.0f; // Intensity-centroid orientation in radians, set by computeDescriptors
+    };
+
+    struct FeatureOptions {
+        // FAST intensity threshold
+        int threshold = 20;
+
+        // Keep the strongest corners after non-maximum suppression
+        std::size_t maxKeypoints = 2000;
+
+        // Pool for rows and keypoints; nullptr uses getDefaultJobSystem()
+        JobSystem* pool = nullptr;
+    };
+
+    struct Match {
+        std::uint32_t queryIndex = 0;
+        std::uint32_t trainIndex = 0;
+        std::uint32_t distance = 0;
+    };
+
+    struct MatchOptions {
+        // Matches farther apart than this many bits are rejected
+        std::uint32_t maxDistance = 64;
+
+        // Lowe's ratio test: best distance must be below ratio * second best
+        float ratio = 0.8f;
+
+        // Keep only matches that are also the best in the other direction
+        bool crossCheck = false;
+
+        JobSystem* pool = nullptr;
+    };
+
+    namespace detail {
+
+        // Rows or keypoints per pool task
+        constexpr int FEATURE_ROW_BLOCK = 16;
+        constexpr std::size_t FEATURE_POINT_BLOCK = 64;
+
+        // Bresenham circle of radius 3, clockwise from the top
+        constexpr int FAST_CIRCLE[16][2] = {
+            { 0, -3 }, { 1, -3 }, { 2, -2 }, { 3, -1 }, { 3, 0 }, { 3, 1 }, { 2, 2 }, { 1, 3 },
+            { 0, 3 }, { -1, 3 }, { -2, 2 }, { -3, 1 }, { -3, 0 }, { -3, -1 }, { -2, -2 }, { -1, -3 }
+        };
+
+        // FAST-9 on B::Width consecutive pixels: bit i is set when pixel i has
+        // 9 contiguous circle pixels all brighter or all darker by the threshold
+        template<typename B>
+        std::uint64_t fastCornerBits(const std::uint8_t* center, const std::ptrdiff_t offsets[16], B threshold) {
+            const B c = B::load(center);
+            const B hi = simd::addSaturate(c, threshold);
+            const B lo = simd::subSaturate(c, threshold);
+
+            B bright[16], dark[16];
+            // A 9-pixel arc always covers two of the four compass pixels
+            B compass(std::uint8_t(0));
+            for (int k = 0; k < 16; k += 4) {
+                const B p = B::load(center + offsets[k]);
+                bright[k] = p > hi;
+                dark[k] = p < lo;
+                compass = compass | bright[k] | dark[k];
+            }
+            if (simd::nonzeroBits(compass) == 0) {
+                return 0;
+            }
+            for (int k = 0; k < 16; ++k) {
+                if (k % 4 == 0) continue;
+                const B p = B::load(center + offsets[k]);
+                bright[k] = p > hi;
+                dark[k] = p < lo;
+            }
+
+            // Longest run around the circle, wrapping once
+            B runBright(std::uint8_t(0)), runDark(std::uint8_t(0));
+            B longestBright(std::uint8_t(0)), longestDark(std::uint8_t(0));
+            for (int k = 0; k < 16 + 8; ++k) {
+                runBright = simd::countRun(runBright, bright[k & 15]);
+                runDark = simd::countRun(runDark, dark[k & 15]);
+                longestBright = simd::max(longestBright, runBright);
+                longestDark = simd::max(longestDark, runDark);
+            }
+            const B eight(std::uint8_t(8));
+            return simd::nonzeroBits((longestBright > eight) | (longestDark > eight));
+        }
+
+        // Largest threshold for which the pixel still has a 9-pixel arc
+        inline int fastScore(const std::uint8_t* center, const std::ptrdiff_t offsets[16]) {
+            int d[16];
+            for (int k = 0; k < 16; ++k) {
+                d[k] = static_cast<int>(center[offsets[k]]) - static_cast<int>(*center);
+            }
+            int best = 0;
+            for (int start = 0; start < 16; ++start) {
+                int lowest = 255, highest = -255;
+                for (int k = 0; k < 9; ++k) {
+                    lowest = std::min(lowest, d[(start + k) & 15]);
+                    highest = std::max(highest, d[(start + k) & 15]);
+                }
+                best = std::max({ best, lowest, -highest });
+            }
+            return best;
+        }
+
+        constexpr int BRIEF_ANGLE_BINS = 30;
+        constexpr int BRIEF_PATCH_RADIUS = 13;
+        constexpr int ORIENTATION_RADIUS = 15;
+
+        // Test pairs (x1, y1, x2, y2) drawn once from an isotropic Gaussian
+        // over the patch. A local generator keeps the pattern identical on
+        // every platform, so descriptors are comparable across builds.
+        inline const std::array<std::array<float, 4>, 256>& briefPattern() {
+            static const std::array<std::array<float, 4>, 256> pattern = [] {
+                std::array<std::array<float, 4>, 256> p{};
+                std::uint64_t state = 0x9E3779B97F4A7C15ull;
+                auto uniform = [&] {
+                    state = state * 6364136223846793005ull + 1442695040888963407ull;
+                    return (static_cast<float>(state >> 40) + 0.5f) / 16777216.0f;
+                };
+                const float sigma = 31.0f / 5.0f;
+                const float limit = static_cast<float>(BRIEF_PATCH_RADIUS);
+                for (auto& pair : p) {
+                    for (int i = 0; i < 4; i += 2) {
+                        float x, y;
+                        do {
+                            // Box-Muller
+                            const float r = sigma * std::sqrt(-2.0f * std::log(uniform()));
+                            const float theta = 2.0f * std::numbers::pi_v<float> * uniform();
+                            x = std::round(r * std::cos(theta));
+                            y = std::round(r * std::sin(theta));
+                        } while (x * x + y * y > limit * limit);
+                        pair[i] = x;
+                        pair[i + 1] = y;
+                    }
+                }
+                return p;
+            }();
+            return pattern;
+        }
+
+        // Summed-area table with a zero first row and column. Sums wrap
+        // modulo 2^32 on very large images, but box sums of a few pixels
+        // still come out exact in unsigned arithmetic.
+        inline void computeIntegral(const Image& gray, std::vector<std::uint32_t>& integral, JobSystem& pool) {
+            const int w = gray.getWidth(), h = gray.getHeight();
+            const std::size_t stride = static_cast<std::size_t>(w) + 1;
+            integral.resize(stride * (h + 1));
+            std::fill_n(integral.begin(), stride, 0u);
+
+            const std::size_t blocks = (h + FEATURE_ROW_BLOCK - 1) / FEATURE_ROW_BLOCK;
+            pool.parallelFor(blocks, [&](std::size_t block) {
+                const int y1 = std::min(h, static_cast<int>(block + 1) * FEATURE_ROW_BLOCK);
+                for (int y = static_cast<int>(block) * FEATURE_ROW_BLOCK; y < y1; ++y) {
+                    const std::uint8_t* src = gray.getRow(y);
+                    std::uint32_t* row = integral.data() + (y + 1) * stride;
+                    std::uint32_t sum = 0;
+                    row[0] = 0;
+                    for (int x = 0; x < w; ++x) {
+                        sum += src[x];
+                        row[x + 1] = sum;
+                    }
+                }
+            });
+            // Column pass: each row adds the one above, contiguous and vectorizable
+            for (int y = 2; y <= h; ++y) {
+                std::uint32_t* row = integral.data() + y * stride;
+                const std::uint32_t* above = row - stride;
+                for (std::size_t x = 1; x < stride; ++x) {
+                    row[x] += above[x];
+                }
+            }
+        }
+
+        // For every angle bin: 256 offsets of the first sample box's top-left
+        // integral entry, then 256 for the second, relative to the keypoint
+        inline std::vector<std::int32_t> steeredOffsets(std::size_t integralStride) {
+            const auto& pattern = briefPattern();
+            const int stride = static_cast<int>(integralStride);
+            std::vector<std::int32_t> offsets(BRIEF_ANGLE_BINS * 512);
+            for (int bin = 0; bin < BRIEF_ANGLE_BINS; ++bin) {
+                const float angle = 2.0f * std::numbers::pi_v<float> * bin / BRIEF_ANGLE_BINS;
+                const float c = std::cos(angle), s = std::sin(angle);
+                std::int32_t* out = offsets.data() + bin * 512;
+                for (int t = 0; t < 256; ++t) {
+                    for (int i = 0; i < 2; ++i) {
+                        const float x = pattern[t][2 * i], y = pattern[t][2 * i + 1];
+                        const int rx = static_cast<int>(std::lround(c * x - s * y));
+                        const int ry = static_cast<int>(std::lround(s * x + c * y));
+                        // 5x5 box centred on the sample: rows ry-2..ry+2
+                        out[i * 256 + t] = (ry - 2) * stride + (rx - 2);
+                    }
+                }
+            }
+            return offsets;
+        }
+
+        inline float intensityCentroidAngle(const Image& gray, int x0, int y0) {
+            constexpr int r = ORIENTATION_RADIUS;
+            int m01 = 0, m10 = 0;
+            for (int dy = -r; dy <= r; ++dy) {
+                const int span = static_cast<int>(std::sqrt(static_cast<float>(r * r - dy * dy)) + 0.5f);
+                const std::uint8_t* row = gray.getRow(y0 + dy) + x0;
+                int sum = 0, weighted = 0;
+                for (int dx = -span; dx <= span; ++dx) {
+                    sum += row[dx];
+                    weighted += dx * row[dx];
+                }
+                m10 += weighted;
+                m01 += dy * sum;
+            }
+            return std::atan2(static_cast<float>(m01), static_cast<float>(m10));
+        }
+
+        // 256 box-pair comparisons for one keypoint, bit t set when box A < box B.
+        // The wide paths fetch all four corners of V::Width boxes per gather.
+        template<typename V>
+        Descriptor steeredBrief(const std::uint32_t* integral, std::size_t stride, std::int32_t base,
+            const std::int32_t* offsetsA, const std::int32_t* offsetsB) {
+            Descriptor d{};
+            const std::int32_t down = static_cast<std::int32_t>(5 * stride);
+#if defined(__AVX512F__)
+            if constexpr (V::Width == 16) {
+                const int* table = reinterpret_cast<const int*>(integral);
+                const __m512i vbase = _mm512_set1_epi32(base);
+                auto box = [&](__m512i tl) {
+                    const __m512i a = _mm512_i32gather_epi32(tl, table, 4);
+                    const __m512i b = _mm512_i32gather_epi32(_mm512_add_epi32(tl, _mm512_set1_epi32(5)), table, 4);
+                    const __m512i c = _mm512_i32gather_epi32(_mm512_add_epi32(tl, _mm512_set1_epi32(down)), table, 4);
+                    const __m512i e = _mm512_i32gather_epi32(_mm512_add_epi32(tl, _mm512_set1_epi32(down + 5)), table, 4);
+                    return _mm512_sub_epi32(_mm512_add_epi32(e, a), _mm512_add_epi32(b, c));
+                };
+                for (int t = 0; t < 256; t += 16) {
+                    const __m512i sa = box(_mm512_add_epi32(vbase, _mm512_loadu_si512(offsetsA + t)));
+                    const __m512i sb = box(_mm512_add_epi32(vbase, _mm512_loadu_si512(offsetsB + t)));
+                    const std::uint64_t bits = _mm512_cmplt_epi32_mask(sa, sb);
+                    d[t / 64] |= bits << (t % 64);
+                }
+                return d;
+            }
+#endif
+#if defined(__AVX2__)
+            if constexpr (V::Width == 8) {
+                const int* table = reinterpret_cast<const int*>(integral);
+                const __m256i vbase = _mm256_set1_epi32(base);
+                auto box = [&](__m256i tl) {
+                    const __m256i a = _mm256_i32gather_epi32(table, tl, 4);
+                    const __m256i b = _mm256_i32gather_epi32(table, _mm256_add_epi32(tl, _mm256_set1_epi32(5)), 4);
+                    const __m256i c = _mm256_i32gather_epi32(table, _mm256_add_epi32(tl, _mm256_set1_epi32(down)), 4);
+                    const __m256i e = _mm256_i32gather_epi32(table, _mm256_add_epi32(tl, _mm256_set1_epi32(down + 5)), 4);
+                    return _mm256_sub_epi32(_mm256_add_epi32(e, a), _mm256_add_epi32(b, c));
+                };
+                for (int t = 0; t < 256; t += 8) {
+                    const __m256i sa = box(_mm256_add_epi32(vbase, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsetsA + t))));
+                    const __m256i sb = box(_mm256_add_epi32(vbase, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsetsB + t))));
+                    const std::uint64_t bits = static_cast<std::uint32_t>(
+                        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(sb, sa))));
+                    d[t / 64] |= bits << (t % 64);
+                }
+                return d;
+            }
+#endif
+            auto box = [&](std::int32_t tl) {
+                const std::uint32_t* p = integral + tl;
+                return static_cast<std::int32_t>(p[down + 5] + p[0] - p[5] - p[down]);
+            };
+            for (int t = 0; t < 256; ++t) {
+                if (box(base + offsetsA[t]) < box(base + offsetsB[t])) {
+                    d[t / 64] |= std::uint64_t(1) << (t % 64);
+                }
+            }
+            return d;
+        }
+
+        // Descriptors transposed into blocks of eight, word-major, so one
+        // query word is compared against eight descriptors per instruction
+        constexpr std::size_t HAMMING_BLOCK = 8;
+
+        inline std::vector<std::uint64_t> transposeDescriptors(std::span<const Descriptor> descriptors) {
+            const std::size_t blocks = (descriptors.size() + HAMMING_BLOCK - 1) / HAMMING_BLOCK;
+            std::vector<std::uint64_t> out(blocks * 4 * HAMMING_BLOCK, 0);
+            for (std::size_t i = 0; i < descriptors.size(); ++i) {
+                std::uint64_t* block = out.data() + (i / HAMMING_BLOCK) * 4 * HAMMING_BLOCK;
+                for (int w = 0; w < 4; ++w) {
+                    block[w * HAMMING_BLOCK + i % HAMMING_BLOCK] = descriptors[i][w];
+                }
+            }
+            return out;
+        }
+
+        // Hamming distances from q to the eight descriptors of one block:
+        // VPOPCNTDQ when available, otherwise the AVX2 nibble-table popcount
+        template<typename V>
+        void hammingBlock(const std::uint64_t* block, const Descriptor& q, std::uint32_t out[HAMMING_BLOCK]) {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+            if constexpr (V::Width > 1) {
+                __m512i sum = _mm512_setzero_si512();
+                for (int w = 0; w < 4; ++w) {
+                    const __m512i x = _mm512_xor_si512(_mm512_loadu_si512(block + w * HAMMING_BLOCK),
+                        _mm512_set1_epi64(static_cast<long long>(q[w])));
+                    sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm512_cvtepi64_epi32(sum));
+                return;
+            }
+#elif defined(__AVX2__)
+            if constexpr (V::Width > 1) {
+                const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+                const __m256i nibble = _mm256_set1_epi8(0x0F);
+                for (int half = 0; half < 2; ++half) {
+                    __m256i counts = _mm256_setzero_si256();
+                    for (int w = 0; w < 4; ++w) {
+                        const __m256i x = _mm256_xor_si256(
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + w * HAMMING_BLOCK + half * 4)),
+                            _mm256_set1_epi64x(static_cast<long long>(q[w])));
+                        const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble));
+                        const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+                        counts = _mm256_add_epi8(counts, _mm256_add_epi8(lo, hi)); // at most 32 per byte
+                    }
+                    // Sum the bytes of each 64-bit lane
+                    alignas(32) std::uint64_t sums[4];
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+                    for (int i = 0; i < 4; ++i) {
+                        out[half * 4 + i] = static_cast<std::uint32_t>(sums[i]);
+                    }
+                }
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < HAMMING_BLOCK; ++i) {
+                std::uint32_t distance = 0;
+                for (int w = 0; w < 4; ++w) {
+                    distance += static_cast<std::uint32_t>(std::popcount(block[w * HAMMING_BLOCK + i] ^ q[w]));
+                }
+                out[i] = distance;
+            }
+        }
+
+        struct NearestPair {
+            std::uint32_t best = UINT32_MAX;
+            std::uint32_t second = UINT32_MAX;
+            std::uint32_t index = 0;
+        };
+
+        // Two nearest train descriptors for every query, queries split over the pool
+        template<typename V>
+        std::vector<NearestPair> nearestTwo(std::span<const Descriptor> query, std::span<const Descriptor> train,
+            JobSystem& pool) {
+            const std::vector<std::uint64_t> blocks = transposeDescriptors(train);
+            const std::size_t blockCount = blocks.size() / (4 * HAMMING_BLOCK);
+            std::vector<NearestPair> nearest(query.size());
+
+            const std::size_t tasks = (query.size() + FEATURE_POINT_BLOCK - 1) / FEATURE_POINT_BLOCK;
+            pool.parallelFor(tasks, [&](std::size_t task) {
+                const std::size_t end = std::min(query.size(), (task + 1) * FEATURE_POINT_BLOCK);
+                std::uint32_t distances[HAMMING_BLOCK];
+                for (std::size_t q = task * FEATURE_POINT_BLOCK; q < end; ++q) {
+                    NearestPair n;
+                    for (std::size_t b = 0; b < blockCount; ++b) {
+                        hammingBlock<V>(blocks.data() + b * 4 * HAMMING_BLOCK, query[q], distances);
+                        const std::size_t lanes = std::min(HAMMING_BLOCK, train.size() - b * HAMMING_BLOCK);
+                        for (std::size_t i = 0; i < lanes; ++i) {
+                            const std::uint32_t d = distances[i];
+                            if (d < n.best) {
+                                n.second = n.best;
+                                n.best = d;
+                                n.index = static_cast<std::uint32_t>(b * HAMMING_BLOCK + i);
+                            }
+                            else if (d < n.second) {
+                                n.second = d;
+                            }
+                        }
+                    }
+                    nearest[q] = n;
+                }
+            });
+            return nearest;
+        }
+
+    } // namespace detail
+
+    // Luma of an 8-bit image as a single-channel image (copied if already one channel)
+    inline Image toGrayscale(const Image& image) {
+        if (image.getChannels() == 1) {
+            return image;
+        }
+        Image gray(image.getWidth(), image.getHeight(), 1);
+        const int channels = image.getChannels();
+        for (int y = 0; y < image.getHeight(); ++y) {
+            const std::uint8_t* src = image.getRow(y);
+            std::uint8_t* dst = gray.getRow(y);
+            for (int x = 0; x < image.getWidth(); ++x) {
+                const std::uint8_t* p = src + x * channels;
+                dst[x] = channels >= 3
+                    ? static_cast<std::uint8_t>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8)
+                    : p[0];
+            }
+        }
+        return gray;
+    }
+
+    // FAST-9 corners of a single-channel image with non-maximum suppression,
+    // strongest first. Pixels are tested B::Width at a time, rows split over
+    // the pool; corners within FEATURE_MARGIN of the edge are skipped.
+    template<typename B = simd::NativeBytes>
+    std::vector<Keypoint> detectFast(const Image& gray, const FeatureOptions& options = {}) {
+        if (gray.getChannels() != 1) {
+            throw std::invalid_argument("detectFast requires a single-channel image");
+        }
+        const int w = gray.getWidth(), h = gray.getHeight();
+        if (w <= 2 * FEATURE_MARGIN || h <= 2 * FEATURE_MARGIN) {
+            return {};
+        }
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+
+        std::ptrdiff_t offsets[16];
+        for (int k = 0; k < 16; ++k) {
+            offsets[k] = detail::FAST_CIRCLE[k][1] * static_cast<std::ptrdiff_t>(gray.getStride()) + detail::FAST_CIRCLE[k][0];
+        }
+        const std::uint8_t threshold = static_cast<std::uint8_t>(std::clamp(options.threshold, 1, 254));
+
+        // Scores of every corner for the suppression pass, zero elsewhere
+        std::vector<std::uint8_t> scores(static_cast<std::size_t>(w) * h, 0);
+        const int rows = h - 2 * FEATURE_MARGIN;
+        const std::size_t blocks = (rows + detail::FEATURE_ROW_BLOCK - 1) / detail::FEATURE_ROW_BLOCK;
+        std::vector<std::vector<Keypoint>> candidates(blocks);
+
+        pool.parallelFor(blocks, [&](std::size_t block) {
+            const int y0 = FEATURE_MARGIN + static_cast<int>(block) * detail::FEATURE_ROW_BLOCK;
+            const int y1 = std::min(h - FEATURE_MARGIN, y0 + detail::FEATURE_ROW_BLOCK);
+            for (int y = y0; y < y1; ++y) {
+                const std::uint8_t* row = gray.getRow(y);
+                std::uint8_t* scoreRow = scores.data() + static_cast<std::size_t>(y) * w;
+                auto emit = [&](int x) {
+                    const int score = detail::fastScore(row + x, offsets);
+                    scoreRow[x] = static_cast<std::uint8_t>(std::max(score, 1));
+                    candidates[block].push_back({ glm::vec2(static_cast<float>(x), static_cast<float>(y)),
+                        static_cast<float>(score), 0.0f });
+                };
+
+                int x = FEATURE_MARGIN;
+                for (; x + B::Width <= w - FEATURE_MARGIN; x += B::Width) {
+                    for (std::uint64_t bits = detail::fastCornerBits(row + x, offsets, B(threshold)); bits; bits &= bits - 1) {
+                        emit(x + std::countr_zero(bits));
+                    }
+                }
+                for (; x < w - FEATURE_MARGIN; ++x) {
+                    if (detail::fastCornerBits(row + x, offsets, simd::ByteX1(threshold))) {
+                        emit(x);
+                    }
+                }
+            }
+        });
+
+        // 3x3 suppression; ties go to the earlier pixel in raster order
+        std::vector<Keypoint> keypoints;
+        for (const auto& list : candidates) {
+            for (const Keypoint& k : list) {
+                const int x = static_cast<int>(k.position.x), y = static_cast<int>(k.position.y);
+                const std::uint8_t* s = scores.data() + static_cast<std::size_t>(y) * w + x;
+                const std::uint8_t v = *s;
+                const bool peak = v > s[-w - 1] && v > s[-w] && v > s[-w + 1] && v > s[-1] &&
+                    v >= s[1] && v >= s[w - 1] && v >= s[w] && v >= s[w + 1];
+                if (peak) {
+                    keypoints.push_back(k);
+                }
+            }
+        }
+
+        auto stronger = [](const Keypoint& a, const Keypoint& b) { return a.score > b.score; };
+        if (keypoints.size() > options.maxKeypoints) {
+            std::nth_element(keypoints.begin(), keypoints.begin() + options.maxKeypoints, keypoints.end(), stronger);
+            keypoints.resize(options.maxKeypoints);
+        }
+        std::sort(keypoints.begin(), keypoints.end(), stronger);
+        return keypoints;
+    }
+
+    // Orientation (intensity centroid) and steered-BRIEF descriptor for each
+    // keypoint. Keypoints too close to the edge are removed. Box sums come
+    // from a summed-area table; the comparisons use V::Width-wide gathers.
+    template<typename V = simd::NativeFloat>
+    std::vector<Descriptor> computeDescriptors(const Image& gray, std::vector<Keypoint>& keypoints,
+        const FeatureOptions& options = {}) {
+        if (gray.getChannels() != 1) {
+            throw std::invalid_argument("computeDescriptors requires a single-channel image");
+        }
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+        const int w = gray.getWidth(), h = gray.getHeight();
+
+        std::erase_if(keypoints, [&](const Keypoint& k) {
+            return k.position.x < FEATURE_MARGIN || k.position.y < FEATURE_MARGIN ||
+                k.position.x >= w - FEATURE_MARGIN || k.position.y >= h - FEATURE_MARGIN;
+        });
+
+        std::vector<std::uint32_t> integral;
+        detail::computeIntegral(gray, integral, pool);
+        const std::size_t stride = static_cast<std::size_t>(w) + 1;
+        const std::vector<std::int32_t> offsets = detail::steeredOffsets(stride);
+
+        std::vector<Descriptor> descriptors(keypoints.size());
+        const std::size_t tasks = (keypoints.size() + detail::FEATURE_POINT_BLOCK - 1) / detail::FEATURE_POINT_BLOCK;
+        pool.parallelFor(tasks, [&](std::size_t task) {
+            const std::size_t end = std::min(keypoints.size(), (task + 1) * detail::FEATURE_POINT_BLOCK);
+            for (std::size_t i = task * detail::FEATURE_POINT_BLOCK; i < end; ++i) {
+                Keypoint& k = keypoints[i];
+                const int x = static_cast<int>(k.position.x), y = static_cast<int>(k.position.y);
+                k.angle = detail::intensityCentroidAngle(gray, x, y);
+
+                const float binWidth = 2.0f * std::numbers::pi_v<float> / detail::BRIEF_ANGLE_BINS;
+                int bin = static_cast<int>(std::lround(k.angle / binWidth)) % detail::BRIEF_ANGLE_BINS;
+                bin += bin < 0 ? detail::BRIEF_ANGLE_BINS : 0;
+                const std::int32_t* table = offsets.data() + bin * 512;
+                const std::int32_t base = static_cast<std::int32_t>(y * stride + x);
+                descriptors[i] = detail::steeredBrief<V>(integral.data(), stride, base, table, table + 256);
+            }
+        });
+        return descriptors;
+    }
+
+    inline std::uint32_t hammingDistance(const Descriptor& a, const Descriptor& b) {
+        std::uint32_t distance = 0;
+        for (int w = 0; w < 4; ++w) {
+            distance += static_cast<std::uint32_t>(std::popcount(a[w] ^ b[w]));
+        }
+        return distance;
+    }
+
+    // Brute-force Hamming matching with the ratio test and optional cross
+    // check. Train descriptors are transposed so every query is compared
+    // with eight at a time (VPOPCNTDQ or AVX2 when V is wider than one
+    // lane); queries are split over the pool.
+    template<typename V = simd::NativeFloat>
+    std::vector<Match> matchDescriptors(std::span<const Descriptor> query, std::span<const Descriptor> train,
+        const MatchOptions& options = {}) {
+        std::vector<Match> matches;
+        if (query.empty() || train.empty()) {
+            return matches;
+        }
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+
+        const std::vector<detail::NearestPair> forward = detail::nearestTwo<V>(query, train, pool);
+        std::vector<detail::NearestPair> backward;
+        if (options.crossCheck) {
+            backward = detail::nearestTwo<V>(train, query, pool);
+        }
+
+        for (std::uint32_t q = 0; q < forward.size(); ++q) {
+            const detail::NearestPair& n = forward[q];
+            if (n.best > options.maxDistance) continue;
+            if (n.second != UINT32_MAX && static_cast<float>(n.best) >= options.ratio * static_cast<float>(n.second)) continue;
+            if (options.crossCheck && backward[n.index].index != q) continue;
+            matches.push_back({ q, n.index, n.best });
+        }
+        return matches;
+    }
+
+    // Keypoints and descriptors of one image
+    struct FeatureSet {
+        std::vector<Keypoint> keypoints;
+        std::vector<Descriptor> descriptors;
+    };
+
+    template<typename V = simd::NativeFloat, typename B = simd::NativeBytes>
+    FeatureSet extractFeatures(const Image& gray, const FeatureOptions& options = {}) {
+        FeatureSet features;
+        features.keypoints = detectFast<B>(gray, options);
+        features.descriptors = computeDescriptors<V>(gray, features.keypoints, options);
+        return features;
+    }
+
+    struct RegistrationOptions {
+        MatchOptions match;
+        RansacOptions ransac;
+        HomographyRefineOptions refine;
+    };
+
+    struct ImageRegistration {
+        glm::mat3 homography = glm::mat3(1.0f); // reference -> frame
+        std::vector<Match> matches;             // query = reference, train = frame
+        std::size_t inlierCount = 0;
+        bool success = false;
+
+        // Map a quad (e.g. the reference image or decal corners) into the
+        // frame; the result pairs with the original for HomographyCalculator
+        std::array<glm::vec2, 4> mapQuad(const std::array<glm::vec2, 4>& quad) const {
+            std::array<glm::vec2, 4> mapped;
+            for (int i = 0; i < 4; ++i) {
+                mapped[i] = projectPoint(homography, quad[i]);
+            }
+            return mapped;
+        }
+    };
+
+    // Match reference features into a frame, estimate the homography with
+    // RANSAC and polish it on the inliers
+    template<typename V = simd::NativeFloat>
+    ImageRegistration registerFeatures(const FeatureSet& reference, const FeatureSet& frame,
+        const RegistrationOptions& options = {}) {
+        ImageRegistration result;
+        result.matches = matchDescriptors<V>(reference.descriptors, frame.descriptors, options.match);
+        if (result.matches.size() < 4) {
+            return result;
+        }
+
+        std::vector<glm::vec2> src, dst;
+        src.reserve(result.matches.size());
+        dst.reserve(result.matches.size());
+        for (const Match& m : result.matches) {
+            src.push_back(reference.keypoints[m.queryIndex].position);
+            dst.push_back(frame.keypoints[m.trainIndex].position);
+        }
+
+        const RansacResult estimate = estimateHomographyRansac(src, dst, options.ransac);
+        if (!estimate.success) {
+            return result;
+        }
+
+        std::vector<glm::vec2> inlierSrc, inlierDst;
+        for (std::size_t i = 0; i < src.size(); ++i) {
+            if (estimate.inliers[i]) {
+                inlierSrc.push_back(src[i]);
+                inlierDst.push_back(dst[i]);
+            }
+        }
+        result.homography = refineHomography<V>(inlierSrc, inlierDst, estimate.homography, options.refine).homography;
+        result.inlierCount = estimate.inlierCount;
+        result.success = true;
+        return result;
+    }
+
+} // namespace gl
+
+#endif // GL_FEATURES_HPP
@@ -11,5 +11,18 @@
 #include "framebuffer.hpp"
 #include "gl_check.hpp"
 #include "homography.hpp"
+#include "compute_homography.hpp"
+#include "ransac.hpp"
+#include "refine.hpp"
+#include "decomposition.hpp"
+#include "projection.hpp"
+
+// CPU-side image processing
+#include "image.hpp"
+#include "job_system.hpp"
+#include "warp.hpp"
+#include "remap.hpp"
+#include "tracking.hpp"
+#include "features.hpp"
 
 #endif // GL_HPP
\ No newline at end of file
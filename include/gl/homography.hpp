@@ -1,13 +1,19 @@
 #ifndef HOMOGRAPHY_HPP
 #define HOMOGRAPHY_HPP
 
+#include "simd.hpp"
 #include <array>
 #include <glm/glm.hpp>
-#include <glm/gtc/epsilon.hpp>
 #include <stdexcept>
 #include <cmath>
 #include <optional>
 #include <limits>
+#include <algorithm>
+#include <span>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <type_traits>
 
 #ifdef __AVX__
 #include <immintrin.h> // For AVX intrinsics
@@ -15,15 +21,27 @@
 
 namespace gl {
 
-    // Optimized LU decomposition solver for 8x8 systems
+    namespace detail {
+
+        // std::abs is not constexpr until C++23
+        constexpr float constexprAbs(float v) {
+            return v < 0.0f ? -v : v;
+        }
+
+    } // namespace detail
+
+    // Optimized LU decomposition solver for 8x8 systems. Usable in constant
+    // expressions; the AVX substitution is only taken at run time.
     class LinearSolver8x8 {
     private:
-        float A[8][8];  // Matrix
-        float b[8];     // Right-hand side
-        int pivots[8];  // Pivot indices
+        float A[8][8] = {};  // Matrix
+        float b[8] = {};     // Right-hand side
+        int pivots[8] = {};  // Pivot indices
+        float pivotMin = 0.0f; // Smallest and largest |u_ii| seen by decompose()
+        float pivotMax = 0.0f;
 
     public:
-        LinearSolver8x8() {
+        constexpr LinearSolver8x8() {
             // Initialize pivot array
             for (int i = 0; i < 8; ++i) {
                 pivots[i] = i;
@@ -31,7 +49,7 @@ namespace gl {
         }
 
         // Set matrix and right-hand side values
-        void setSystem(const float matrix[8][8], const float rhs[8]) {
+        constexpr void setSystem(const float matrix[8][8], const float rhs[8]) {
             // Copy matrix and rhs
             for (int i = 0; i < 8; ++i) {
                 for (int j = 0; j < 8; ++j) {
@@ -47,16 +65,18 @@ namespace gl {
         }
 
         // Perform LU decomposition with partial pivoting
-        bool decompose() {
+        constexpr bool decompose() {
             constexpr float EPSILON = 1e-10f;
+            pivotMin = std::numeric_limits<float>::max();
+            pivotMax = 0.0f;
 
             for (int i = 0; i < 8; ++i) {
                 // Find pivot
                 int pivot_row = i;
-                float max_val = std::abs(A[pivots[i]][i]);
+                float max_val = detail::constexprAbs(A[pivots[i]][i]);
 
                 for (int j = i + 1; j < 8; ++j) {
-                    float val = std::abs(A[pivots[j]][i]);
+                    float val = detail::constexprAbs(A[pivots[j]][i]);
                     if (val > max_val) {
                         max_val = val;
                         pivot_row = j;
@@ -67,6 +87,8 @@ namespace gl {
                 if (max_val < EPSILON) {
                     return false;
                 }
+                pivotMin = std::min(pivotMin, max_val);
+                pivotMax = std::max(pivotMax, max_val);
 
                 // Swap pivot rows if necessary
                 if (pivot_row != i) {
@@ -94,9 +116,48 @@ namespace gl {
             return true;
         }
 
+        // Ratio of the largest to the smallest pivot after decompose(): a
+        // cheap lower bound on the condition number. Values approaching
+        // 1 / FLT_EPSILON mean the float solution has no correct digits.
+        constexpr float conditionEstimate() const {
+            return pivotMin > 0.0f ? pivotMax / pivotMin : std::numeric_limits<float>::infinity();
+        }
+
         // Solve the system after decomposition
-        void solve(float x[8]) {
+        constexpr void solve(float x[8]) {
 #ifdef __AVX__
+            if (!std::is_constant_evaluated()) {
+                solveAvx(x);
+                return;
+            }
+#endif
+            // Forward substitution (Ly = b)
+            float y[8];
+            for (int i = 0; i < 8; ++i) {
+                int pivot_idx = pivots[i];
+                y[i] = b[pivot_idx];
+
+                for (int j = 0; j < i; ++j) {
+                    y[i] -= A[pivot_idx][j] * y[j];
+                }
+            }
+
+            // Backward substitution (Ux = y)
+            for (int i = 7; i >= 0; --i) {
+                int pivot_idx = pivots[i];
+                x[i] = y[i];
+
+                for (int j = i + 1; j < 8; ++j) {
+                    x[i] -= A[pivot_idx][j] * x[j];
+                }
+
+                x[i] /= A[pivot_idx][i];
+            }
+        }
+
+    private:
+#ifdef __AVX__
+        void solveAvx(float x[8]) {
             // Forward substitution (Ly = b) with SIMD
             float y[8] = { 0 };
 
@@ -132,7 +193,12 @@ namespace gl {
                 }
             }
 
-            // Backward substitution (Ux = y) with SIMD
+            // Backward substitution (Ux = y) with SIMD. The full x vector is
+            // loaded each step, so clear it first: masked-out lanes are
+            // multiplied by zero, which still yields NaN for garbage input.
+            for (int i = 0; i < 8; ++i) {
+                x[i] = 0.0f;
+            }
             for (int i = 7; i >= 0; --i) {
                 int pivot_idx = pivots[i];
                 x[i] = y[i];
@@ -166,100 +232,772 @@ namespace gl {
 
                 x[i] /= A[pivot_idx][i];
             }
-#else
-            // Standard non-SIMD implementation
-            // Forward substitution (Ly = b)
-            float y[8];
+        }
+#endif
+    };
+
+    // Result of a homography solve together with its inverse
+    struct HomographyPair {
+        glm::mat3 forward;
+        glm::mat3 inverse;
+    };
+
+    // Scale a homography so that H[2][2] == 1 (left unchanged when H[2][2] ~ 0)
+    constexpr glm::mat3 normalizeHomography(const glm::mat3& H) {
+        if (detail::constexprAbs(H[2][2]) > 1e-10f) {
+            return H * (1.0f / H[2][2]);
+        }
+        return H;
+    }
+
+    // Adjugate of a 3x3 matrix. For homographies this is the inverse up to
+    // scale, which is all a projective map needs. Row i of the result is the
+    // cross product of columns i+1 and i+2, written out because glm::cross
+    // and glm::transpose are not constexpr.
+    constexpr glm::mat3 adjugate(const glm::mat3& m) {
+        glm::mat3 adj(0.0f);
+        for (int i = 0; i < 3; ++i) {
+            const glm::vec3& a = m[(i + 1) % 3];
+            const glm::vec3& b = m[(i + 2) % 3];
+            adj[0][i] = a.y * b.z - a.z * b.y;
+            adj[1][i] = a.z * b.x - a.x * b.z;
+            adj[2][i] = a.x * b.y - a.y * b.x;
+        }
+        return adj;
+    }
+
+    // Inverse of a homography, normalized so H[2][2] == 1
+    constexpr glm::mat3 inverseHomography(const glm::mat3& H) {
+        return normalizeHomography(adjugate(H));
+    }
+
+    // Matrix product usable in constant expressions (glm's operator* is not)
+    constexpr glm::mat3 multiplyHomography(const glm::mat3& a, const glm::mat3& b) {
+        glm::mat3 r(0.0f);
+        for (int c = 0; c < 3; ++c) {
+            r[c] = a[0] * b[c].x + a[1] * b[c].y + a[2] * b[c].z;
+        }
+        return r;
+    }
+
+    // True when p0 + p2 == p1 + p3 within a tolerance relative to the quad size
+    inline bool isParallelogram(const std::array<glm::vec2, 4>& q, float epsilon = 1e-5f) {
+        glm::vec2 skew = q[0] + q[2] - q[1] - q[3];
+        float extent = std::max(glm::length(q[2] - q[0]), glm::length(q[3] - q[1]));
+        return std::abs(skew.x) <= epsilon * extent && std::abs(skew.y) <= epsilon * extent;
+    }
+
+    // Closed-form map from the unit square to a quad (Heckbert, "Fundamentals
+    // of Texture Mapping and Image Warping", 1989). Corners map in the order
+    // (0,0), (1,0), (1,1), (0,1). Returns nullopt for a degenerate quad.
+    constexpr std::optional<glm::mat3> squareToQuad(const std::array<glm::vec2, 4>& q) {
+        float sx = q[0].x - q[1].x + q[2].x - q[3].x;
+        float sy = q[0].y - q[1].y + q[2].y - q[3].y;
+
+        float a, b, d, e, g, h;
+        if (sx == 0.0f && sy == 0.0f) {
+            // Affine case (parallelogram)
+            a = q[1].x - q[0].x; b = q[2].x - q[1].x;
+            d = q[1].y - q[0].y; e = q[2].y - q[1].y;
+            g = 0.0f; h = 0.0f;
+            if (detail::constexprAbs(a * e - b * d) < 1e-12f) {
+                return std::nullopt;
+            }
+        }
+        else {
+            float dx1 = q[1].x - q[2].x, dx2 = q[3].x - q[2].x;
+            float dy1 = q[1].y - q[2].y, dy2 = q[3].y - q[2].y;
+            float den = dx1 * dy2 - dx2 * dy1;
+            if (detail::constexprAbs(den) < 1e-12f) {
+                return std::nullopt;
+            }
+            g = (sx * dy2 - dx2 * sy) / den;
+            h = (dx1 * sy - sx * dy1) / den;
+            a = q[1].x - q[0].x + g * q[1].x;
+            b = q[3].x - q[0].x + h * q[3].x;
+            d = q[1].y - q[0].y + g * q[1].y;
+            e = q[3].y - q[0].y + h * q[3].y;
+        }
+
+        // Column-major for GLM
+        glm::mat3 H(1.0f);
+        H[0][0] = a;    H[1][0] = b;    H[2][0] = q[0].x;
+        H[0][1] = d;    H[1][1] = e;    H[2][1] = q[0].y;
+        H[0][2] = g;    H[1][2] = h;    H[2][2] = 1.0f;
+        return H;
+    }
+
+    // Closed-form map from a quad back to the unit square
+    constexpr std::optional<glm::mat3> quadToSquare(const std::array<glm::vec2, 4>& q) {
+        auto S = squareToQuad(q);
+        if (!S) {
+            return std::nullopt;
+        }
+        return inverseHomography(*S);
+    }
+
+    // Homography mapping src[i] to dst[i] from the 8x8 system with h22 = 1,
+    // solved by LU with partial pivoting. Returns nullopt for a singular
+    // system. Usable in constant expressions, so homographies between quads
+    // known at build time fold to constants.
+    constexpr std::optional<glm::mat3> solveHomography(const std::array<glm::vec2, 4>& src,
+        const std::array<glm::vec2, 4>& dst) {
+        float A[8][8] = {};
+        float b[8] = {};
+
+        // Fill the matrix A and vector b with constraints from the point pairs
+        for (int i = 0; i < 4; ++i) {
+            float x = src[i].x;
+            float y = src[i].y;
+            float x_prime = dst[i].x;
+            float y_prime = dst[i].y;
+
+            // Row for x equation: x*h0 + y*h1 + h2 - x*x'*h6 - y*x'*h7 = x'
+            A[i * 2][0] = x;
+            A[i * 2][1] = y;
+            A[i * 2][2] = 1.0f;
+            A[i * 2][6] = -x * x_prime;
+            A[i * 2][7] = -y * x_prime;
+            b[i * 2] = x_prime;
+
+            // Row for y equation: x*h3 + y*h4 + h5 - x*y'*h6 - y*y'*h7 = y'
+            A[i * 2 + 1][3] = x;
+            A[i * 2 + 1][4] = y;
+            A[i * 2 + 1][5] = 1.0f;
+            A[i * 2 + 1][6] = -x * y_prime;
+            A[i * 2 + 1][7] = -y * y_prime;
+            b[i * 2 + 1] = y_prime;
+        }
+
+        LinearSolver8x8 solver;
+        solver.setSystem(A, b);
+        if (!solver.decompose()) {
+            return std::nullopt;
+        }
+        float h[8] = {};
+        solver.solve(h);
+
+        // Construct homography matrix (in column-major order for GLM)
+        glm::mat3 H(1.0f);
+        H[0][0] = h[0]; H[1][0] = h[1]; H[2][0] = h[2]; // First column
+        H[0][1] = h[3]; H[1][1] = h[4]; H[2][1] = h[5]; // Second column
+        H[0][2] = h[6]; H[1][2] = h[7]; H[2][2] = 1.0f; // Third column
+        return H;
+    }
+
+    namespace detail {
+
+        // Similarity that moves the centroid to the origin and scales the mean
+        // distance to sqrt(2) (Hartley normalization). An empty index list
+        // uses every point.
+        inline glm::mat3 normalizationTransform(std::span<const glm::vec2> points,
+            std::span<const std::uint32_t> indices = {}) {
+            const std::size_t count = indices.empty() ? points.size() : indices.size();
+            auto at = [&](std::size_t i) { return glm::dvec2(points[indices.empty() ? i : indices[i]]); };
+
+            glm::dvec2 centroid(0.0);
+            for (std::size_t i = 0; i < count; ++i) {
+                centroid += at(i);
+            }
+            centroid /= static_cast<double>(count);
+
+            double meanDistance = 0.0;
+            for (std::size_t i = 0; i < count; ++i) {
+                meanDistance += glm::length(at(i) - centroid);
+            }
+            meanDistance /= static_cast<double>(count);
+
+            float s = meanDistance > 1e-12 ? static_cast<float>(std::sqrt(2.0) / meanDistance) : 1.0f;
+            glm::mat3 T(1.0f);
+            T[0][0] = s;
+            T[1][1] = s;
+            T[2][0] = static_cast<float>(-s * centroid.x);
+            T[2][1] = static_cast<float>(-s * centroid.y);
+            return T;
+        }
+
+        // Solves V::Width homography systems at once, one system per SIMD lane.
+        // Corners are passed structure-of-arrays (sx[i] holds corner i of every
+        // lane). Row swaps from partial pivoting are applied per lane with
+        // selects. Returns the mask of lanes whose system was singular.
+        template<typename V>
+        typename V::Mask solveHomographyLanes(const V sx[4], const V sy[4],
+            const V dx[4], const V dy[4], V h[8]) {
+            constexpr float EPSILON = 1e-10f;
+            const V zero(0.0f);
+            const V one(1.0f);
+
+            V A[8][8];
+            V b[8];
+            for (int i = 0; i < 4; ++i) {
+                // Row for x equation: x*h0 + y*h1 + h2 - x*x'*h6 - y*x'*h7 = x'
+                A[i * 2][0] = sx[i];
+                A[i * 2][1] = sy[i];
+                A[i * 2][2] = one;
+                A[i * 2][3] = zero;
+                A[i * 2][4] = zero;
+                A[i * 2][5] = zero;
+                A[i * 2][6] = -(sx[i] * dx[i]);
+                A[i * 2][7] = -(sy[i] * dx[i]);
+                b[i * 2] = dx[i];
+
+                // Row for y equation: x*h3 + y*h4 + h5 - x*y'*h6 - y*y'*h7 = y'
+                A[i * 2 + 1][0] = zero;
+                A[i * 2 + 1][1] = zero;
+                A[i * 2 + 1][2] = zero;
+                A[i * 2 + 1][3] = sx[i];
+                A[i * 2 + 1][4] = sy[i];
+                A[i * 2 + 1][5] = one;
+                A[i * 2 + 1][6] = -(sx[i] * dy[i]);
+                A[i * 2 + 1][7] = -(sy[i] * dy[i]);
+                b[i * 2 + 1] = dy[i];
+            }
+
+            typename V::Mask singular = zero < zero;
+            V invDiag[8];
+
             for (int i = 0; i < 8; ++i) {
-                int pivot_idx = pivots[i];
-                y[i] = b[pivot_idx];
+                // Find pivot row per lane
+                V maxVal = simd::abs(A[i][i]);
+                V pivotRow(static_cast<float>(i));
+                for (int j = i + 1; j < 8; ++j) {
+                    V val = simd::abs(A[j][i]);
+                    auto greater = val > maxVal;
+                    maxVal = simd::select(greater, val, maxVal);
+                    pivotRow = simd::select(greater, V(static_cast<float>(j)), pivotRow);
+                }
 
-                for (int j = 0; j < i; ++j) {
-                    y[i] -= A[pivot_idx][j] * y[j];
+                auto tiny = maxVal < V(EPSILON);
+                singular = simd::maskOr(singular, tiny);
+
+                // Swap rows in the lanes that picked row j as pivot
+                for (int j = i + 1; j < 8; ++j) {
+                    auto swap = pivotRow == V(static_cast<float>(j));
+                    if (!simd::any(swap)) continue;
+                    for (int k = i; k < 8; ++k) {
+                        V upper = A[i][k];
+                        A[i][k] = simd::select(swap, A[j][k], upper);
+                        A[j][k] = simd::select(swap, upper, A[j][k]);
+                    }
+                    V upper = b[i];
+                    b[i] = simd::select(swap, b[j], upper);
+                    b[j] = simd::select(swap, upper, b[j]);
+                }
+
+                // Keep singular lanes finite so they cannot poison their neighbours
+                invDiag[i] = one / simd::select(tiny, one, A[i][i]);
+
+                // Eliminate below the pivot
+                for (int j = i + 1; j < 8; ++j) {
+                    V m = A[j][i] * invDiag[i];
+                    for (int k = i + 1; k < 8; ++k) {
+                        A[j][k] = A[j][k] - m * A[i][k];
+                    }
+                    b[j] = b[j] - m * b[i];
                 }
             }
 
-            // Backward substitution (Ux = y)
+            // Backward substitution (Ux = b)
             for (int i = 7; i >= 0; --i) {
-                int pivot_idx = pivots[i];
-                x[i] = y[i];
+                V x = b[i];
+                for (int j = i + 1; j < 8; ++j) {
+                    x = x - A[i][j] * h[j];
+                }
+                h[i] = x * invDiag[i];
+            }
+
+            return singular;
+        }
+
+    } // namespace detail
+
+    // Batched homography computation. Systems are transposed into
+    // structure-of-arrays form and solved V::Width at a time (16 with AVX-512,
+    // 8 with AVX2, 4 with SSE2, 1 for the scalar fallback). Singular systems
+    // produce a zero matrix; the number of such systems is returned.
+    template<typename V = simd::NativeFloat>
+    std::size_t computeHomographyBatch(std::span<const std::array<glm::vec2, 4>> src,
+        std::span<const std::array<glm::vec2, 4>> dst,
+        std::span<glm::mat3> out) {
+        if (src.size() != dst.size() || src.size() != out.size()) {
+            throw std::invalid_argument("Homography batch spans must have the same length");
+        }
+
+        constexpr int W = V::Width;
+        alignas(64) float sx[4][W], sy[4][W], dx[4][W], dy[4][W];
+        alignas(64) float hs[8][W];
+        std::size_t singularCount = 0;
+
+        for (std::size_t base = 0; base < src.size(); base += W) {
+            const std::size_t lanes = std::min<std::size_t>(W, src.size() - base);
+
+            // Transpose into SoA; pad the tail with the identity system
+            for (int lane = 0; lane < W; ++lane) {
+                const bool valid = static_cast<std::size_t>(lane) < lanes;
+                for (int i = 0; i < 4; ++i) {
+                    glm::vec2 s = valid ? src[base + lane][i] :
+                        glm::vec2(static_cast<float>((i == 1) || (i == 2)), static_cast<float>(i >= 2));
+                    glm::vec2 d = valid ? dst[base + lane][i] : s;
+                    sx[i][lane] = s.x;
+                    sy[i][lane] = s.y;
+                    dx[i][lane] = d.x;
+                    dy[i][lane] = d.y;
+                }
+            }
+
+            V vsx[4], vsy[4], vdx[4], vdy[4];
+            for (int i = 0; i < 4; ++i) {
+                vsx[i] = V::load(sx[i]);
+                vsy[i] = V::load(sy[i]);
+                vdx[i] = V::load(dx[i]);
+                vdy[i] = V::load(dy[i]);
+            }
+
+            V h[8];
+            unsigned singular = simd::maskBits(detail::solveHomographyLanes(vsx, vsy, vdx, vdy, h));
+            for (int k = 0; k < 8; ++k) {
+                h[k].store(hs[k]);
+            }
+
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                if (singular & (1u << lane)) {
+                    out[base + lane] = glm::mat3(0.0f);
+                    ++singularCount;
+                    continue;
+                }
+
+                // Column-major for GLM, same layout as HomographyCalculator::compute
+                glm::mat3& H = out[base + lane];
+                H[0][0] = hs[0][lane]; H[1][0] = hs[1][lane]; H[2][0] = hs[2][lane];
+                H[0][1] = hs[3][lane]; H[1][1] = hs[4][lane]; H[2][1] = hs[5][lane];
+                H[0][2] = hs[6][lane]; H[1][2] = hs[7][lane]; H[2][2] = 1.0f;
+            }
+        }
+
+        return singularCount;
+    }
+
+    // Condition estimates above this mark a system as singular in
+    // computeHomographyBatchRefined: refinement from a float factorization
+    // only converges while condition * FLT_EPSILON stays well below one
+    constexpr float HOMOGRAPHY_CONDITION_LIMIT = 1e6f;
+
+    namespace detail {
 
+        // In-place LU of V::Width 8x8 systems with per-lane partial pivoting.
+        // U stays on and above the diagonal, the multipliers below it; pivot[i]
+        // is the row swapped into position i. Also returns the smallest and
+        // largest pivot magnitude of every lane.
+        template<typename V>
+        void factorHomographyLanes(V A[8][8], V pivot[8], V invDiag[8], V& minPivot, V& maxPivot) {
+            const V one(1.0f);
+            minPivot = V(std::numeric_limits<float>::max());
+            maxPivot = V(0.0f);
+
+            for (int i = 0; i < 8; ++i) {
+                V maxVal = simd::abs(A[i][i]);
+                pivot[i] = V(static_cast<float>(i));
                 for (int j = i + 1; j < 8; ++j) {
-                    x[i] -= A[pivot_idx][j] * x[j];
+                    V val = simd::abs(A[j][i]);
+                    auto greater = val > maxVal;
+                    maxVal = simd::select(greater, val, maxVal);
+                    pivot[i] = simd::select(greater, V(static_cast<float>(j)), pivot[i]);
                 }
+                minPivot = simd::min(minPivot, maxVal);
+                maxPivot = simd::max(maxPivot, maxVal);
 
-                x[i] /= A[pivot_idx][i];
+                for (int j = i + 1; j < 8; ++j) {
+                    auto swap = pivot[i] == V(static_cast<float>(j));
+                    if (!simd::any(swap)) continue;
+                    for (int k = 0; k < 8; ++k) {
+                        V upper = A[i][k];
+                        A[i][k] = simd::select(swap, A[j][k], upper);
+                        A[j][k] = simd::select(swap, upper, A[j][k]);
+                    }
+                }
+
+                // Zero pivots stay finite here; the caller rejects those lanes
+                invDiag[i] = one / simd::select(maxVal == V(0.0f), one, A[i][i]);
+                for (int j = i + 1; j < 8; ++j) {
+                    V m = A[j][i] * invDiag[i];
+                    A[j][i] = m;
+                    for (int k = i + 1; k < 8; ++k) {
+                        A[j][k] = A[j][k] - m * A[i][k];
+                    }
+                }
             }
-#endif
         }
-    };
 
-    // Optimized homography computation
-    class HomographyCalculator {
-    private:
-        LinearSolver8x8 solver;
+        // Solve with the factors of factorHomographyLanes; b is overwritten by x
+        template<typename V>
+        void solveFactoredLanes(const V LU[8][8], const V pivot[8], const V invDiag[8], V b[8]) {
+            // Whole rows were swapped during factoring, so the multipliers
+            // are in final row order: permute b completely first
+            for (int i = 0; i < 8; ++i) {
+                for (int j = i + 1; j < 8; ++j) {
+                    auto swap = pivot[i] == V(static_cast<float>(j));
+                    V upper = b[i];
+                    b[i] = simd::select(swap, b[j], upper);
+                    b[j] = simd::select(swap, upper, b[j]);
+                }
+            }
+            for (int i = 0; i < 8; ++i) {
+                for (int j = i + 1; j < 8; ++j) {
+                    b[j] = b[j] - LU[j][i] * b[i];
+                }
+            }
+            for (int i = 7; i >= 0; --i) {
+                V x = b[i];
+                for (int j = i + 1; j < 8; ++j) {
+                    x = x - LU[i][j] * b[j];
+                }
+                b[i] = x * invDiag[i];
+            }
+        }
 
-        // Multi-level LRU cache for homographies
-        struct HomographyCache {
-            std::array<glm::vec2, 4> src;
-            std::array<glm::vec2, 4> dst;
-            glm::mat3 matrix;
-            size_t lastUsed;
+    } // namespace detail
+
+    // Homographies for large or badly scaled coordinates. Each quad pair is
+    // Hartley-normalized in double, the 8x8 system is factored once in float
+    // lanes, and each refinement step solves for the correction to a double
+    // solution from a residual computed in double. One step usually reaches
+    // double accuracy for well-conditioned systems; the cost over the plain
+    // float batch is a second triangular solve per step.
+    //
+    // conditionEstimates (optional, same length as out) receives the pivot
+    // ratio of each normalized system. Systems over
+    // HOMOGRAPHY_CONDITION_LIMIT produce a zero matrix and are counted in
+    // the return value, like the singular systems of computeHomographyBatch.
+    template<typename V = simd::NativeFloat>
+    std::size_t computeHomographyBatchRefined(std::span<const std::array<glm::vec2, 4>> src,
+        std::span<const std::array<glm::vec2, 4>> dst, std::span<glm::mat3> out,
+        std::span<float> conditionEstimates = {}, int refinementSteps = 1) {
+        if (src.size() != dst.size() || src.size() != out.size()) {
+            throw std::invalid_argument("Homography batch spans must have the same length");
+        }
+        if (!conditionEstimates.empty() && conditionEstimates.size() != out.size()) {
+            throw std::invalid_argument("Condition estimate span must match the batch length");
+        }
+
+        constexpr int W = V::Width;
+        // Normalized corners and transforms per lane, in double
+        alignas(64) double nsx[4][W], nsy[4][W], ndx[4][W], ndy[4][W];
+        alignas(64) double srcScale[W], srcX[W], srcY[W], dstScale[W], dstX[W], dstY[W];
+        alignas(64) double x[8][W], r[8][W];
+        alignas(64) float lanes[8][W], condition[W];
+        std::size_t singularCount = 0;
+
+        auto normalize = [](const std::array<glm::vec2, 4>& q, double nx[4][W], double ny[4][W], int lane,
+            double& scale, double& cx, double& cy) {
+            cx = 0.25 * (double(q[0].x) + q[1].x + q[2].x + q[3].x);
+            cy = 0.25 * (double(q[0].y) + q[1].y + q[2].y + q[3].y);
+            double mean = 0.0;
+            for (int i = 0; i < 4; ++i) {
+                const double ex = q[i].x - cx, ey = q[i].y - cy;
+                mean += std::sqrt(ex * ex + ey * ey);
+            }
+            scale = mean > 1e-300 ? 4.0 * std::sqrt(2.0) / mean : 1.0;
+            for (int i = 0; i < 4; ++i) {
+                nx[i][lane] = (q[i].x - cx) * scale;
+                ny[i][lane] = (q[i].y - cy) * scale;
+            }
+        };
+
+        // Residual r = b - A x of the normalized system, in double
+        auto residual = [&] {
+            for (int i = 0; i < 4; ++i) {
+                for (int lane = 0; lane < W; ++lane) {
+                    const double sx = nsx[i][lane], sy = nsy[i][lane];
+                    const double px = sx * x[6][lane] + sy * x[7][lane];
+                    r[2 * i][lane] = ndx[i][lane] * (1.0 + px) - (sx * x[0][lane] + sy * x[1][lane] + x[2][lane]);
+                    r[2 * i + 1][lane] = ndy[i][lane] * (1.0 + px) - (sx * x[3][lane] + sy * x[4][lane] + x[5][lane]);
+                }
+            }
         };
 
-        static constexpr size_t CACHE_SIZE = 4;
-        std::array<std::optional<HomographyCache>, CACHE_SIZE> caches;
-        size_t cacheCounter = 0;
+        for (std::size_t base = 0; base < src.size(); base += W) {
+            const std::size_t count = std::min<std::size_t>(W, src.size() - base);
+
+            // Pad the tail with the unit square mapped to itself
+            static constexpr std::array<glm::vec2, 4> SQUARE = {
+                glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f)
+            };
+            for (int lane = 0; lane < W; ++lane) {
+                const bool valid = static_cast<std::size_t>(lane) < count;
+                normalize(valid ? src[base + lane] : SQUARE, nsx, nsy, lane, srcScale[lane], srcX[lane], srcY[lane]);
+                normalize(valid ? dst[base + lane] : SQUARE, ndx, ndy, lane, dstScale[lane], dstX[lane], dstY[lane]);
+            }
 
-        bool arePointsSame(const std::array<glm::vec2, 4>& p1,
-            const std::array<glm::vec2, 4>& p2,
-            float epsilon = 1e-5f) {
+            // Float copy of the normalized system
+            V A[8][8], b[8];
+            const V zero(0.0f), one(1.0f);
             for (int i = 0; i < 4; ++i) {
-                if (!glm::all(glm::epsilonEqual(p1[i], p2[i], epsilon))) {
-                    return false;
+                alignas(64) float c[4][W];
+                for (int lane = 0; lane < W; ++lane) {
+                    c[0][lane] = static_cast<float>(nsx[i][lane]);
+                    c[1][lane] = static_cast<float>(nsy[i][lane]);
+                    c[2][lane] = static_cast<float>(ndx[i][lane]);
+                    c[3][lane] = static_cast<float>(ndy[i][lane]);
                 }
+                const V sx = V::load(c[0]), sy = V::load(c[1]), dx = V::load(c[2]), dy = V::load(c[3]);
+                A[2 * i][0] = sx;   A[2 * i][1] = sy;   A[2 * i][2] = one;
+                A[2 * i][3] = zero; A[2 * i][4] = zero; A[2 * i][5] = zero;
+                A[2 * i][6] = -(sx * dx); A[2 * i][7] = -(sy * dx);
+                b[2 * i] = dx;
+                A[2 * i + 1][0] = zero; A[2 * i + 1][1] = zero; A[2 * i + 1][2] = zero;
+                A[2 * i + 1][3] = sx;   A[2 * i + 1][4] = sy;   A[2 * i + 1][5] = one;
+                A[2 * i + 1][6] = -(sx * dy); A[2 * i + 1][7] = -(sy * dy);
+                b[2 * i + 1] = dy;
             }
-            return true;
-        }
 
-        // Find in cache or return nullopt
-        std::optional<glm::mat3> findInCache(const std::array<glm::vec2, 4>& src,
-            const std::array<glm::vec2, 4>& dst) {
-            for (auto& cache : caches) {
-                if (cache && arePointsSame(src, cache->src) &&
-                    arePointsSame(dst, cache->dst)) {
-                    cache->lastUsed = ++cacheCounter;
-                    return cache->matrix;
+            V pivot[8], invDiag[8], minPivot, maxPivot;
+            detail::factorHomographyLanes(A, pivot, invDiag, minPivot, maxPivot);
+            const V cond = maxPivot / simd::max(minPivot, V(std::numeric_limits<float>::min()));
+            cond.store(condition);
+
+            detail::solveFactoredLanes(A, pivot, invDiag, b);
+            for (int k = 0; k < 8; ++k) {
+                b[k].store(lanes[k]);
+                for (int lane = 0; lane < W; ++lane) {
+                    x[k][lane] = lanes[k][lane];
+                }
+            }
+
+            for (int step = 0; step < refinementSteps; ++step) {
+                residual();
+                V d[8];
+                for (int k = 0; k < 8; ++k) {
+                    for (int lane = 0; lane < W; ++lane) {
+                        lanes[k][lane] = static_cast<float>(r[k][lane]);
+                    }
+                    d[k] = V::load(lanes[k]);
+                }
+                detail::solveFactoredLanes(A, pivot, invDiag, d);
+                for (int k = 0; k < 8; ++k) {
+                    d[k].store(lanes[k]);
+                    for (int lane = 0; lane < W; ++lane) {
+                        x[k][lane] += lanes[k][lane];
+                    }
                 }
             }
+
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                if (!conditionEstimates.empty()) {
+                    conditionEstimates[base + lane] = condition[lane];
+                }
+                if (!(condition[lane] <= HOMOGRAPHY_CONDITION_LIMIT)) {
+                    out[base + lane] = glm::mat3(0.0f);
+                    ++singularCount;
+                    continue;
+                }
+
+                // H = Td^-1 * Hn * Ts, rows of Hn * Ts first
+                const double s = srcScale[lane], sx = srcX[lane], sy = srcY[lane];
+                const double rows[3][3] = {
+                    { x[0][lane] * s, x[1][lane] * s, x[2][lane] - s * (x[0][lane] * sx + x[1][lane] * sy) },
+                    { x[3][lane] * s, x[4][lane] * s, x[5][lane] - s * (x[3][lane] * sx + x[4][lane] * sy) },
+                    { x[6][lane] * s, x[7][lane] * s, 1.0 - s * (x[6][lane] * sx + x[7][lane] * sy) }
+                };
+                const double inv = 1.0 / dstScale[lane];
+                const double norm = 1.0 / rows[2][2];
+                glm::mat3& H = out[base + lane];
+                for (int c = 0; c < 3; ++c) {
+                    H[c][0] = static_cast<float>((rows[0][c] * inv + dstX[lane] * rows[2][c]) * norm);
+                    H[c][1] = static_cast<float>((rows[1][c] * inv + dstY[lane] * rows[2][c]) * norm);
+                    H[c][2] = static_cast<float>(rows[2][c] * norm);
+                }
+            }
+        }
+
+        return singularCount;
+    }
+
+    // Single-system form of computeHomographyBatchRefined. Returns nullopt
+    // for singular or hopelessly ill-conditioned systems.
+    inline std::optional<glm::mat3> solveHomographyRefined(const std::array<glm::vec2, 4>& src,
+        const std::array<glm::vec2, 4>& dst, float* conditionEstimate = nullptr, int refinementSteps = 1) {
+        glm::mat3 H;
+        float condition;
+        const std::size_t singular = computeHomographyBatchRefined<simd::FloatX1>(
+            std::span(&src, 1), std::span(&dst, 1), std::span(&H, 1), std::span(&condition, 1), refinementSteps);
+        if (conditionEstimate) {
+            *conditionEstimate = condition;
+        }
+        if (singular) {
             return std::nullopt;
         }
+        return H;
+    }
 
-        // Add to cache, replacing least recently used entry
-        void addToCache(const std::array<glm::vec2, 4>& src,
+    // Hit/miss/eviction counters for a HomographyCache
+    struct HomographyCacheStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+
+        double hitRate() const {
+            std::uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        }
+    };
+
+    // LRU cache of homographies keyed by quantized point pairs. Coordinates are
+    // snapped to a grid of `quantum` so near-identical quads share a key; the
+    // key is hashed for O(1) lookup and entries form an intrusive doubly-linked
+    // list (by index) for O(1) recency updates and eviction. Storage is
+    // allocated once per capacity change.
+    class HomographyCache {
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = 64;
+        static constexpr float DEFAULT_QUANTUM = 1e-5f;
+
+        explicit HomographyCache(std::size_t capacity = DEFAULT_CAPACITY, float quantum = DEFAULT_QUANTUM)
+            : invQuantum_(1.0f / quantum) {
+            setCapacity(capacity);
+        }
+
+        // Resize the cache; this drops every entry but keeps the counters
+        void setCapacity(std::size_t capacity) {
+            entries_.clear();
+            entries_.resize(capacity);
+            index_.clear();
+            index_.reserve(capacity);
+            head_ = tail_ = NONE;
+            size_ = 0;
+        }
+
+        std::optional<glm::mat3> find(const std::array<glm::vec2, 4>& src,
+            const std::array<glm::vec2, 4>& dst) {
+            auto it = index_.find(makeKey(src, dst));
+            if (it == index_.end()) {
+                ++misses_;
+                return std::nullopt;
+            }
+            ++hits_;
+            moveToFront(it->second);
+            return entries_[it->second].matrix;
+        }
+
+        void insert(const std::array<glm::vec2, 4>& src,
             const std::array<glm::vec2, 4>& dst,
             const glm::mat3& matrix) {
-            // Find empty slot or least recently used
-            size_t replaceIdx = 0;
-            size_t minCounter = std::numeric_limits<size_t>::max();
+            if (entries_.empty()) return;
+
+            Key key = makeKey(src, dst);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                entries_[it->second].matrix = matrix;
+                moveToFront(it->second);
+                return;
+            }
 
-            for (size_t i = 0; i < CACHE_SIZE; ++i) {
-                if (!caches[i]) {
-                    replaceIdx = i;
-                    break;
-                }
+            std::uint32_t slot;
+            if (size_ < entries_.size()) {
+                slot = static_cast<std::uint32_t>(size_++);
+            }
+            else {
+                // Reuse the least recently used slot
+                slot = tail_;
+                unlink(slot);
+                index_.erase(entries_[slot].key);
+                ++evictions_;
+            }
 
-                if (caches[i]->lastUsed < minCounter) {
-                    minCounter = caches[i]->lastUsed;
-                    replaceIdx = i;
+            entries_[slot].key = key;
+            entries_[slot].matrix = matrix;
+            pushFront(slot);
+            index_.emplace(key, slot);
+        }
+
+        void clear() {
+            setCapacity(entries_.size());
+        }
+
+        void resetStats() {
+            hits_ = misses_ = evictions_ = 0;
+        }
+
+        HomographyCacheStats getStats() const {
+            return { hits_, misses_, evictions_, size_, entries_.size() };
+        }
+
+    private:
+        static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+        struct Key {
+            std::array<std::int64_t, 16> q;
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const {
+                std::uint64_t h = 0x9E3779B97F4A7C15ull;
+                for (std::int64_t v : key.q) {
+                    h ^= static_cast<std::uint64_t>(v) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
                 }
+                return static_cast<std::size_t>(h);
             }
+        };
 
-            caches[replaceIdx] = HomographyCache{
-                src, dst, matrix, ++cacheCounter
-            };
+        struct Entry {
+            Key key{};
+            glm::mat3 matrix{ 1.0f };
+            std::uint32_t prev = NONE;
+            std::uint32_t next = NONE;
+        };
+
+        Key makeKey(const std::array<glm::vec2, 4>& src, const std::array<glm::vec2, 4>& dst) const {
+            Key key;
+            for (int i = 0; i < 4; ++i) {
+                key.q[i * 2] = std::llround(static_cast<double>(src[i].x) * invQuantum_);
+                key.q[i * 2 + 1] = std::llround(static_cast<double>(src[i].y) * invQuantum_);
+                key.q[8 + i * 2] = std::llround(static_cast<double>(dst[i].x) * invQuantum_);
+                key.q[8 + i * 2 + 1] = std::llround(static_cast<double>(dst[i].y) * invQuantum_);
+            }
+            return key;
+        }
+
+        void unlink(std::uint32_t slot) {
+            Entry& e = entries_[slot];
+            if (e.prev != NONE) entries_[e.prev].next = e.next; else head_ = e.next;
+            if (e.next != NONE) entries_[e.next].prev = e.prev; else tail_ = e.prev;
+            e.prev = e.next = NONE;
         }
 
+        void pushFront(std::uint32_t slot) {
+            Entry& e = entries_[slot];
+            e.prev = NONE;
+            e.next = head_;
+            if (head_ != NONE) entries_[head_].prev = slot;
+            head_ = slot;
+            if (tail_ == NONE) tail_ = slot;
+        }
+
+        void moveToFront(std::uint32_t slot) {
+            if (slot == head_) return;
+            unlink(slot);
+            pushFront(slot);
+        }
+
+        double invQuantum_;
+        std::vector<Entry> entries_;
+        std::unordered_map<Key, std::uint32_t, KeyHash> index_;
+        std::uint32_t head_ = NONE;
+        std::uint32_t tail_ = NONE;
+        std::size_t size_ = 0;
+
+        std::uint64_t hits_ = 0;
+        std::uint64_t misses_ = 0;
+        std::uint64_t evictions_ = 0;
+    };
+
+    // Optimized homography computation
+    class HomographyCalculator {
+    private:
+        HomographyCache cache_;
+
         // Check if points form an axis-aligned rectangle
         bool isAxisAlignedRect(const std::array<glm::vec2, 4>& points, float epsilon = 1e-5f) {
             // Count unique x and y coordinates
@@ -324,7 +1062,8 @@ namespace gl {
         }
 
     public:
-        HomographyCalculator() = default;
+        explicit HomographyCalculator(std::size_t cacheCapacity = HomographyCache::DEFAULT_CAPACITY)
+            : cache_(cacheCapacity) {}
 
         // Compute homography with optional caching
         glm::mat3 compute(const std::array<glm::vec2, 4>& src,
@@ -332,7 +1071,7 @@ namespace gl {
             bool useCache = true) {
             // Check cache first if enabled
             if (useCache) {
-                auto cachedMatrix = findInCache(src, dst);
+                auto cachedMatrix = cache_.find(src, dst);
                 if (cachedMatrix) {
                     return *cachedMatrix;
                 }
@@ -344,94 +1083,76 @@ namespace gl {
 
                 // Update cache if enabled
                 if (useCache) {
-                    addToCache(src, dst, H);
+                    cache_.insert(src, dst, H);
                 }
 
                 return H;
             }
 
-            // Set up the 8x8 system for homography
-            float A[8][8] = {};
-            float b[8] = {};
-
-            // Fill the matrix A and vector b with constraints from the point pairs
-            for (int i = 0; i < 4; ++i) {
-                float x = src[i].x;
-                float y = src[i].y;
-                float x_prime = dst[i].x;
-                float y_prime = dst[i].y;
-
-                // Precompute products to avoid redundant calculations
-                float x_x_prime = x * x_prime;
-                float y_x_prime = y * x_prime;
-                float x_y_prime = x * y_prime;
-                float y_y_prime = y * y_prime;
+            // Closed form when either side is the unit square or a parallelogram:
+            // H = S2Q(dst) * adj(S2Q(src)), no linear system to factor
+            if (isParallelogram(src) || isParallelogram(dst)) {
+                auto srcMap = squareToQuad(src);
+                auto dstMap = squareToQuad(dst);
+                if (srcMap && dstMap) {
+                    glm::mat3 H = normalizeHomography(*dstMap * adjugate(*srcMap));
 
-                // Row for x equation: x*h0 + y*h1 + h2 - x*x'*h6 - y*x'*h7 = x'
-                A[i * 2][0] = x;
-                A[i * 2][1] = y;
-                A[i * 2][2] = 1.0f;
-                A[i * 2][3] = 0.0f;
-                A[i * 2][4] = 0.0f;
-                A[i * 2][5] = 0.0f;
-                A[i * 2][6] = -x_x_prime;
-                A[i * 2][7] = -y_x_prime;
-                b[i * 2] = x_prime;
+                    if (useCache) {
+                        cache_.insert(src, dst, H);
+                    }
 
-                // Row for y equation: x*h3 + y*h4 + h5 - x*y'*h6 - y*y'*h7 = y'
-                A[i * 2 + 1][0] = 0.0f;
-                A[i * 2 + 1][1] = 0.0f;
-                A[i * 2 + 1][2] = 0.0f;
-                A[i * 2 + 1][3] = x;
-                A[i * 2 + 1][4] = y;
-                A[i * 2 + 1][5] = 1.0f;
-                A[i * 2 + 1][6] = -x_y_prime;
-                A[i * 2 + 1][7] = -y_y_prime;
-                b[i * 2 + 1] = y_prime;
-            }
-
-            // Set up the solver
-            solver.setSystem(A, b);
-
-            // Perform LU decomposition
-            if (!solver.decompose()) {
-                throw std::runtime_error("Singular matrix encountered in homography computation");
+                    return H;
+                }
             }
 
-            // Solve the system
-            float h[8];
-            solver.solve(h);
-
-            // Construct homography matrix (in column-major order for GLM)
-            glm::mat3 H(1.0f);
-            H[0][0] = h[0]; H[1][0] = h[1]; H[2][0] = h[2]; // First column
-            H[0][1] = h[3]; H[1][1] = h[4]; H[2][1] = h[5]; // Second column
-            H[0][2] = h[6]; H[1][2] = h[7]; H[2][2] = 1.0f; // Third column
-
-            // Normalize the homography matrix for better numerical stability
-            if (std::abs(H[2][2]) > 1e-10f) {
-                float scale = 1.0f / H[2][2];
-                for (int i = 0; i < 3; ++i) {
-                    for (int j = 0; j < 3; ++j) {
-                        H[i][j] *= scale;
-                    }
-                }
+            // General case: the 8x8 system
+            std::optional<glm::mat3> solved = solveHomography(src, dst);
+            if (!solved) {
+                throw std::runtime_error("Singular matrix encountered in homography computation");
             }
+            glm::mat3 H = *solved;
 
             // Update cache if enabled
             if (useCache) {
-                addToCache(src, dst, H);
+                cache_.insert(src, dst, H);
             }
 
             return H;
         }
 
+        // Compute the homography and its inverse. The inverse comes from the
+        // adjugate, so callers don't need a general matrix inverse.
+        HomographyPair computeWithInverse(const std::array<glm::vec2, 4>& src,
+            const std::array<glm::vec2, 4>& dst,
+            bool useCache = true) {
+            glm::mat3 H = compute(src, dst, useCache);
+            return { H, inverseHomography(H) };
+        }
+
+        // Solve many systems at once (bypasses the cache). Returns the number
+        // of singular systems, whose output is set to a zero matrix.
+        std::size_t computeBatch(std::span<const std::array<glm::vec2, 4>> src,
+            std::span<const std::array<glm::vec2, 4>> dst,
+            std::span<glm::mat3> out) const {
+            return computeHomographyBatch(src, dst, out);
+        }
+
         // Clear the cache
         void clearCache() {
-            for (auto& cache : caches) {
-                cache.reset();
-            }
-            cacheCounter = 0;
+            cache_.clear();
+        }
+
+        // Resize the cache (drops cached entries)
+        void setCacheCapacity(std::size_t capacity) {
+            cache_.setCapacity(capacity);
+        }
+
+        HomographyCacheStats getCacheStats() const {
+            return cache_.getStats();
+        }
+
+        void resetCacheStats() {
+            cache_.resetStats();
         }
     };
 
@@ -447,6 +1168,46 @@ namespace gl {
         return getHomographyCalculator().compute(src, dst);
     }
 
+    // Cache counters of the calling thread's calculator
+    inline HomographyCacheStats getHomographyCacheStats() {
+        return getHomographyCalculator().getCacheStats();
+    }
+
+    inline HomographyPair computeHomographyWithInverse(const std::array<glm::vec2, 4>& src,
+        const std::array<glm::vec2, 4>& dst) {
+        return getHomographyCalculator().computeWithInverse(src, dst);
+    }
+
+    namespace detail {
+
+        constexpr bool approxEqual(const glm::mat3& a, const glm::mat3& b, float epsilon = 1e-5f) {
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    if (constexprAbs(a[i][j] - b[i][j]) > epsilon) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        constexpr std::array<glm::vec2, 4> CHECK_SQUARE = {
+            glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f)
+        };
+        constexpr std::array<glm::vec2, 4> CHECK_QUAD = {
+            glm::vec2(0.1f, 0.2f), glm::vec2(0.9f, 0.1f), glm::vec2(1.1f, 1.0f), glm::vec2(-0.2f, 0.8f)
+        };
+
+        // Compile-time checks of the constexpr path: closed form and the 8x8
+        // solve must agree, and the adjugate must invert
+        static_assert(approxEqual(*squareToQuad(CHECK_SQUARE), glm::mat3(1.0f)));
+        static_assert(approxEqual(*solveHomography(CHECK_SQUARE, CHECK_QUAD), *squareToQuad(CHECK_QUAD)));
+        static_assert(approxEqual(*solveHomography(CHECK_QUAD, CHECK_SQUARE), *quadToSquare(CHECK_QUAD)));
+        static_assert(approxEqual(normalizeHomography(
+            multiplyHomography(*quadToSquare(CHECK_QUAD), *squareToQuad(CHECK_QUAD))), glm::mat3(1.0f)));
+
+    } // namespace detail
+
 } // namespace gl
 
 #endif // HOMOGRAPHY_HPP
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef GL_IMAGE_HPP
+#define GL_IMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+
+    // 8-bit interleaved CPU image (1-4 channels, tightly packed rows)
+    class Image {
+    public:
+        Image() = default;
+
+        Image(int width, int height, int channels) {
+            resize(width, height, channels);
+        }
+
+        // Reallocate only when the new size needs more storage
+        void resize(int width, int height, int channels) {
+            if (width < 0 || height < 0 || channels < 1 || channels > 4) {
+                throw std::invalid_argument("Invalid image dimensions");
+            }
+            width_ = width;
+            height_ = height;
+            channels_ = channels;
+            pixels_.resize(static_cast<std::size_t>(width) * height * channels);
+        }
+
+        int getWidth() const { return width_; }
+        int getHeight() const { return height_; }
+        int getChannels() const { return channels_; }
+        std::size_t getStride() const { return static_cast<std::size_t>(width_) * channels_; }
+        std::size_t getSizeInBytes() const { return pixels_.size(); }
+        bool empty() const { return pixels_.empty(); }
+
+        std::uint8_t* getData() { return pixels_.data(); }
+        const std::uint8_t* getData() const { return pixels_.data(); }
+
+        std::uint8_t* getRow(int y) { return pixels_.data() + y * getStride(); }
+        const std::uint8_t* getRow(int y) const { return pixels_.data() + y * getStride(); }
+
+    private:
+        int width_ = 0;
+        int height_ = 0;
+        int channels_ = 0;
+        std::vector<std::uint8_t> pixels_;
+    };
+
+} // namespace gl
+
+#endif // GL_IMAGE_HPP
@@ -0,0 +1,358 @@
+#ifndef GL_JOB_SYSTEM_HPP
+#define GL_JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gl {
+
+    // Counts unfinished jobs; JobSystem::wait returns once it reaches zero
+    class JobCounter {
+    public:
+        bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<std::size_t> pending_{ 0 };
+    };
+
+    // Work-stealing pool of worker threads for all CPU-side parallel work,
+    // from per-frame system updates to batch image processing. Every worker
+    // owns a deque: it pushes and pops its own jobs at the back (newest
+    // first, still warm in cache) and, when empty, steals the oldest job
+    // from the front of another's deque. Threads outside the pool share one
+    // extra deque. Waiting runs other jobs instead of blocking, so jobs may
+    // spawn and wait on nested jobs without deadlocking.
+    class JobSystem {
+    public:
+        // Workers in addition to the calling thread, which joins in while it
+        // waits. 0 runs every job on the caller.
+        explicit JobSystem(std::size_t workerCount = defaultWorkerCount())
+            : queues_(workerCount + 1) {
+            workers_.reserve(workerCount);
+            for (std::size_t i = 0; i < workerCount; ++i) {
+                workers_.emplace_back([this, i] { workerLoop(i + 1); });
+            }
+        }
+
+        ~JobSystem() {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+            // Workers drain the queues before they exit; this only catches
+            // jobs queued by the last ones to run
+            while (runOne()) {}
+        }
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        static std::size_t defaultWorkerCount() {
+            const unsigned cores = std::thread::hardware_concurrency();
+            return cores > 1 ? cores - 1 : 0;
+        }
+
+        std::size_t getWorkerCount() const { return workers_.size(); }
+
+        // Threads that execute jobs during a wait, the caller included
+        std::size_t getConcurrency() const { return workers_.size() + 1; }
+
+        // Queue fn() under counter. fn is copied to the heap and must stay
+        // valid to call until the counter is waited on. It must not throw;
+        // nothing would be left to catch it.
+        template<typename F>
+        void run(JobCounter& counter, F&& fn) {
+            pushTask(&counter, std::forward<F>(fn));
+        }
+
+        // Queue fn() and get a future for its result, for longer tasks that
+        // are waited on one by one rather than as a batch
+        template<typename F>
+        auto submit(F&& fn) -> std::future<std::invoke_result_t<F>> {
+            using Result = std::invoke_result_t<F>;
+            std::packaged_task<Result()> task(std::forward<F>(fn));
+            std::future<Result> future = task.get_future();
+            pushTask(nullptr, std::move(task));
+            return future;
+        }
+
+        // Call fn(i) for every i in [0, count) and return when every call
+        // has. Indices are handed out one at a time, so uneven items (tiles,
+        // RANSAC batches) balance across threads; the caller takes part.
+        // If fn throws, the indices not yet started are skipped and the first
+        // exception is rethrown here once every started call has returned.
+        template<typename F>
+        void parallelFor(std::size_t count, F&& fn) {
+            if (count == 0) return;
+
+            const std::size_t helpers = std::min(workers_.size(), count - 1);
+            if (helpers == 0) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i);
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next{ 0 };
+            FirstException failure;
+            auto drain = [&] {
+                try {
+                    for (std::size_t i = next.fetch_add(1); i < count && !failure.hasFailed(); i = next.fetch_add(1)) {
+                        fn(i);
+                    }
+                }
+                catch (...) {
+                    failure.capture();
+                }
+            };
+            using Drain = decltype(drain);
+
+            // Helpers point at drain and counter, so wait for them even on failure
+            JobCounter counter;
+            for (std::size_t h = 0; h < helpers; ++h) {
+                push(&counter, { [](void* context, std::size_t, std::size_t) {
+                    (*static_cast<Drain*>(context))();
+                }, &drain, 0, 0 });
+            }
+            drain();
+            wait(counter);
+            failure.rethrow();
+        }
+
+        // Call fn(begin, end) over [0, count) in chunks of at least grain
+        // items and return when every chunk is done. The caller runs chunks
+        // too, and no allocation happens per chunk. Exceptions from fn are
+        // handled as in parallelFor(count, fn).
+        template<typename F>
+        void parallelFor(std::size_t count, std::size_t grain, F&& fn) {
+            if (count == 0) return;
+            grain = std::max<std::size_t>(grain, 1);
+
+            // A few chunks per thread so stealing can even out uneven chunks
+            const std::size_t target = getConcurrency() * 4;
+            const std::size_t chunk = std::max(grain, (count + target - 1) / target);
+            if (workers_.empty() || chunk >= count) {
+                fn(std::size_t(0), count);
+                return;
+            }
+
+            FirstException failure;
+            auto runChunk = [&](std::size_t begin, std::size_t end) {
+                if (failure.hasFailed()) return;
+                try {
+                    fn(begin, end);
+                }
+                catch (...) {
+                    failure.capture();
+                }
+            };
+            using RunChunk = decltype(runChunk);
+            auto invoke = [](void* context, std::size_t begin, std::size_t end) {
+                (*static_cast<RunChunk*>(context))(begin, end);
+            };
+
+            JobCounter counter;
+            for (std::size_t begin = chunk; begin < count; begin += chunk) {
+                push(&counter, { invoke, &runChunk, begin, std::min(count, begin + chunk) });
+            }
+            runChunk(std::size_t(0), chunk);
+            wait(counter);
+            failure.rethrow();
+        }
+
+        // Run queued jobs until every job under counter has finished
+        void wait(JobCounter& counter) {
+            while (!counter.isDone()) {
+                if (!runOne()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // Run one queued job, if any, on the calling thread. For callers that
+        // wait on something other than a counter but still want to help.
+        bool runPendingJob() { return runOne(); }
+
+    private:
+        // First exception thrown by the calls of one parallelFor
+        class FirstException {
+        public:
+            bool hasFailed() const { return failed_.load(std::memory_order_relaxed); }
+
+            // From a catch block
+            void capture() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!exception_) {
+                    exception_ = std::current_exception();
+                }
+                failed_.store(true, std::memory_order_relaxed);
+            }
+
+            // Once every call has returned
+            void rethrow() {
+                if (exception_) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            std::mutex mutex_;
+            std::exception_ptr exception_;
+            std::atomic<bool> failed_{ false };
+        };
+
+        struct Job {
+            void (*invoke)(void* context, std::size_t begin, std::size_t end) = nullptr;
+            void* context = nullptr;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            JobCounter* counter = nullptr;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        // Queue of the current thread: its own for workers of this system,
+        // the shared queue 0 for everyone else
+        std::size_t currentQueue() const {
+            return currentSystem == this ? currentIndex : 0;
+        }
+
+        // Queue fn on the heap; the job deletes it after running it
+        template<typename F>
+        void pushTask(JobCounter* counter, F&& fn) {
+            using Task = std::decay_t<F>;
+            auto* task = new Task(std::forward<F>(fn));
+            push(counter, { [](void* context, std::size_t, std::size_t) {
+                std::unique_ptr<Task> owned(static_cast<Task*>(context));
+                (*owned)();
+            }, task, 0, 0 });
+        }
+
+        // counter may be null for jobs only their future tracks
+        void push(JobCounter* counter, Job job) {
+            job.counter = counter;
+            if (counter) {
+                counter->pending_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (workers_.empty()) {
+                execute(job);
+                return;
+            }
+            Queue& queue = queues_[currentQueue()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.jobs.push_back(job);
+            }
+            // Sequentially consistent with the sleeper's side: either it sees
+            // this job, or we see it sleeping and wake it
+            queued_.fetch_add(1);
+            if (sleeping_.load() > 0) {
+                // Taking the lock orders this push against a worker about to sleep
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                wake_.notify_one();
+            }
+        }
+
+        bool pop(std::size_t index, Job& job) {
+            Queue& queue = queues_[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) return false;
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            return true;
+        }
+
+        bool steal(std::size_t index, Job& job) {
+            Queue& queue = queues_[index];
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || queue.jobs.empty()) return false;
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            return true;
+        }
+
+        // Take a job from the own queue first, then from the others
+        bool runOne() {
+            if (queued_.load(std::memory_order_acquire) == 0) return false;
+
+            const std::size_t self = currentQueue();
+            Job job;
+            bool found = pop(self, job);
+            for (std::size_t k = 1; !found && k < queues_.size(); ++k) {
+                found = steal((self + k) % queues_.size(), job);
+            }
+            if (!found) return false;
+
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            execute(job);
+            return true;
+        }
+
+        static void execute(const Job& job) {
+            job.invoke(job.context, job.begin, job.end);
+            if (job.counter) {
+                job.counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+        void workerLoop(std::size_t index) {
+            currentSystem = this;
+            currentIndex = index;
+            for (;;) {
+                // Spin briefly before sleeping; frame jobs tend to come in bursts
+                bool ran = false;
+                for (int attempt = 0; attempt < 64 && !ran; ++attempt) {
+                    ran = runOne();
+                    if (!ran) {
+                        std::this_thread::yield();
+                    }
+                }
+                if (ran) continue;
+
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                sleeping_.fetch_add(1);
+                wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+                sleeping_.fetch_sub(1);
+                if (stopping_ && queued_.load() == 0) return;
+            }
+        }
+
+        static inline thread_local const JobSystem* currentSystem = nullptr;
+        static inline thread_local std::size_t currentIndex = 0;
+
+        std::vector<Queue> queues_; // [0] is shared by outside threads
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> queued_{ 0 };
+        std::atomic<std::size_t> sleeping_{ 0 };
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+    };
+
+    // Process-wide job system sized to the machine, created on first use
+    inline JobSystem& getDefaultJobSystem() {
+        static JobSystem jobs;
+        return jobs;
+    }
+
+} // namespace gl
+
+#endif // GL_JOB_SYSTEM_HPP
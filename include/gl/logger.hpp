@@ -1,6 +1,9 @@
 #ifndef GL_LOGGER_HPP
 #define GL_LOGGER_HPP
 
+#include <atomic>
+#include <cstring>
+#include <ctime>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -30,7 +33,11 @@ namespace gl {
         }
 
         void setLevel(LogLevel level) {
-            currentLevel_ = level;
+            currentLevel_.store(level, std::memory_order_relaxed);
+        }
+
+        bool isEnabled(LogLevel level) const {
+            return level >= currentLevel_.load(std::memory_order_relaxed);
         }
 
         void setOutputFile(const std::string& filename) {
@@ -45,7 +52,7 @@ namespace gl {
         void log(LogLevel level,
             const std::string& message,
             const std::source_location& location = std::source_location::current()) {
-            if (level < currentLevel_) return;
+            if (!isEnabled(level)) return;
 
             std::stringstream ss;
             // Add timestamp
@@ -145,7 +152,8 @@ namespace gl {
             }
         }
 
-        LogLevel currentLevel_;
+        // Read without the mutex by every log call, from any thread
+        std::atomic<LogLevel> currentLevel_;
         std::mutex mutex_;
         std::ofstream fileOutput_;
         std::vector<std::string> logBuffer_;
@@ -161,6 +169,12 @@ namespace gl {
         Logger::instance().setOutputFile(filename);
     }
 
+    // Whether a message at this level would be written; lets hot paths skip
+    // building the message string
+    inline bool isLogEnabled(LogLevel level) {
+        return Logger::instance().isEnabled(level);
+    }
+
     template<typename... Args>
     inline void logDebug(const std::string& message, const std::source_location& loc = std::source_location::current()) {
         Logger::instance().debug(message, loc);
@@ -0,0 +1,202 @@
+#ifndef GL_PROJECTION_HPP
+#define GL_PROJECTION_HPP
+
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace gl {
+
+    // Points whose homogeneous w falls to |w| <= PROJECTION_EPSILON map to
+    // infinity; their output is (inf, inf)
+    constexpr float PROJECTION_EPSILON = 1e-12f;
+
+    // Inputs at least this large are split across the thread pool
+    constexpr std::size_t PROJECTION_PARALLEL_THRESHOLD = 16384;
+
+    // Project a single point through H (column-major, column vectors).
+    // Usable in constant expressions, hence the written-out product.
+    constexpr glm::vec2 projectPoint(const glm::mat3& H, const glm::vec2& p) {
+        glm::vec3 q = H[0] * p.x + H[1] * p.y + H[2];
+        // Written as a select rather than an early return so loops over it vectorize
+        glm::vec2 projected = glm::vec2(q) / q.z;
+        bool atInfinity = q.z <= PROJECTION_EPSILON && q.z >= -PROJECTION_EPSILON;
+        return atInfinity ? glm::vec2(std::numeric_limits<float>::infinity()) : projected;
+    }
+
+    // False for the output of a point that projected to infinity
+    inline bool isFiniteProjection(const glm::vec2& p) {
+        return std::isfinite(p.x) && std::isfinite(p.y);
+    }
+
+    namespace detail {
+
+        // Points per pool task
+        constexpr std::size_t PROJECTION_BLOCK = 4096;
+
+        // Project count SoA points, V::Width at a time with a scalar tail
+        template<typename V>
+        void projectLanes(const glm::mat3& H, const float* xs, const float* ys,
+            float* outX, float* outY, std::size_t count) {
+            const V h00(H[0][0]), h01(H[1][0]), h02(H[2][0]);
+            const V h10(H[0][1]), h11(H[1][1]), h12(H[2][1]);
+            const V h20(H[0][2]), h21(H[1][2]), h22(H[2][2]);
+            const V one(1.0f);
+            const V epsilon(PROJECTION_EPSILON);
+            const V infinity(std::numeric_limits<float>::infinity());
+
+            std::size_t i = 0;
+            for (; i + V::Width <= count; i += V::Width) {
+                const V x = V::load(xs + i);
+                const V y = V::load(ys + i);
+                const V X = simd::fmadd(h00, x, simd::fmadd(h01, y, h02));
+                const V Y = simd::fmadd(h10, x, simd::fmadd(h11, y, h12));
+                const V W = simd::fmadd(h20, x, simd::fmadd(h21, y, h22));
+                const auto atInfinity = simd::abs(W) <= epsilon;
+                const V iw = one / W;
+                simd::select(atInfinity, infinity, X * iw).store(outX + i);
+                simd::select(atInfinity, infinity, Y * iw).store(outY + i);
+            }
+            for (; i < count; ++i) {
+                glm::vec2 p = projectPoint(H, glm::vec2(xs[i], ys[i]));
+                outX[i] = p.x;
+                outY[i] = p.y;
+            }
+        }
+
+        // Project count interleaved (x, y) points. Each register holds
+        // V::Width / 2 points; duplicating the even and odd lanes broadcasts x
+        // and y across each pair, so the rows of H apply without a transpose.
+        template<typename V>
+        void projectInterleaved(const glm::mat3& H, const glm::vec2* in, glm::vec2* out, std::size_t count) {
+            std::size_t i = 0;
+            if constexpr (V::Width >= 2) {
+                constexpr std::size_t PAIRS = V::Width / 2;
+                if (count >= PAIRS) {
+                    alignas(64) float cx[V::Width], cy[V::Width], cz[V::Width];
+                    for (int l = 0; l < V::Width; l += 2) {
+                        cx[l] = H[0][0]; cx[l + 1] = H[0][1];
+                        cy[l] = H[1][0]; cy[l + 1] = H[1][1];
+                        cz[l] = H[2][0]; cz[l + 1] = H[2][1];
+                    }
+                    const V c0 = V::load(cx), c1 = V::load(cy), c2 = V::load(cz);
+                    const V h20(H[0][2]), h21(H[1][2]), h22(H[2][2]);
+                    const V one(1.0f);
+                    const V epsilon(PROJECTION_EPSILON);
+                    const V infinity(std::numeric_limits<float>::infinity());
+
+                    const float* src = reinterpret_cast<const float*>(in);
+                    float* dst = reinterpret_cast<float*>(out);
+                    for (; i + PAIRS <= count; i += PAIRS) {
+                        const V p = V::load(src + i * 2);
+                        const V x = simd::duplicateEven(p);
+                        const V y = simd::duplicateOdd(p);
+                        const V numerator = simd::fmadd(c0, x, simd::fmadd(c1, y, c2));
+                        const V W = simd::fmadd(h20, x, simd::fmadd(h21, y, h22));
+                        const auto atInfinity = simd::abs(W) <= epsilon;
+                        simd::select(atInfinity, infinity, numerator * (one / W)).store(dst + i * 2);
+                    }
+                }
+            }
+            for (; i < count; ++i) {
+                out[i] = projectPoint(H, in[i]);
+            }
+        }
+
+        // Run fn(begin, end) over [0, count), across the pool for large inputs
+        template<typename F>
+        void forEachProjectionBlock(std::size_t count, JobSystem* pool, F&& fn) {
+            if (count < PROJECTION_PARALLEL_THRESHOLD) {
+                fn(std::size_t(0), count);
+                return;
+            }
+            JobSystem& workers = pool ? *pool : getDefaultJobSystem();
+            const std::size_t blocks = (count + PROJECTION_BLOCK - 1) / PROJECTION_BLOCK;
+            workers.parallelFor(blocks, [&](std::size_t block) {
+                const std::size_t begin = block * PROJECTION_BLOCK;
+                fn(begin, std::min(count, begin + PROJECTION_BLOCK));
+            });
+        }
+
+    } // namespace detail
+
+    // Project every point in `in` through H into `out` (which may alias `in`)
+    template<typename V = simd::NativeFloat>
+    void projectPoints(const glm::mat3& H, std::span<const glm::vec2> in, std::span<glm::vec2> out,
+        JobSystem* pool = nullptr) {
+        if (in.size() != out.size()) {
+            throw std::invalid_argument("Projection input and output sizes differ");
+        }
+        detail::forEachProjectionBlock(in.size(), pool, [&](std::size_t begin, std::size_t end) {
+            detail::projectInterleaved<V>(H, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+
+    // Structure-of-arrays variant; outputs may alias the inputs
+    template<typename V = simd::NativeFloat>
+    void projectPoints(const glm::mat3& H, std::span<const float> xs, std::span<const float> ys,
+        std::span<float> outX, std::span<float> outY, JobSystem* pool = nullptr) {
+        if (xs.size() != ys.size() || xs.size() != outX.size() || xs.size() != outY.size()) {
+            throw std::invalid_argument("Projection input and output sizes differ");
+        }
+        detail::forEachProjectionBlock(xs.size(), pool, [&](std::size_t begin, std::size_t end) {
+            detail::projectLanes<V>(H, xs.data() + begin, ys.data() + begin,
+                outX.data() + begin, outY.data() + begin, end - begin);
+        });
+    }
+
+    // Project the same points through many homographies:
+    // out[m * in.size() + i] = Hs[m] applied to in[i]
+    template<typename V = simd::NativeFloat>
+    void projectPoints(std::span<const glm::mat3> Hs, std::span<const glm::vec2> in,
+        std::span<glm::vec2> out, JobSystem* pool = nullptr) {
+        if (out.size() != Hs.size() * in.size()) {
+            throw std::invalid_argument("Projection output must hold one point set per matrix");
+        }
+        if (in.empty()) return;
+
+        // Large point sets are split per matrix; many small sets (e.g. decal
+        // corners) are grouped so each task still has enough work. Sets
+        // smaller than a register take the scalar tail, which beat spreading
+        // matrices across lanes since that needs a 9-way transpose per group.
+        const std::size_t n = in.size();
+        if (n >= PROJECTION_PARALLEL_THRESHOLD) {
+            for (std::size_t m = 0; m < Hs.size(); ++m) {
+                projectPoints<V>(Hs[m], in, out.subspan(m * n, n), pool);
+            }
+            return;
+        }
+        const std::size_t groupSize = std::max<std::size_t>(1, detail::PROJECTION_BLOCK / n);
+        const std::size_t groups = (Hs.size() + groupSize - 1) / groupSize;
+        auto projectGroup = [&](std::size_t group) {
+            const std::size_t last = std::min(Hs.size(), (group + 1) * groupSize);
+            for (std::size_t m = group * groupSize; m < last; ++m) {
+                if (n < static_cast<std::size_t>(V::Width)) {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        out[m * n + i] = projectPoint(Hs[m], in[i]);
+                    }
+                }
+                else {
+                    detail::projectInterleaved<V>(Hs[m], in.data(), out.data() + m * n, n);
+                }
+            }
+        };
+        if (Hs.size() * n < PROJECTION_PARALLEL_THRESHOLD) {
+            for (std::size_t group = 0; group < groups; ++group) {
+                projectGroup(group);
+            }
+            return;
+        }
+        JobSystem& workers = pool ? *pool : getDefaultJobSystem();
+        workers.parallelFor(groups, projectGroup);
+    }
+
+} // namespace gl
+
+#endif // GL_PROJECTION_HPP
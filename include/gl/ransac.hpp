@@ -0,0 +1,321 @@
+#ifndef GL_RANSAC_HPP
+#define GL_RANSAC_HPP
+
+#include "homography.hpp"
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+
+    struct RansacOptions {
+        // Max reprojection error (in dst units) for a correspondence to count as an inlier
+        float inlierThreshold = 3.0f;
+
+        // Stop once this probability of having drawn an all-inlier sample is reached
+        // (1.0 disables early termination and always runs maxIterations)
+        float confidence = 0.995f;
+
+        int maxIterations = 2000;
+
+        // Hypotheses sampled, solved and scored together
+        int hypothesesPerBatch = 64;
+
+        unsigned seed = 0x5EED;
+
+        // Pool used for scoring; nullptr uses getDefaultJobSystem()
+        JobSystem* pool = nullptr;
+    };
+
+    struct RansacResult {
+        glm::mat3 homography = glm::mat3(1.0f);
+        std::vector<std::uint8_t> inliers; // 1 per correspondence that fits the final model
+        std::size_t inlierCount = 0;
+        int iterations = 0;                // Hypotheses evaluated
+        bool success = false;
+    };
+
+    namespace detail {
+
+        // H or -H, whichever gives Z = h20 x + h21 y + h22 > 0 on the given
+        // source points. countInliers keeps only points with Z > 0, but
+        // scaling to h22 = 1 makes Z positive at the source origin instead,
+        // and the data may lie beyond H's horizon line from there.
+        inline glm::mat3 orientHomography(const glm::mat3& H, std::span<const glm::vec2> src,
+            std::span<const std::uint32_t> indices) {
+            double z = 0.0;
+            for (std::uint32_t i : indices) {
+                z += static_cast<double>(H[0][2]) * src[i].x + static_cast<double>(H[1][2]) * src[i].y + H[2][2];
+            }
+            return z < 0.0 ? -H : H;
+        }
+
+        inline glm::mat3 orientHomography(const glm::mat3& H, const std::array<glm::vec2, 4>& sample) {
+            constexpr std::uint32_t corners[4] = { 0, 1, 2, 3 };
+            return orientHomography(H, sample, corners);
+        }
+
+        // Least-squares homography over the given correspondences: Hartley
+        // normalization, then the 8x8 normal equations of the DLT rows solved
+        // with LinearSolver8x8
+        inline std::optional<glm::mat3> fitHomographyLeastSquares(std::span<const glm::vec2> src,
+            std::span<const glm::vec2> dst, std::span<const std::uint32_t> indices) {
+            if (indices.size() < 4) {
+                return std::nullopt;
+            }
+
+            const glm::mat3 Ts = normalizationTransform(src, indices);
+            const glm::mat3 Td = normalizationTransform(dst, indices);
+
+            double AtA[8][8] = {};
+            double Atb[8] = {};
+            for (std::uint32_t i : indices) {
+                glm::vec3 s = Ts * glm::vec3(src[i], 1.0f);
+                glm::vec3 d = Td * glm::vec3(dst[i], 1.0f);
+                const double rx[8] = { s.x, s.y, 1.0, 0.0, 0.0, 0.0, -s.x * d.x, -s.y * d.x };
+                const double ry[8] = { 0.0, 0.0, 0.0, s.x, s.y, 1.0, -s.x * d.y, -s.y * d.y };
+                for (int r = 0; r < 8; ++r) {
+                    for (int c = r; c < 8; ++c) {
+                        AtA[r][c] += rx[r] * rx[c] + ry[r] * ry[c];
+                    }
+                    Atb[r] += rx[r] * d.x + ry[r] * d.y;
+                }
+            }
+
+            float A[8][8];
+            float b[8];
+            for (int r = 0; r < 8; ++r) {
+                for (int c = 0; c < 8; ++c) {
+                    A[r][c] = static_cast<float>(c >= r ? AtA[r][c] : AtA[c][r]);
+                }
+                b[r] = static_cast<float>(Atb[r]);
+            }
+
+            LinearSolver8x8 solver;
+            solver.setSystem(A, b);
+            if (!solver.decompose()) {
+                return std::nullopt;
+            }
+            float h[8];
+            solver.solve(h);
+
+            glm::mat3 Hn;
+            Hn[0][0] = h[0]; Hn[1][0] = h[1]; Hn[2][0] = h[2];
+            Hn[0][1] = h[3]; Hn[1][1] = h[4]; Hn[2][1] = h[5];
+            Hn[0][2] = h[6]; Hn[1][2] = h[7]; Hn[2][2] = 1.0f;
+
+            // Undo the normalization: H = Td^-1 * Hn * Ts
+            return orientHomography(normalizeHomography(glm::inverse(Td) * Hn * Ts), src, indices);
+        }
+
+        // Correspondences in structure-of-arrays form, padded to a whole
+        // number of SIMD registers with NaN so padding never counts as inlier
+        struct PointsSoA {
+            std::vector<float> sx, sy, dx, dy;
+            std::size_t count = 0;
+
+            PointsSoA(std::span<const glm::vec2> src, std::span<const glm::vec2> dst, std::size_t lanes) {
+                count = src.size();
+                const std::size_t padded = (count + lanes - 1) / lanes * lanes;
+                const float nan = std::numeric_limits<float>::quiet_NaN();
+                sx.assign(padded, 0.0f);
+                sy.assign(padded, 0.0f);
+                dx.assign(padded, nan);
+                dy.assign(padded, nan);
+                for (std::size_t i = 0; i < count; ++i) {
+                    sx[i] = src[i].x;
+                    sy[i] = src[i].y;
+                    dx[i] = dst[i].x;
+                    dy[i] = dst[i].y;
+                }
+            }
+        };
+
+        // Count correspondences with squared reprojection error <= t2. Uses
+        // (X - u'Z)^2 + (Y - v'Z)^2 <= t2 * Z^2 with Z > 0, which avoids the
+        // divide and rejects points mapped to or beyond infinity. H must be
+        // signed by orientHomography for the Z > 0 side to be the data's.
+        template<typename V>
+        std::size_t countInliers(const PointsSoA& pts, const glm::mat3& H, float t2,
+            std::uint8_t* mask = nullptr) {
+            const V h00(H[0][0]), h01(H[1][0]), h02(H[2][0]);
+            const V h10(H[0][1]), h11(H[1][1]), h12(H[2][1]);
+            const V h20(H[0][2]), h21(H[1][2]), h22(H[2][2]);
+            const V threshold(t2);
+            const V zero(0.0f);
+
+            std::size_t inliers = 0;
+            for (std::size_t i = 0; i < pts.sx.size(); i += V::Width) {
+                V x = V::load(&pts.sx[i]);
+                V y = V::load(&pts.sy[i]);
+                V X = simd::fmadd(h00, x, simd::fmadd(h01, y, h02));
+                V Y = simd::fmadd(h10, x, simd::fmadd(h11, y, h12));
+                V Z = simd::fmadd(h20, x, simd::fmadd(h21, y, h22));
+                V ex = X - V::load(&pts.dx[i]) * Z;
+                V ey = Y - V::load(&pts.dy[i]) * Z;
+                auto fits = simd::maskAnd(ex * ex + ey * ey <= threshold * Z * Z, zero < Z);
+                unsigned bits = simd::maskBits(fits);
+                inliers += static_cast<std::size_t>(std::popcount(bits));
+                if (mask) {
+                    for (int lane = 0; lane < V::Width && i + lane < pts.count; ++lane) {
+                        mask[i + lane] = static_cast<std::uint8_t>((bits >> lane) & 1u);
+                    }
+                }
+            }
+            return inliers;
+        }
+
+        // Reject samples where three source or destination points are collinear
+        inline bool isDegenerateSample(const std::array<glm::vec2, 4>& q) {
+            glm::vec2 lo = glm::min(glm::min(q[0], q[1]), glm::min(q[2], q[3]));
+            glm::vec2 hi = glm::max(glm::max(q[0], q[1]), glm::max(q[2], q[3]));
+            glm::vec2 extent = hi - lo;
+            float epsilon = 1e-6f * std::max(extent.x * extent.x + extent.y * extent.y, 1e-20f);
+            for (int skip = 0; skip < 4; ++skip) {
+                const glm::vec2& a = q[(skip + 1) % 4];
+                const glm::vec2& b = q[(skip + 2) % 4];
+                const glm::vec2& c = q[(skip + 3) % 4];
+                glm::vec2 ab = b - a, ac = c - a;
+                if (std::abs(ab.x * ac.y - ab.y * ac.x) < epsilon) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    } // namespace detail
+
+    // Robust homography from N >= 4 correspondences. Minimal samples are drawn
+    // in batches, solved together with computeHomographyBatch and scored in
+    // SIMD across the thread pool. The iteration count adapts to the best
+    // inlier ratio found so far, and the winner is refit by least squares on
+    // its inliers.
+    inline RansacResult estimateHomographyRansac(std::span<const glm::vec2> src,
+        std::span<const glm::vec2> dst, const RansacOptions& options = {}) {
+        using V = simd::NativeFloat;
+
+        if (src.size() != dst.size()) {
+            throw std::invalid_argument("RANSAC source and destination sizes differ");
+        }
+        if (src.size() < 4) {
+            throw std::invalid_argument("RANSAC needs at least 4 correspondences");
+        }
+
+        const std::size_t n = src.size();
+        const float t2 = options.inlierThreshold * options.inlierThreshold;
+        const int batchSize = std::max(1, options.hypothesesPerBatch);
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+        const detail::PointsSoA points(src, dst, V::Width);
+
+        std::mt19937 rng(options.seed);
+        std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(n - 1));
+
+        std::vector<std::array<glm::vec2, 4>> sampleSrc(batchSize), sampleDst(batchSize);
+        std::vector<glm::mat3> hypotheses(batchSize);
+        std::vector<std::size_t> scores(batchSize);
+
+        RansacResult result;
+        std::size_t bestInliers = 0;
+        glm::mat3 bestH(1.0f);
+        double requiredIterations = options.maxIterations;
+
+        while (result.iterations < requiredIterations && result.iterations < options.maxIterations) {
+            const int batch = std::min(batchSize, options.maxIterations - result.iterations);
+
+            // Draw minimal samples of four distinct, non-degenerate correspondences
+            for (int b = 0; b < batch; ++b) {
+                for (int attempt = 0; attempt < 100; ++attempt) {
+                    std::uint32_t idx[4];
+                    for (int k = 0; k < 4; ++k) {
+                        bool unique;
+                        do {
+                            idx[k] = pick(rng);
+                            unique = true;
+                            for (int j = 0; j < k; ++j) unique = unique && idx[j] != idx[k];
+                        } while (!unique);
+                        sampleSrc[b][k] = src[idx[k]];
+                        sampleDst[b][k] = dst[idx[k]];
+                    }
+                    if (!detail::isDegenerateSample(sampleSrc[b]) && !detail::isDegenerateSample(sampleDst[b])) {
+                        break;
+                    }
+                }
+            }
+
+            computeHomographyBatch(std::span<const std::array<glm::vec2, 4>>(sampleSrc.data(), batch),
+                std::span<const std::array<glm::vec2, 4>>(sampleDst.data(), batch),
+                std::span<glm::mat3>(hypotheses.data(), batch));
+
+            pool.parallelFor(static_cast<std::size_t>(batch), [&](std::size_t b) {
+                // Singular samples come back as zero matrices and score nothing
+                if (hypotheses[b][2][2] == 0.0f) {
+                    scores[b] = 0;
+                    return;
+                }
+                hypotheses[b] = detail::orientHomography(hypotheses[b], sampleSrc[b]);
+                scores[b] = detail::countInliers<V>(points, hypotheses[b], t2);
+            });
+
+            for (int b = 0; b < batch; ++b) {
+                if (scores[b] > bestInliers) {
+                    bestInliers = scores[b];
+                    bestH = hypotheses[b];
+                }
+            }
+            result.iterations += batch;
+
+            // Adaptive termination: k = log(1 - p) / log(1 - w^4)
+            if (bestInliers > 0 && options.confidence < 1.0f) {
+                double w = static_cast<double>(bestInliers) / static_cast<double>(n);
+                double allInlier = std::pow(w, 4.0);
+                if (allInlier >= 1.0 - 1e-12) {
+                    requiredIterations = 0;
+                }
+                else if (allInlier > 0.0) {
+                    requiredIterations = std::log(1.0 - options.confidence) / std::log(1.0 - allInlier);
+                }
+            }
+        }
+
+        if (bestInliers < 4) {
+            return result;
+        }
+
+        // Least-squares refit on the consensus set; keep it if it doesn't lose support
+        result.inliers.resize(n);
+        detail::countInliers<V>(points, bestH, t2, result.inliers.data());
+        std::vector<std::uint32_t> inlierIndices;
+        inlierIndices.reserve(bestInliers);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (result.inliers[i]) inlierIndices.push_back(static_cast<std::uint32_t>(i));
+        }
+
+        if (auto refit = detail::fitHomographyLeastSquares(src, dst, inlierIndices)) {
+            std::vector<std::uint8_t> refitMask(n);
+            std::size_t refitInliers = detail::countInliers<V>(points, *refit, t2, refitMask.data());
+            if (refitInliers >= bestInliers) {
+                bestH = *refit;
+                bestInliers = refitInliers;
+                result.inliers = std::move(refitMask);
+            }
+        }
+
+        result.homography = normalizeHomography(bestH);
+        result.inlierCount = bestInliers;
+        result.success = true;
+        return result;
+    }
+
+} // namespace gl
+
+#endif // GL_RANSAC_HPP
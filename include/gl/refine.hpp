@@ -0,0 +1,294 @@
+#ifndef GL_REFINE_HPP
+#define GL_REFINE_HPP
+
+#include "homography.hpp"
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+namespace gl {
+
+    struct HomographyRefineOptions {
+        int maxIterations = 20;
+
+        // Starting damping factor; scaled by 10 on every rejected step and by
+        // 0.1 on every accepted one
+        float initialLambda = 1e-3f;
+
+        // Stop once an accepted step reduces the squared error by less than this fraction
+        float relativeTolerance = 1e-6f;
+    };
+
+    struct HomographyRefineResult {
+        glm::mat3 homography = glm::mat3(1.0f);
+        float initialError = 0.0f; // RMS reprojection error in dst units
+        float finalError = 0.0f;
+        int iterations = 0;
+        bool converged = false;
+    };
+
+    // One plane of a batched refinement
+    struct HomographyRefineProblem {
+        std::span<const glm::vec2> src;
+        std::span<const glm::vec2> dst;
+        glm::mat3 initial = glm::mat3(1.0f);
+    };
+
+    namespace detail {
+
+        // Gauss-Newton normal equations J^T J and J^T r plus the squared error
+        struct HomographyNormalEquations {
+            double JtJ[8][8];
+            double Jtr[8];
+            double cost;
+        };
+
+        // Points per stack-resident SoA chunk
+        constexpr std::size_t REFINE_CHUNK = 128;
+
+        // Evaluate residuals and the 2Nx8 Jacobian of the reprojection error
+        // for p = (h00 h01 h02 h10 h11 h12 h20 h21), h22 = 1, V::Width points
+        // at a time. With g = (x, y, 1) / w the Jacobian rows are
+        //   du/dp = ( g,  0, -u'*gx, -u'*gy)
+        //   dv/dp = ( 0,  g, -v'*gx, -v'*gy)
+        // so J^T J needs only 21 distinct sums and J^T r another 6, all kept in
+        // registers. Points are transformed by Ts / Td on the fly into fixed
+        // stack chunks, so nothing is allocated.
+        template<typename V>
+        void accumulateHomographyNormalEquations(std::span<const glm::vec2> src,
+            std::span<const glm::vec2> dst, const glm::mat3& Ts, const glm::mat3& Td,
+            const float p[8], HomographyNormalEquations& out) {
+            static_assert(REFINE_CHUNK % V::Width == 0, "chunk must hold whole registers");
+
+            const V p0(p[0]), p1(p[1]), p2(p[2]), p3(p[3]), p4(p[4]), p5(p[5]), p6(p[6]), p7(p[7]);
+            const V one(1.0f);
+
+            // Sums of g g^T (shared by both diagonal blocks)
+            V aa(0.0f), ab(0.0f), ac(0.0f), bb(0.0f), bc(0.0f), cc(0.0f);
+            // Sums of u' * (g g01^T) and v' * (g g01^T)
+            V uaa(0.0f), uab(0.0f), ubb(0.0f), uac(0.0f), ubc(0.0f);
+            V vaa(0.0f), vab(0.0f), vbb(0.0f), vac(0.0f), vbc(0.0f);
+            // Sums of (u'^2 + v'^2) * (g01 g01^T)
+            V qaa(0.0f), qab(0.0f), qbb(0.0f);
+            // J^T r terms and squared error
+            V aru(0.0f), bru(0.0f), cru(0.0f), arv(0.0f), brv(0.0f), crv(0.0f);
+            V ar(0.0f), br(0.0f), cost(0.0f);
+
+            alignas(64) float xs[REFINE_CHUNK], ys[REFINE_CHUNK], us[REFINE_CHUNK], vs[REFINE_CHUNK], ws[REFINE_CHUNK];
+
+            for (std::size_t base = 0; base < src.size(); base += REFINE_CHUNK) {
+                const std::size_t count = std::min(REFINE_CHUNK, src.size() - base);
+                const std::size_t padded = (count + V::Width - 1) / V::Width * V::Width;
+                for (std::size_t i = 0; i < count; ++i) {
+                    const glm::vec2 s = src[base + i];
+                    const glm::vec2 d = dst[base + i];
+                    xs[i] = Ts[0][0] * s.x + Ts[2][0];
+                    ys[i] = Ts[1][1] * s.y + Ts[2][1];
+                    us[i] = Td[0][0] * d.x + Td[2][0];
+                    vs[i] = Td[1][1] * d.y + Td[2][1];
+                    ws[i] = 1.0f;
+                }
+                // Zero-weight padding contributes nothing to any sum
+                for (std::size_t i = count; i < padded; ++i) {
+                    xs[i] = ys[i] = us[i] = vs[i] = ws[i] = 0.0f;
+                }
+
+                for (std::size_t i = 0; i < padded; i += V::Width) {
+                    const V x = V::load(xs + i);
+                    const V y = V::load(ys + i);
+                    const V weight = V::load(ws + i);
+
+                    const V X = simd::fmadd(p0, x, simd::fmadd(p1, y, p2));
+                    const V Y = simd::fmadd(p3, x, simd::fmadd(p4, y, p5));
+                    const V W = simd::fmadd(p6, x, simd::fmadd(p7, y, one));
+                    const V iw = one / W;
+                    const V pu = X * iw;
+                    const V pv = Y * iw;
+
+                    const V c = iw * weight;
+                    const V a = x * c;
+                    const V b = y * c;
+                    const V ru = (pu - V::load(us + i)) * weight;
+                    const V rv = (pv - V::load(vs + i)) * weight;
+
+                    const V a2 = a * a, ab2 = a * b, b2 = b * b, ac2 = a * c, bc2 = b * c;
+                    aa = aa + a2; ab = ab + ab2; bb = bb + b2;
+                    ac = ac + ac2; bc = bc + bc2; cc = simd::fmadd(c, c, cc);
+
+                    uaa = simd::fmadd(pu, a2, uaa); uab = simd::fmadd(pu, ab2, uab); ubb = simd::fmadd(pu, b2, ubb);
+                    uac = simd::fmadd(pu, ac2, uac); ubc = simd::fmadd(pu, bc2, ubc);
+                    vaa = simd::fmadd(pv, a2, vaa); vab = simd::fmadd(pv, ab2, vab); vbb = simd::fmadd(pv, b2, vbb);
+                    vac = simd::fmadd(pv, ac2, vac); vbc = simd::fmadd(pv, bc2, vbc);
+
+                    const V q = simd::fmadd(pu, pu, pv * pv);
+                    qaa = simd::fmadd(q, a2, qaa); qab = simd::fmadd(q, ab2, qab); qbb = simd::fmadd(q, b2, qbb);
+
+                    aru = simd::fmadd(a, ru, aru); bru = simd::fmadd(b, ru, bru); cru = simd::fmadd(c, ru, cru);
+                    arv = simd::fmadd(a, rv, arv); brv = simd::fmadd(b, rv, brv); crv = simd::fmadd(c, rv, crv);
+
+                    const V pr = simd::fmadd(pu, ru, pv * rv);
+                    ar = simd::fmadd(a, pr, ar);
+                    br = simd::fmadd(b, pr, br);
+                    cost = simd::fmadd(ru, ru, simd::fmadd(rv, rv, cost));
+                }
+            }
+
+            auto sum = [](V value) { return static_cast<double>(simd::reduceAdd(value)); };
+            const double g[3][3] = {
+                { sum(aa), sum(ab), sum(ac) },
+                { sum(ab), sum(bb), sum(bc) },
+                { sum(ac), sum(bc), sum(cc) }
+            };
+            const double gu[3][2] = { { sum(uaa), sum(uab) }, { sum(uab), sum(ubb) }, { sum(uac), sum(ubc) } };
+            const double gv[3][2] = { { sum(vaa), sum(vab) }, { sum(vab), sum(vbb) }, { sum(vac), sum(vbc) } };
+
+            for (int r = 0; r < 8; ++r) {
+                for (int c = 0; c < 8; ++c) {
+                    out.JtJ[r][c] = 0.0;
+                }
+            }
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c) {
+                    out.JtJ[r][c] = g[r][c];
+                    out.JtJ[r + 3][c + 3] = g[r][c];
+                }
+                for (int c = 0; c < 2; ++c) {
+                    out.JtJ[r][6 + c] = out.JtJ[6 + c][r] = -gu[r][c];
+                    out.JtJ[r + 3][6 + c] = out.JtJ[6 + c][r + 3] = -gv[r][c];
+                }
+            }
+            out.JtJ[6][6] = sum(qaa);
+            out.JtJ[6][7] = out.JtJ[7][6] = sum(qab);
+            out.JtJ[7][7] = sum(qbb);
+
+            out.Jtr[0] = sum(aru); out.Jtr[1] = sum(bru); out.Jtr[2] = sum(cru);
+            out.Jtr[3] = sum(arv); out.Jtr[4] = sum(brv); out.Jtr[5] = sum(crv);
+            out.Jtr[6] = -sum(ar); out.Jtr[7] = -sum(br);
+            out.cost = sum(cost);
+        }
+
+    } // namespace detail
+
+    // Levenberg-Marquardt refinement of a homography (src -> dst) minimizing
+    // the sum of squared reprojection errors in dst. Works in Hartley-normalized
+    // coordinates and reuses one LinearSolver8x8 for every damped step.
+    template<typename V = simd::NativeFloat>
+    HomographyRefineResult refineHomography(std::span<const glm::vec2> src, std::span<const glm::vec2> dst,
+        const glm::mat3& initial, const HomographyRefineOptions& options = {}) {
+        if (src.size() != dst.size()) {
+            throw std::invalid_argument("Refinement source and destination sizes differ");
+        }
+        if (src.size() < 4) {
+            throw std::invalid_argument("Refinement needs at least 4 correspondences");
+        }
+
+        HomographyRefineResult result;
+        result.homography = initial;
+
+        const glm::mat3 Ts = detail::normalizationTransform(src);
+        const glm::mat3 Td = detail::normalizationTransform(dst);
+        const glm::mat3 TdInverse = glm::inverse(Td);
+        const glm::mat3 Hn = Td * initial * glm::inverse(Ts);
+        if (std::abs(Hn[2][2]) < 1e-10f) {
+            return result; // Parameterization with h22 = 1 can't represent it
+        }
+
+        auto toParameters = [](const glm::mat3& H, float p[8]) {
+            const float s = 1.0f / H[2][2];
+            p[0] = H[0][0] * s; p[1] = H[1][0] * s; p[2] = H[2][0] * s;
+            p[3] = H[0][1] * s; p[4] = H[1][1] * s; p[5] = H[2][1] * s;
+            p[6] = H[0][2] * s; p[7] = H[1][2] * s;
+        };
+        auto toMatrix = [](const float p[8]) {
+            glm::mat3 H;
+            H[0][0] = p[0]; H[1][0] = p[1]; H[2][0] = p[2];
+            H[0][1] = p[3]; H[1][1] = p[4]; H[2][1] = p[5];
+            H[0][2] = p[6]; H[1][2] = p[7]; H[2][2] = 1.0f;
+            return H;
+        };
+
+        // Normalized error back to dst units (Td is a uniform scale plus shift)
+        const double toPixels = 1.0 / (static_cast<double>(Td[0][0]) * std::sqrt(static_cast<double>(src.size())));
+
+        float p[8];
+        toParameters(Hn, p);
+        detail::HomographyNormalEquations current;
+        detail::HomographyNormalEquations trial;
+        detail::accumulateHomographyNormalEquations<V>(src, dst, Ts, Td, p, current);
+        result.initialError = static_cast<float>(std::sqrt(current.cost) * toPixels);
+
+        LinearSolver8x8 solver;
+        double lambda = options.initialLambda;
+        for (; result.iterations < options.maxIterations; ++result.iterations) {
+            // Marquardt damping scales the diagonal, keeping steps invariant to parameter scale
+            float A[8][8];
+            float b[8];
+            for (int r = 0; r < 8; ++r) {
+                for (int c = 0; c < 8; ++c) {
+                    A[r][c] = static_cast<float>(current.JtJ[r][c]);
+                }
+                A[r][r] = static_cast<float>(current.JtJ[r][r] * (1.0 + lambda));
+                b[r] = static_cast<float>(-current.Jtr[r]);
+            }
+
+            solver.setSystem(A, b);
+            if (!solver.decompose()) {
+                lambda *= 10.0;
+                continue;
+            }
+            float step[8];
+            solver.solve(step);
+
+            float candidate[8];
+            for (int i = 0; i < 8; ++i) {
+                candidate[i] = p[i] + step[i];
+            }
+            detail::accumulateHomographyNormalEquations<V>(src, dst, Ts, Td, candidate, trial);
+
+            if (std::isfinite(trial.cost) && trial.cost < current.cost) {
+                const double decrease = (current.cost - trial.cost) / current.cost;
+                std::copy(candidate, candidate + 8, p);
+                current = trial;
+                lambda = std::max(lambda * 0.1, 1e-12);
+                if (decrease < options.relativeTolerance) {
+                    result.converged = true;
+                    ++result.iterations;
+                    break;
+                }
+            }
+            else {
+                lambda *= 10.0;
+                if (lambda > 1e12) {
+                    result.converged = true; // No downhill step left at this precision
+                    break;
+                }
+            }
+        }
+
+        result.homography = normalizeHomography(TdInverse * toMatrix(p) * Ts);
+        result.finalError = static_cast<float>(std::sqrt(current.cost) * toPixels);
+        return result;
+    }
+
+    // Refine many independent planes at once, one problem per pool task
+    template<typename V = simd::NativeFloat>
+    void refineHomographyBatch(std::span<const HomographyRefineProblem> problems,
+        std::span<HomographyRefineResult> results, const HomographyRefineOptions& options = {},
+        JobSystem* pool = nullptr) {
+        if (problems.size() != results.size()) {
+            throw std::invalid_argument("Refinement batch size mismatch");
+        }
+        JobSystem& workers = pool ? *pool : getDefaultJobSystem();
+        workers.parallelFor(problems.size(), [&](std::size_t i) {
+            const HomographyRefineProblem& problem = problems[i];
+            results[i] = refineHomography<V>(problem.src, problem.dst, problem.initial, options);
+        });
+    }
+
+} // namespace gl
+
+#endif // GL_REFINE_HPP
@@ -0,0 +1,356 @@
+#ifndef GL_REMAP_HPP
+#define GL_REMAP_HPP
+
+#include "warp.hpp"
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gl {
+
+    // Precomputed destination-to-source lookup for one homography, output size
+    // and source size. Each destination pixel stores the index of its top-left
+    // source pixel plus 8-bit fixed-point bilinear weights and edge flags
+    // (8 bytes per pixel, kept structure-of-arrays for gathers), so applying
+    // the table to a new image needs no projective math at all.
+    class RemapTable {
+    public:
+        static constexpr std::uint32_t OUTSIDE = 0xFFFFFFFFu;
+
+        RemapTable(const glm::mat3& H, int dstWidth, int dstHeight, int srcWidth, int srcHeight,
+            WarpFilter filter, JobSystem& pool)
+            : dstWidth_(dstWidth), dstHeight_(dstHeight),
+            srcWidth_(srcWidth), srcHeight_(srcHeight), filter_(filter) {
+            const std::size_t count = static_cast<std::size_t>(dstWidth) * dstHeight;
+            offsets_.resize(count);
+            weights_.resize(count);
+
+            const detail::WarpMapping mapping(H);
+            pool.parallelFor(static_cast<std::size_t>(dstHeight), [&](std::size_t row) {
+                alignas(64) float us[detail::WARP_MAX_SPAN];
+                alignas(64) float vs[detail::WARP_MAX_SPAN];
+                const int y = static_cast<int>(row);
+                for (int x0 = 0; x0 < dstWidth; x0 += detail::WARP_MAX_SPAN) {
+                    const int count = std::min(detail::WARP_MAX_SPAN, dstWidth - x0);
+                    detail::rowCoordinatesPerPixel(mapping, y, x0, count, us, vs, true);
+                    const std::size_t base = row * dstWidth + x0;
+                    for (int i = 0; i < count; ++i) {
+                        encode(us[i], vs[i], offsets_[base + i], weights_[base + i]);
+                    }
+                }
+            });
+        }
+
+        // Resample src through the table into dst (sizes must match the table)
+        void apply(const Image& src, Image& dst, const WarpOptions& options = {}) const {
+            if (src.getWidth() != srcWidth_ || src.getHeight() != srcHeight_ ||
+                dst.getWidth() != dstWidth_ || dst.getHeight() != dstHeight_ ||
+                src.getChannels() != dst.getChannels()) {
+                throw std::invalid_argument("RemapTable::apply image sizes don't match the table");
+            }
+
+            JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+            const int rowsPerTask = std::max(1, options.tileSize / 4);
+            const int tasks = (dstHeight_ + rowsPerTask - 1) / rowsPerTask;
+
+            pool.parallelFor(static_cast<std::size_t>(tasks), [&](std::size_t task) {
+                const int y0 = static_cast<int>(task) * rowsPerTask;
+                const int y1 = std::min(y0 + rowsPerTask, dstHeight_);
+                for (int y = y0; y < y1; ++y) {
+                    const std::size_t base = static_cast<std::size_t>(y) * dstWidth_;
+                    applySpan(src, base, dstWidth_, dst.getRow(y), options);
+                }
+            });
+        }
+
+        int getDstWidth() const { return dstWidth_; }
+        int getDstHeight() const { return dstHeight_; }
+        WarpFilter getFilter() const { return filter_; }
+
+        std::size_t getMemoryUsage() const {
+            return sizeof(*this) + offsets_.capacity() * sizeof(std::uint32_t) +
+                weights_.capacity() * sizeof(std::uint32_t);
+        }
+
+    private:
+        // weights layout: bits 0-7 wx, 8-15 wy, 16 has right neighbour, 17 has lower neighbour
+        void encode(float u, float v, std::uint32_t& offset, std::uint32_t& weight) const {
+            if (filter_ == WarpFilter::Nearest) {
+                bool inside = u >= -0.5f && v >= -0.5f && u < srcWidth_ - 0.5f && v < srcHeight_ - 0.5f;
+                offset = inside ? static_cast<std::uint32_t>(static_cast<int>(v + 0.5f) * srcWidth_ +
+                    static_cast<int>(u + 0.5f)) : OUTSIDE;
+                weight = 0;
+                return;
+            }
+
+            if (!(u >= 0.0f && v >= 0.0f && u <= srcWidth_ - 1.0f && v <= srcHeight_ - 1.0f)) {
+                offset = OUTSIDE;
+                weight = 0;
+                return;
+            }
+
+            int sx = static_cast<int>(u);
+            int sy = static_cast<int>(v);
+            std::uint32_t wx = static_cast<std::uint32_t>(std::min(255.0f, (u - sx) * 256.0f + 0.5f));
+            std::uint32_t wy = static_cast<std::uint32_t>(std::min(255.0f, (v - sy) * 256.0f + 0.5f));
+            std::uint32_t right = sx + 1 < srcWidth_ ? 1u : 0u;
+            std::uint32_t down = sy + 1 < srcHeight_ ? 1u : 0u;
+            offset = static_cast<std::uint32_t>(sy * srcWidth_ + sx);
+            weight = wx | (wy << 8) | (right << 16) | (down << 17);
+        }
+
+        void applySpan(const Image& src, std::size_t base, int count, std::uint8_t* out,
+            const WarpOptions& options) const {
+            int i = 0;
+#ifdef __AVX2__
+            if (options.vectorize && src.getChannels() == 4) {
+                i = applySpanAVX2(src, base, count, out, options);
+            }
+#endif
+            const int channels = src.getChannels();
+            const std::uint8_t* pixels = src.getData();
+            for (; i < count; ++i) {
+                std::uint8_t* o = out + static_cast<std::size_t>(i) * channels;
+                const std::uint32_t offset = offsets_[base + i];
+                if (offset == OUTSIDE) {
+                    std::memcpy(o, options.borderColor, channels);
+                    continue;
+                }
+
+                const std::uint32_t weight = weights_[base + i];
+                const std::uint8_t* p00 = pixels + static_cast<std::size_t>(offset) * channels;
+                if (filter_ == WarpFilter::Nearest) {
+                    std::memcpy(o, p00, channels);
+                    continue;
+                }
+
+                const std::uint32_t wx = weight & 0xFF;
+                const std::uint32_t wy = (weight >> 8) & 0xFF;
+                const std::uint8_t* p01 = p00 + ((weight >> 16) & 1u) * channels;
+                const std::size_t down = ((weight >> 17) & 1u) * src.getStride();
+                const std::uint8_t* p10 = p00 + down;
+                const std::uint8_t* p11 = p01 + down;
+                for (int c = 0; c < channels; ++c) {
+                    std::uint32_t top = p00[c] * (256 - wx) + p01[c] * wx;
+                    std::uint32_t bottom = p10[c] * (256 - wx) + p11[c] * wx;
+                    o[c] = static_cast<std::uint8_t>((top * (256 - wy) + bottom * wy + 32768) >> 16);
+                }
+            }
+        }
+
+#ifdef __AVX2__
+        // Eight RGBA pixels per iteration; returns the number of pixels written
+        int applySpanAVX2(const Image& src, std::size_t base, int count, std::uint8_t* out,
+            const WarpOptions& options) const {
+            const int* pixels = reinterpret_cast<const int*>(src.getData());
+            std::uint32_t borderBits;
+            std::memcpy(&borderBits, options.borderColor, 4);
+            const __m256i border = _mm256_set1_epi32(static_cast<int>(borderBits));
+            const __m256i outside = _mm256_set1_epi32(-1);
+            const __m256i byteMask = _mm256_set1_epi32(0xFF);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i full = _mm256_set1_epi32(256);
+            const __m256i stride = _mm256_set1_epi32(srcWidth_);
+            const __m256i round = _mm256_set1_epi32(32768);
+            const bool nearest = filter_ == WarpFilter::Nearest;
+
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i offset = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets_.data() + base + i));
+                __m256i mask = _mm256_xor_si256(_mm256_cmpeq_epi32(offset, outside), outside);
+                __m256i* dst = reinterpret_cast<__m256i*>(out + static_cast<std::size_t>(i) * 4);
+                __m256i p00 = _mm256_mask_i32gather_epi32(border, pixels, offset, mask, 4);
+                if (nearest) {
+                    _mm256_storeu_si256(dst, p00);
+                    continue;
+                }
+
+                __m256i weight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_.data() + base + i));
+                __m256i wx = _mm256_and_si256(weight, byteMask);
+                __m256i wy = _mm256_and_si256(_mm256_srli_epi32(weight, 8), byteMask);
+                __m256i right = _mm256_and_si256(_mm256_srli_epi32(weight, 16), one);
+                __m256i down = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(weight, 17), one), stride);
+                __m256i p01 = _mm256_mask_i32gather_epi32(border, pixels, _mm256_add_epi32(offset, right), mask, 4);
+                __m256i p10 = _mm256_mask_i32gather_epi32(border, pixels, _mm256_add_epi32(offset, down), mask, 4);
+                __m256i p11 = _mm256_mask_i32gather_epi32(border, pixels,
+                    _mm256_add_epi32(offset, _mm256_add_epi32(right, down)), mask, 4);
+                __m256i ix = _mm256_sub_epi32(full, wx);
+                __m256i iy = _mm256_sub_epi32(full, wy);
+
+                __m256i result = _mm256_setzero_si256();
+                for (int c = 0; c < 4; ++c) {
+                    auto channel = [&](__m256i p) {
+                        return _mm256_and_si256(_mm256_srli_epi32(p, c * 8), byteMask);
+                    };
+                    __m256i top = _mm256_add_epi32(_mm256_mullo_epi32(channel(p00), ix),
+                        _mm256_mullo_epi32(channel(p01), wx));
+                    __m256i bottom = _mm256_add_epi32(_mm256_mullo_epi32(channel(p10), ix),
+                        _mm256_mullo_epi32(channel(p11), wx));
+                    __m256i value = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(top, iy),
+                        _mm256_mullo_epi32(bottom, wy)), round);
+                    result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_srli_epi32(value, 16), c * 8));
+                }
+
+                _mm256_storeu_si256(dst, _mm256_blendv_epi8(border, result, mask));
+            }
+            return i;
+        }
+#endif
+
+        int dstWidth_;
+        int dstHeight_;
+        int srcWidth_;
+        int srcHeight_;
+        WarpFilter filter_;
+        std::vector<std::uint32_t> offsets_;
+        std::vector<std::uint32_t> weights_;
+    };
+
+    struct RemapCacheStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::size_t entries = 0;
+        std::size_t bytesUsed = 0;
+        std::size_t byteBudget = 0;
+    };
+
+    // LRU cache of remap tables bounded by total memory. Tables are handed out
+    // as shared pointers, so evicting one never invalidates a warp in flight.
+    // A table larger than the whole budget is built and returned but not kept.
+    class RemapCache {
+    public:
+        static constexpr std::size_t DEFAULT_BUDGET = 64u << 20;
+
+        explicit RemapCache(std::size_t byteBudget = DEFAULT_BUDGET)
+            : byteBudget_(byteBudget) {}
+
+        std::shared_ptr<const RemapTable> get(const glm::mat3& H, int dstWidth, int dstHeight,
+            int srcWidth, int srcHeight, WarpFilter filter, JobSystem& pool) {
+            Key key = makeKey(H, dstWidth, dstHeight, srcWidth, srcHeight, filter);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = index_.find(key);
+                if (it != index_.end()) {
+                    ++hits_;
+                    lru_.splice(lru_.begin(), lru_, it->second);
+                    return it->second->table;
+                }
+                ++misses_;
+            }
+
+            // Build outside the lock so other lookups aren't blocked
+            auto table = std::make_shared<const RemapTable>(H, dstWidth, dstHeight, srcWidth, srcHeight, filter, pool);
+            const std::size_t bytes = table->getMemoryUsage();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (bytes > byteBudget_ || index_.count(key)) {
+                return table;
+            }
+            lru_.push_front({ key, table, bytes });
+            index_.emplace(key, lru_.begin());
+            bytesUsed_ += bytes;
+            evictToBudget();
+            return table;
+        }
+
+        // Change the budget, evicting least recently used tables to fit
+        void setByteBudget(std::size_t byteBudget) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            byteBudget_ = byteBudget;
+            evictToBudget();
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lru_.clear();
+            index_.clear();
+            bytesUsed_ = 0;
+        }
+
+        RemapCacheStats getStats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return { hits_, misses_, evictions_, lru_.size(), bytesUsed_, byteBudget_ };
+        }
+
+    private:
+        struct Key {
+            std::uint32_t bits[9];
+            int dstWidth, dstHeight, srcWidth, srcHeight;
+            WarpFilter filter;
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const {
+                std::uint64_t h = 1469598103934665603ull;
+                auto mix = [&h](std::uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+                for (std::uint32_t b : key.bits) mix(b);
+                mix(static_cast<std::uint64_t>(key.dstWidth) << 32 | static_cast<std::uint32_t>(key.dstHeight));
+                mix(static_cast<std::uint64_t>(key.srcWidth) << 32 | static_cast<std::uint32_t>(key.srcHeight));
+                mix(static_cast<std::uint64_t>(key.filter));
+                return static_cast<std::size_t>(h);
+            }
+        };
+
+        struct Entry {
+            Key key;
+            std::shared_ptr<const RemapTable> table;
+            std::size_t bytes;
+        };
+
+        static Key makeKey(const glm::mat3& H, int dstWidth, int dstHeight,
+            int srcWidth, int srcHeight, WarpFilter filter) {
+            Key key{};
+            for (int c = 0; c < 3; ++c) {
+                for (int r = 0; r < 3; ++r) {
+                    std::memcpy(&key.bits[c * 3 + r], &H[c][r], sizeof(float));
+                }
+            }
+            key.dstWidth = dstWidth;
+            key.dstHeight = dstHeight;
+            key.srcWidth = srcWidth;
+            key.srcHeight = srcHeight;
+            key.filter = filter;
+            return key;
+        }
+
+        void evictToBudget() {
+            while (bytesUsed_ > byteBudget_ && !lru_.empty()) {
+                bytesUsed_ -= lru_.back().bytes;
+                index_.erase(lru_.back().key);
+                lru_.pop_back();
+                ++evictions_;
+            }
+        }
+
+        mutable std::mutex mutex_;
+        std::list<Entry> lru_;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+        std::size_t byteBudget_;
+        std::size_t bytesUsed_ = 0;
+        std::uint64_t hits_ = 0;
+        std::uint64_t misses_ = 0;
+        std::uint64_t evictions_ = 0;
+    };
+
+    // warpPerspective through a cached remap table: the first call for a given
+    // H / size / filter builds the table, later calls only gather
+    inline void warpPerspectiveCached(const Image& src, const glm::mat3& H, Image& dst,
+        RemapCache& cache, const WarpOptions& options = {}) {
+        if (src.empty() || dst.empty()) {
+            throw std::invalid_argument("warpPerspectiveCached requires non-empty images");
+        }
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+        auto table = cache.get(H, dst.getWidth(), dst.getHeight(), src.getWidth(), src.getHeight(),
+            options.filter, pool);
+        table->apply(src, dst, options);
+    }
+
+} // namespace gl
+
+#endif // GL_REMAP_HPP
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <unordered_map>
 #include <filesystem>
+#include <initializer_list>
 
 namespace gl {
 
@@ -42,6 +43,26 @@ namespace gl {
             }
         }
 
+        // Compute program from a .comp file
+        explicit Shader(const char* computePath)
+            : Shader(fromComputeSource(readFile(computePath))) {
+        }
+
+        // Compute program from GLSL source held in memory
+        static Shader fromComputeSource(const std::string& source) {
+            Shader shader;
+            GLuint compute = compileShader(GL_COMPUTE_SHADER, source);
+            try {
+                shader.ID = linkProgram({ compute });
+            }
+            catch (const std::exception&) {
+                glDeleteShader(compute);
+                throw;
+            }
+            glDeleteShader(compute);
+            return shader;
+        }
+
         ~Shader() {
             if (ID != 0) {
                 glDeleteProgram(ID);
@@ -73,6 +94,11 @@ namespace gl {
             glUseProgram(ID);
         }
 
+        // Launch the bound compute program (call use() first)
+        void dispatch(GLuint groupsX, GLuint groupsY = 1, GLuint groupsZ = 1) const {
+            glDispatchCompute(groupsX, groupsY, groupsZ);
+        }
+
         // Utility uniform functions
         void setBool(const std::string& name, bool value) const {
             glUniform1i(getUniformLocation(name), static_cast<int>(value));
@@ -82,6 +108,10 @@ namespace gl {
             glUniform1i(getUniformLocation(name), value);
         }
 
+        void setUint(const std::string& name, unsigned int value) const {
+            glUniform1ui(getUniformLocation(name), value);
+        }
+
         void setFloat(const std::string& name, float value) const {
             glUniform1f(getUniformLocation(name), value);
         }
@@ -115,7 +145,9 @@ namespace gl {
         GLuint ID = 0;
         mutable std::unordered_map<std::string, GLint> uniformLocationCache;
 
-        std::string readFile(const char* filePath) {
+        Shader() = default;
+
+        static std::string readFile(const char* filePath) {
             namespace fs = std::filesystem;
             if (!fs::exists(filePath)) {
                 gl::throwShaderError(gl::ShaderErrorCode::FILE_NOT_FOUND, std::string(filePath) + " does not exist.");
@@ -130,7 +162,7 @@ namespace gl {
             return stream.str();
         }
 
-        GLuint compileShader(GLenum type, const std::string& source) {
+        static GLuint compileShader(GLenum type, const std::string& source) {
             const char* shaderCode = source.c_str();
             GLuint shader = glCreateShader(type);
 
@@ -171,10 +203,15 @@ namespace gl {
             return shader;
         }
 
-        GLuint createAndLinkProgram(GLuint vertexShader, GLuint fragmentShader) {
+        static GLuint createAndLinkProgram(GLuint vertexShader, GLuint fragmentShader) {
+            return linkProgram({ vertexShader, fragmentShader });
+        }
+
+        static GLuint linkProgram(std::initializer_list<GLuint> shaders) {
             GLuint program = glCreateProgram();
-            glAttachShader(program, vertexShader);
-            glAttachShader(program, fragmentShader);
+            for (GLuint shader : shaders) {
+                glAttachShader(program, shader);
+            }
             glLinkProgram(program);
 
             GLint success;
@@ -0,0 +1,445 @@
+#ifndef GL_SIMD_HPP
+#define GL_SIMD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GL_SIMD_SSE2 1
+#include <immintrin.h>
+#endif
+
+namespace gl::simd {
+
+    // Thin wrappers that give every instruction set the same small interface,
+    // so batched kernels can be written once as templates over the lane type.
+    // Each type exposes Width, a Mask type, load/store/broadcast and the
+    // arithmetic, comparison and select operations used by the solvers.
+
+    // Scalar fallback (one lane)
+    struct FloatX1 {
+        static constexpr int Width = 1;
+        using Mask = bool;
+
+        float v;
+
+        FloatX1() = default;
+        FloatX1(float value) : v(value) {}
+
+        static FloatX1 load(const float* p) { return FloatX1(*p); }
+        void store(float* p) const { *p = v; }
+
+        friend FloatX1 operator+(FloatX1 a, FloatX1 b) { return a.v + b.v; }
+        friend FloatX1 operator-(FloatX1 a, FloatX1 b) { return a.v - b.v; }
+        friend FloatX1 operator*(FloatX1 a, FloatX1 b) { return a.v * b.v; }
+        friend FloatX1 operator/(FloatX1 a, FloatX1 b) { return a.v / b.v; }
+        friend FloatX1 operator-(FloatX1 a) { return -a.v; }
+
+        friend Mask operator<(FloatX1 a, FloatX1 b) { return a.v < b.v; }
+        friend Mask operator>(FloatX1 a, FloatX1 b) { return a.v > b.v; }
+        friend Mask operator<=(FloatX1 a, FloatX1 b) { return a.v <= b.v; }
+        friend Mask operator==(FloatX1 a, FloatX1 b) { return a.v == b.v; }
+    };
+
+    inline FloatX1 abs(FloatX1 a) { return std::abs(a.v); }
+    inline FloatX1 min(FloatX1 a, FloatX1 b) { return a.v < b.v ? a : b; }
+    inline FloatX1 max(FloatX1 a, FloatX1 b) { return a.v > b.v ? a : b; }
+    inline FloatX1 fmadd(FloatX1 a, FloatX1 b, FloatX1 c) { return a.v * b.v + c.v; }
+    inline FloatX1 select(bool m, FloatX1 a, FloatX1 b) { return m ? a : b; }
+    inline bool maskOr(bool a, bool b) { return a || b; }
+    inline bool maskAnd(bool a, bool b) { return a && b; }
+    inline bool maskNot(bool a) { return !a; }
+    inline bool any(bool m) { return m; }
+    inline unsigned maskBits(bool m) { return m ? 1u : 0u; }
+
+#ifdef GL_SIMD_SSE2
+    // SSE2 (four lanes)
+    struct FloatX4 {
+        static constexpr int Width = 4;
+        struct Mask { __m128 m; };
+
+        __m128 v;
+
+        FloatX4() = default;
+        FloatX4(__m128 value) : v(value) {}
+        FloatX4(float value) : v(_mm_set1_ps(value)) {}
+
+        static FloatX4 load(const float* p) { return _mm_loadu_ps(p); }
+        void store(float* p) const { _mm_storeu_ps(p, v); }
+
+        friend FloatX4 operator+(FloatX4 a, FloatX4 b) { return _mm_add_ps(a.v, b.v); }
+        friend FloatX4 operator-(FloatX4 a, FloatX4 b) { return _mm_sub_ps(a.v, b.v); }
+        friend FloatX4 operator*(FloatX4 a, FloatX4 b) { return _mm_mul_ps(a.v, b.v); }
+        friend FloatX4 operator/(FloatX4 a, FloatX4 b) { return _mm_div_ps(a.v, b.v); }
+        friend FloatX4 operator-(FloatX4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+        friend Mask operator<(FloatX4 a, FloatX4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+        friend Mask operator>(FloatX4 a, FloatX4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+        friend Mask operator<=(FloatX4 a, FloatX4 b) { return { _mm_cmple_ps(a.v, b.v) }; }
+        friend Mask operator==(FloatX4 a, FloatX4 b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+    };
+
+    inline FloatX4 abs(FloatX4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+    inline FloatX4 min(FloatX4 a, FloatX4 b) { return _mm_min_ps(a.v, b.v); }
+    inline FloatX4 max(FloatX4 a, FloatX4 b) { return _mm_max_ps(a.v, b.v); }
+    inline FloatX4 fmadd(FloatX4 a, FloatX4 b, FloatX4 c) {
+#ifdef __FMA__
+        return _mm_fmadd_ps(a.v, b.v, c.v);
+#else
+        return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+    }
+    inline FloatX4 select(FloatX4::Mask m, FloatX4 a, FloatX4 b) {
+        return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v));
+    }
+    inline FloatX4::Mask maskOr(FloatX4::Mask a, FloatX4::Mask b) { return { _mm_or_ps(a.m, b.m) }; }
+    inline FloatX4::Mask maskAnd(FloatX4::Mask a, FloatX4::Mask b) { return { _mm_and_ps(a.m, b.m) }; }
+    inline FloatX4::Mask maskNot(FloatX4::Mask a) {
+        return { _mm_xor_ps(a.m, _mm_castsi128_ps(_mm_set1_epi32(-1))) };
+    }
+    inline unsigned maskBits(FloatX4::Mask m) { return static_cast<unsigned>(_mm_movemask_ps(m.m)); }
+    inline bool any(FloatX4::Mask m) { return maskBits(m) != 0; }
+#endif
+
+#ifdef __AVX2__
+    // AVX2 (eight lanes)
+    struct FloatX8 {
+        static constexpr int Width = 8;
+        struct Mask { __m256 m; };
+
+        __m256 v;
+
+        FloatX8() = default;
+        FloatX8(__m256 value) : v(value) {}
+        FloatX8(float value) : v(_mm256_set1_ps(value)) {}
+
+        static FloatX8 load(const float* p) { return _mm256_loadu_ps(p); }
+        void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+        friend FloatX8 operator+(FloatX8 a, FloatX8 b) { return _mm256_add_ps(a.v, b.v); }
+        friend FloatX8 operator-(FloatX8 a, FloatX8 b) { return _mm256_sub_ps(a.v, b.v); }
+        friend FloatX8 operator*(FloatX8 a, FloatX8 b) { return _mm256_mul_ps(a.v, b.v); }
+        friend FloatX8 operator/(FloatX8 a, FloatX8 b) { return _mm256_div_ps(a.v, b.v); }
+        friend FloatX8 operator-(FloatX8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+        friend Mask operator<(FloatX8 a, FloatX8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Mask operator>(FloatX8 a, FloatX8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask operator<=(FloatX8 a, FloatX8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+        friend Mask operator==(FloatX8 a, FloatX8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+    };
+
+    inline FloatX8 abs(FloatX8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+    inline FloatX8 min(FloatX8 a, FloatX8 b) { return _mm256_min_ps(a.v, b.v); }
+    inline FloatX8 max(FloatX8 a, FloatX8 b) { return _mm256_max_ps(a.v, b.v); }
+    inline FloatX8 fmadd(FloatX8 a, FloatX8 b, FloatX8 c) {
+#ifdef __FMA__
+        return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+    }
+    inline FloatX8 select(FloatX8::Mask m, FloatX8 a, FloatX8 b) { return _mm256_blendv_ps(b.v, a.v, m.m); }
+    inline FloatX8::Mask maskOr(FloatX8::Mask a, FloatX8::Mask b) { return { _mm256_or_ps(a.m, b.m) }; }
+    inline FloatX8::Mask maskAnd(FloatX8::Mask a, FloatX8::Mask b) { return { _mm256_and_ps(a.m, b.m) }; }
+    inline FloatX8::Mask maskNot(FloatX8::Mask a) {
+        return { _mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1))) };
+    }
+    inline unsigned maskBits(FloatX8::Mask m) { return static_cast<unsigned>(_mm256_movemask_ps(m.m)); }
+    inline bool any(FloatX8::Mask m) { return maskBits(m) != 0; }
+#endif
+
+#ifdef __AVX512F__
+    // AVX-512 (sixteen lanes)
+    struct FloatX16 {
+        static constexpr int Width = 16;
+        struct Mask { __mmask16 m; };
+
+        __m512 v;
+
+        FloatX16() = default;
+        FloatX16(__m512 value) : v(value) {}
+        FloatX16(float value) : v(_mm512_set1_ps(value)) {}
+
+        static FloatX16 load(const float* p) { return _mm512_loadu_ps(p); }
+        void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+        friend FloatX16 operator+(FloatX16 a, FloatX16 b) { return _mm512_add_ps(a.v, b.v); }
+        friend FloatX16 operator-(FloatX16 a, FloatX16 b) { return _mm512_sub_ps(a.v, b.v); }
+        friend FloatX16 operator*(FloatX16 a, FloatX16 b) { return _mm512_mul_ps(a.v, b.v); }
+        friend FloatX16 operator/(FloatX16 a, FloatX16 b) { return _mm512_div_ps(a.v, b.v); }
+        friend FloatX16 operator-(FloatX16 a) { return _mm512_sub_ps(_mm512_setzero_ps(), a.v); }
+
+        friend Mask operator<(FloatX16 a, FloatX16 b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Mask operator>(FloatX16 a, FloatX16 b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask operator<=(FloatX16 a, FloatX16 b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ) }; }
+        friend Mask operator==(FloatX16 a, FloatX16 b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+    };
+
+    inline FloatX16 abs(FloatX16 a) { return _mm512_abs_ps(a.v); }
+    inline FloatX16 min(FloatX16 a, FloatX16 b) { return _mm512_min_ps(a.v, b.v); }
+    inline FloatX16 max(FloatX16 a, FloatX16 b) { return _mm512_max_ps(a.v, b.v); }
+    inline FloatX16 fmadd(FloatX16 a, FloatX16 b, FloatX16 c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+    inline FloatX16 select(FloatX16::Mask m, FloatX16 a, FloatX16 b) { return _mm512_mask_blend_ps(m.m, b.v, a.v); }
+    inline FloatX16::Mask maskOr(FloatX16::Mask a, FloatX16::Mask b) { return { static_cast<__mmask16>(a.m | b.m) }; }
+    inline FloatX16::Mask maskAnd(FloatX16::Mask a, FloatX16::Mask b) { return { static_cast<__mmask16>(a.m & b.m) }; }
+    inline FloatX16::Mask maskNot(FloatX16::Mask a) { return { static_cast<__mmask16>(~a.m) }; }
+    inline unsigned maskBits(FloatX16::Mask m) { return static_cast<unsigned>(m.m); }
+    inline bool any(FloatX16::Mask m) { return m.m != 0; }
+#endif
+
+    // Reciprocal from the hardware estimate refined by one Newton-Raphson step
+    // (about 22 correct bits, cheaper than a divide)
+    inline float fastReciprocal(float x) {
+#ifdef GL_SIMD_SSE2
+        __m128 v = _mm_set_ss(x);
+        __m128 r = _mm_rcp_ss(v);
+        r = _mm_mul_ss(r, _mm_sub_ss(_mm_set_ss(2.0f), _mm_mul_ss(v, r)));
+        return _mm_cvtss_f32(r);
+#else
+        return 1.0f / x;
+#endif
+    }
+
+    inline FloatX1 fastReciprocal(FloatX1 x) { return fastReciprocal(x.v); }
+
+#ifdef GL_SIMD_SSE2
+    inline FloatX4 fastReciprocal(FloatX4 x) {
+        FloatX4 r = _mm_rcp_ps(x.v);
+        return r * (FloatX4(2.0f) - x * r);
+    }
+#endif
+
+#ifdef __AVX2__
+    inline FloatX8 fastReciprocal(FloatX8 x) {
+        FloatX8 r = _mm256_rcp_ps(x.v);
+        return r * (FloatX8(2.0f) - x * r);
+    }
+#endif
+
+#ifdef __AVX512F__
+    inline FloatX16 fastReciprocal(FloatX16 x) {
+        FloatX16 r = _mm512_rcp14_ps(x.v);
+        return r * (FloatX16(2.0f) - x * r);
+    }
+#endif
+
+    // Horizontal sum of all lanes
+    inline float reduceAdd(FloatX1 a) { return a.v; }
+
+#ifdef GL_SIMD_SSE2
+    inline float reduceAdd(FloatX4 a) {
+        __m128 pairs = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    }
+#endif
+
+#ifdef __AVX2__
+    inline float reduceAdd(FloatX8 a) {
+        return reduceAdd(FloatX4(_mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1))));
+    }
+#endif
+
+#ifdef __AVX512F__
+    // Add the two halves, then reduce as FloatX8. _mm512_reduce_add_ps and
+    // the unmasked extracts start from undefined vectors, which GCC 12
+    // reports as uninitialized reads; the zero-masked extracts don't
+    inline float reduceAdd(FloatX16 a) {
+        const __m512d bits = _mm512_castps_pd(a.v);
+        const __m256 low = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, bits, 0));
+        const __m256 high = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, bits, 1));
+        return reduceAdd(FloatX8(_mm256_add_ps(low, high)));
+    }
+#endif
+
+    // Copy each even lane into the odd lane above it (duplicateEven) or each
+    // odd lane into the even lane below it (duplicateOdd). With interleaved
+    // (x, y) pairs these broadcast x or y across a pair without a transpose.
+#ifdef GL_SIMD_SSE2
+    inline FloatX4 duplicateEven(FloatX4 a) { return _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 2, 0, 0)); }
+    inline FloatX4 duplicateOdd(FloatX4 a) { return _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 3, 1, 1)); }
+#endif
+
+#ifdef __AVX2__
+    inline FloatX8 duplicateEven(FloatX8 a) { return _mm256_moveldup_ps(a.v); }
+    inline FloatX8 duplicateOdd(FloatX8 a) { return _mm256_movehdup_ps(a.v); }
+#endif
+
+#ifdef __AVX512F__
+    inline FloatX16 duplicateEven(FloatX16 a) { return _mm512_moveldup_ps(a.v); }
+    inline FloatX16 duplicateOdd(FloatX16 a) { return _mm512_movehdup_ps(a.v); }
+#endif
+
+    // Correctly rounded square root
+    inline FloatX1 sqrt(FloatX1 a) { return std::sqrt(a.v); }
+
+#ifdef GL_SIMD_SSE2
+    inline FloatX4 sqrt(FloatX4 a) { return _mm_sqrt_ps(a.v); }
+#endif
+
+#ifdef __AVX2__
+    inline FloatX8 sqrt(FloatX8 a) { return _mm256_sqrt_ps(a.v); }
+#endif
+
+#ifdef __AVX512F__
+    inline FloatX16 sqrt(FloatX16 a) { return _mm512_sqrt_ps(a.v); }
+#endif
+
+    // Unsigned 8-bit lanes for image kernels. Comparisons return lanes of
+    // all ones or zeros so results combine with the bitwise operators;
+    // addSaturate/subSaturate clamp to [0, 255].
+
+    struct ByteX1 {
+        static constexpr int Width = 1;
+
+        std::uint8_t v;
+
+        ByteX1() = default;
+        ByteX1(std::uint8_t value) : v(value) {}
+
+        static ByteX1 load(const std::uint8_t* p) { return ByteX1(*p); }
+        void store(std::uint8_t* p) const { *p = v; }
+
+        friend ByteX1 operator&(ByteX1 a, ByteX1 b) { return std::uint8_t(a.v & b.v); }
+        friend ByteX1 operator|(ByteX1 a, ByteX1 b) { return std::uint8_t(a.v | b.v); }
+        friend ByteX1 operator>(ByteX1 a, ByteX1 b) { return std::uint8_t(a.v > b.v ? 0xFF : 0); }
+        friend ByteX1 operator<(ByteX1 a, ByteX1 b) { return std::uint8_t(a.v < b.v ? 0xFF : 0); }
+    };
+
+    inline ByteX1 addSaturate(ByteX1 a, ByteX1 b) { return std::uint8_t(std::min(a.v + b.v, 255)); }
+    inline ByteX1 subSaturate(ByteX1 a, ByteX1 b) { return std::uint8_t(std::max(a.v - b.v, 0)); }
+    inline ByteX1 max(ByteX1 a, ByteX1 b) { return a.v > b.v ? a : b; }
+    // a + 1 where mask is set, 0 elsewhere (run-length counting)
+    inline ByteX1 countRun(ByteX1 a, ByteX1 mask) { return std::uint8_t((a.v + 1) & mask.v); }
+    // Bit i set where lane i is nonzero
+    inline std::uint64_t nonzeroBits(ByteX1 a) { return a.v != 0 ? 1u : 0u; }
+
+#ifdef GL_SIMD_SSE2
+    struct ByteX16 {
+        static constexpr int Width = 16;
+
+        __m128i v;
+
+        ByteX16() = default;
+        ByteX16(__m128i value) : v(value) {}
+        ByteX16(std::uint8_t value) : v(_mm_set1_epi8(static_cast<char>(value))) {}
+
+        static ByteX16 load(const std::uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        void store(std::uint8_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+        friend ByteX16 operator&(ByteX16 a, ByteX16 b) { return _mm_and_si128(a.v, b.v); }
+        friend ByteX16 operator|(ByteX16 a, ByteX16 b) { return _mm_or_si128(a.v, b.v); }
+        // Unsigned compare through the signed one with the sign bits flipped
+        friend ByteX16 operator>(ByteX16 a, ByteX16 b) {
+            const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+            return _mm_cmpgt_epi8(_mm_xor_si128(a.v, bias), _mm_xor_si128(b.v, bias));
+        }
+        friend ByteX16 operator<(ByteX16 a, ByteX16 b) { return b > a; }
+    };
+
+    inline ByteX16 addSaturate(ByteX16 a, ByteX16 b) { return _mm_adds_epu8(a.v, b.v); }
+    inline ByteX16 subSaturate(ByteX16 a, ByteX16 b) { return _mm_subs_epu8(a.v, b.v); }
+    inline ByteX16 max(ByteX16 a, ByteX16 b) { return _mm_max_epu8(a.v, b.v); }
+    inline ByteX16 countRun(ByteX16 a, ByteX16 mask) { return _mm_and_si128(_mm_sub_epi8(a.v, mask.v), mask.v); }
+    inline std::uint64_t nonzeroBits(ByteX16 a) {
+        const __m128i zero = _mm_cmpeq_epi8(a.v, _mm_setzero_si128());
+        return static_cast<std::uint16_t>(~_mm_movemask_epi8(zero));
+    }
+#endif
+
+#ifdef __AVX2__
+    struct ByteX32 {
+        static constexpr int Width = 32;
+
+        __m256i v;
+
+        ByteX32() = default;
+        ByteX32(__m256i value) : v(value) {}
+        ByteX32(std::uint8_t value) : v(_mm256_set1_epi8(static_cast<char>(value))) {}
+
+        static ByteX32 load(const std::uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        void store(std::uint8_t* p) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+        friend ByteX32 operator&(ByteX32 a, ByteX32 b) { return _mm256_and_si256(a.v, b.v); }
+        friend ByteX32 operator|(ByteX32 a, ByteX32 b) { return _mm256_or_si256(a.v, b.v); }
+        friend ByteX32 operator>(ByteX32 a, ByteX32 b) {
+            const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+            return _mm256_cmpgt_epi8(_mm256_xor_si256(a.v, bias), _mm256_xor_si256(b.v, bias));
+        }
+        friend ByteX32 operator<(ByteX32 a, ByteX32 b) { return b > a; }
+    };
+
+    inline ByteX32 addSaturate(ByteX32 a, ByteX32 b) { return _mm256_adds_epu8(a.v, b.v); }
+    inline ByteX32 subSaturate(ByteX32 a, ByteX32 b) { return _mm256_subs_epu8(a.v, b.v); }
+    inline ByteX32 max(ByteX32 a, ByteX32 b) { return _mm256_max_epu8(a.v, b.v); }
+    inline ByteX32 countRun(ByteX32 a, ByteX32 mask) { return _mm256_and_si256(_mm256_sub_epi8(a.v, mask.v), mask.v); }
+    inline std::uint64_t nonzeroBits(ByteX32 a) {
+        const __m256i zero = _mm256_cmpeq_epi8(a.v, _mm256_setzero_si256());
+        return static_cast<std::uint32_t>(~_mm256_movemask_epi8(zero));
+    }
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    struct ByteX64 {
+        static constexpr int Width = 64;
+
+        __m512i v;
+
+        ByteX64() = default;
+        ByteX64(__m512i value) : v(value) {}
+        ByteX64(std::uint8_t value) : v(_mm512_set1_epi8(static_cast<char>(value))) {}
+
+        static ByteX64 load(const std::uint8_t* p) { return _mm512_loadu_si512(p); }
+        void store(std::uint8_t* p) const { _mm512_storeu_si512(p, v); }
+
+        friend ByteX64 operator&(ByteX64 a, ByteX64 b) { return _mm512_and_si512(a.v, b.v); }
+        friend ByteX64 operator|(ByteX64 a, ByteX64 b) { return _mm512_or_si512(a.v, b.v); }
+        friend ByteX64 operator>(ByteX64 a, ByteX64 b) { return _mm512_movm_epi8(_mm512_cmpgt_epu8_mask(a.v, b.v)); }
+        friend ByteX64 operator<(ByteX64 a, ByteX64 b) { return _mm512_movm_epi8(_mm512_cmplt_epu8_mask(a.v, b.v)); }
+    };
+
+    inline ByteX64 addSaturate(ByteX64 a, ByteX64 b) { return _mm512_adds_epu8(a.v, b.v); }
+    inline ByteX64 subSaturate(ByteX64 a, ByteX64 b) { return _mm512_subs_epu8(a.v, b.v); }
+    inline ByteX64 max(ByteX64 a, ByteX64 b) { return _mm512_max_epu8(a.v, b.v); }
+    inline ByteX64 countRun(ByteX64 a, ByteX64 mask) { return _mm512_and_si512(_mm512_sub_epi8(a.v, mask.v), mask.v); }
+    inline std::uint64_t nonzeroBits(ByteX64 a) { return _mm512_test_epi8_mask(a.v, a.v); }
+#endif
+
+    // Widest lane type available for the current compilation target
+#if defined(__AVX512F__)
+    using NativeFloat = FloatX16;
+#elif defined(__AVX2__)
+    using NativeFloat = FloatX8;
+#elif defined(GL_SIMD_SSE2)
+    using NativeFloat = FloatX4;
+#else
+    using NativeFloat = FloatX1;
+#endif
+
+    // Widest byte lane type for the current compilation target
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    using NativeBytes = ByteX64;
+#elif defined(__AVX2__)
+    using NativeBytes = ByteX32;
+#elif defined(GL_SIMD_SSE2)
+    using NativeBytes = ByteX16;
+#else
+    using NativeBytes = ByteX1;
+#endif
+
+    // Name of the instruction set used by NativeFloat (for logs and benchmarks)
+    inline const char* nativeInstructionSet() {
+#if defined(__AVX512F__)
+        return "AVX-512";
+#elif defined(__AVX2__)
+        return "AVX2";
+#elif defined(GL_SIMD_SSE2)
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+} // namespace gl::simd
+
+#endif // GL_SIMD_HPP
@@ -144,6 +144,37 @@ namespace gl {
             return true;
         }
 
+        // Allocate immutable 2D storage with a single level (required for image load/store)
+        void allocate(int width, int height, GLenum internalFormat = GL_RGBA8) {
+            if (type_ != TextureType::Texture2D) {
+                throw GLException("Storage allocation only supported for Texture2D");
+            }
+            width_ = width;
+            height_ = height;
+            bind();
+            glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+        }
+
+        // Upload tightly packed pixels covering the whole level 0
+        void setPixels(const void* data, TextureFormat format, GLenum type = GL_UNSIGNED_BYTE) {
+            bind();
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(static_cast<GLenum>(type_), 0, 0, 0, width_, height_,
+                static_cast<GLenum>(format), type, data);
+        }
+
+        // Read level 0 back into tightly packed pixels
+        void getPixels(void* data, TextureFormat format, GLenum type = GL_UNSIGNED_BYTE) const {
+            bind();
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glGetTexImage(static_cast<GLenum>(type_), 0, static_cast<GLenum>(format), type, data);
+        }
+
+        // Bind level 0 to an image unit for compute shader load/store
+        void bindImage(GLuint unit, GLenum access, GLenum format = GL_RGBA8) const {
+            glBindImageTexture(unit, id_, 0, GL_FALSE, 0, access, format);
+        }
+
         // Set texture wrapping options
         void setWrapParameters(TextureWrap s, TextureWrap t, TextureWrap r = TextureWrap::Repeat) {
             bind();
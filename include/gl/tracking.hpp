@@ -0,0 +1,745 @@
+#ifndef GL_TRACKING_HPP
+#define GL_TRACKING_HPP
+
+#include "image.hpp"
+#include "projection.hpp"
+#include "ransac.hpp"
+#include "refine.hpp"
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace gl {
+
+    // Largest supported Lucas-Kanade window radius (the window is (2r+1)^2)
+    constexpr int MAX_TRACKER_WINDOW_RADIUS = 15;
+
+    struct TrackerOptions {
+        // Pyramid levels including the full-resolution one
+        int levels = 4;
+
+        int windowRadius = 7;
+
+        // Per-level iteration limit, and the step length (in pixels) below
+        // which a level is considered converged
+        int maxIterations = 20;
+        float epsilon = 0.01f;
+
+        // Points whose window has a smaller normalized minimum eigenvalue of
+        // the gradient matrix are too flat to track and are dropped
+        float minEigenvalue = 1e-4f;
+
+        // Points farther than this (in pixels) from the refined homography
+        // are treated as lost
+        float outlierThreshold = 2.0f;
+
+        // Fewer tracked points than this leaves the homography unchanged
+        std::size_t minPoints = 8;
+
+        // Incremental update from the previous homography
+        HomographyRefineOptions refine = { 10, 1e-3f, 1e-6f };
+
+        // Re-estimation from scratch when the incremental update fails
+        RansacOptions ransac;
+
+        // Pool for pyramid rows and point blocks; nullptr uses getDefaultJobSystem()
+        JobSystem* pool = nullptr;
+    };
+
+    struct CornerOptions {
+        std::size_t maxCorners = 500;
+
+        // Corners weaker than this fraction of the strongest are dropped
+        float qualityLevel = 0.01f;
+
+        // Minimum spacing between accepted corners, in pixels
+        float minDistance = 10.0f;
+
+        // Keep corners at least this far from the image edge
+        int margin = 8;
+    };
+
+    // One pyramid level: intensities in [0,1] and their Scharr gradients.
+    // Planes carry a replicated border so tracking windows never need bounds
+    // checks, and each row has slack for full-width SIMD loads.
+    struct PyramidLevel {
+        int width = 0;
+        int height = 0;
+        int border = 0;
+        std::size_t stride = 0; // floats per padded row
+        std::vector<float> intensity;
+        std::vector<float> gradX;
+        std::vector<float> gradY;
+
+        // Offset of pixel (x, y); valid for x, y in [-border, size + border)
+        std::size_t index(int x, int y) const {
+            return static_cast<std::size_t>(y + border) * stride + static_cast<std::size_t>(x + border);
+        }
+    };
+
+    namespace detail {
+
+        // Rows per pool task when building pyramid levels
+        constexpr int PYRAMID_ROW_BLOCK = 32;
+
+        // Points per pool task when tracking
+        constexpr std::size_t TRACK_POINT_BLOCK = 32;
+
+        // Floats of slack after each padded row, enough for one overhanging
+        // load of the widest lane type
+        constexpr int PYRAMID_ROW_SLACK = 16;
+
+        inline void forEachRowBlock(int rows, JobSystem& pool, const std::function<void(int, int)>& fn) {
+            const int blocks = (rows + PYRAMID_ROW_BLOCK - 1) / PYRAMID_ROW_BLOCK;
+            pool.parallelFor(static_cast<std::size_t>(blocks), [&](std::size_t block) {
+                const int y0 = static_cast<int>(block) * PYRAMID_ROW_BLOCK;
+                fn(y0, std::min(rows, y0 + PYRAMID_ROW_BLOCK));
+            });
+        }
+
+        inline void allocateLevel(PyramidLevel& level, int width, int height, int border) {
+            level.width = width;
+            level.height = height;
+            level.border = border;
+            level.stride = static_cast<std::size_t>(width + 2 * border + PYRAMID_ROW_SLACK + 15) & ~std::size_t(15);
+            const std::size_t size = level.stride * static_cast<std::size_t>(height + 2 * border);
+            // resize() keeps capacity, so rebuilding a same-sized pyramid doesn't allocate
+            level.intensity.resize(size);
+            level.gradX.resize(size);
+            level.gradY.resize(size);
+        }
+
+        // Replicate the edge pixels into the border and the row slack
+        inline void fillBorder(PyramidLevel& level) {
+            float* data = level.intensity.data();
+            const int w = level.width, h = level.height, b = level.border;
+            for (int y = 0; y < h; ++y) {
+                float* row = data + level.index(0, y);
+                std::fill(row - b, row, row[0]);
+                std::fill(row + w, row - b + level.stride, row[w - 1]);
+            }
+            for (int y = 1; y <= b; ++y) {
+                std::copy_n(data + level.index(-b, 0), level.stride, data + level.index(-b, -y));
+                std::copy_n(data + level.index(-b, h - 1), level.stride, data + level.index(-b, h - 1 + y));
+            }
+        }
+
+        // Scharr derivatives (scaled by 1/32, so a unit step gives ~1) over
+        // the padded plane; the outermost padded rows get zero gradients
+        template<typename V>
+        void computeGradients(PyramidLevel& level, int y0, int y1) {
+            const int b = level.border;
+            const int paddedWidth = level.width + 2 * b;
+            const int paddedHeight = level.height + 2 * b;
+            const V three(3.0f / 32.0f), ten(10.0f / 32.0f);
+            for (int py = y0; py < y1; ++py) {
+                float* gx = level.gradX.data() + static_cast<std::size_t>(py) * level.stride;
+                float* gy = level.gradY.data() + static_cast<std::size_t>(py) * level.stride;
+                if (py == 0 || py == paddedHeight - 1) {
+                    std::fill(gx, gx + level.stride, 0.0f);
+                    std::fill(gy, gy + level.stride, 0.0f);
+                    continue;
+                }
+                const float* above = level.intensity.data() + static_cast<std::size_t>(py - 1) * level.stride;
+                const float* row = above + level.stride;
+                const float* below = row + level.stride;
+
+                gx[0] = gy[0] = 0.0f;
+                int x = 1;
+                for (; x + V::Width <= paddedWidth - 1; x += V::Width) {
+                    const V dxAbove = V::load(above + x + 1) - V::load(above + x - 1);
+                    const V dxRow = V::load(row + x + 1) - V::load(row + x - 1);
+                    const V dxBelow = V::load(below + x + 1) - V::load(below + x - 1);
+                    simd::fmadd(three, dxAbove + dxBelow, ten * dxRow).store(gx + x);
+
+                    const V dyLeft = V::load(below + x - 1) - V::load(above + x - 1);
+                    const V dyMid = V::load(below + x) - V::load(above + x);
+                    const V dyRight = V::load(below + x + 1) - V::load(above + x + 1);
+                    simd::fmadd(three, dyLeft + dyRight, ten * dyMid).store(gy + x);
+                }
+                for (; x < paddedWidth - 1; ++x) {
+                    gx[x] = (3.0f * (above[x + 1] - above[x - 1] + below[x + 1] - below[x - 1]) +
+                        10.0f * (row[x + 1] - row[x - 1])) / 32.0f;
+                    gy[x] = (3.0f * (below[x - 1] - above[x - 1] + below[x + 1] - above[x + 1]) +
+                        10.0f * (below[x] - above[x])) / 32.0f;
+                }
+                std::fill(gx + paddedWidth - 1, gx + level.stride, 0.0f);
+                std::fill(gy + paddedWidth - 1, gy + level.stride, 0.0f);
+            }
+        }
+
+    } // namespace detail
+
+    // Gaussian image pyramid with gradients for Lucas-Kanade tracking. Level
+    // storage is kept between builds, so a pyramid reused frame after frame
+    // (as FeatureTracker does) allocates only when the frame size grows.
+    class ImagePyramid {
+    public:
+        // Rebuild from an 8-bit image (luma for 3-4 channels, the first
+        // channel otherwise). Each level is half the size of the one below,
+        // filtered with the 5-tap binomial kernel; rows are split over the pool.
+        template<typename V = simd::NativeFloat>
+        void build(const Image& image, int levels, int border, JobSystem* pool = nullptr) {
+            if (image.empty() || levels < 1) {
+                throw std::invalid_argument("ImagePyramid needs a non-empty image and at least one level");
+            }
+            if (border < 2) {
+                throw std::invalid_argument("ImagePyramid border must be at least 2 pixels");
+            }
+            JobSystem& workers = pool ? *pool : getDefaultJobSystem();
+
+            if (levels_.size() < static_cast<std::size_t>(levels)) {
+                levels_.resize(levels);
+            }
+            levelCount_ = 1;
+
+            PyramidLevel& base = levels_[0];
+            detail::allocateLevel(base, image.getWidth(), image.getHeight(), border);
+            const int channels = image.getChannels();
+            detail::forEachRowBlock(base.height, workers, [&](int y0, int y1) {
+                for (int y = y0; y < y1; ++y) {
+                    const std::uint8_t* src = image.getRow(y);
+                    float* dst = base.intensity.data() + base.index(0, y);
+                    if (channels >= 3) {
+                        for (int x = 0; x < base.width; ++x) {
+                            const std::uint8_t* p = src + x * channels;
+                            dst[x] = (0.299f / 255.0f) * p[0] + (0.587f / 255.0f) * p[1] + (0.114f / 255.0f) * p[2];
+                        }
+                    }
+                    else {
+                        for (int x = 0; x < base.width; ++x) {
+                            dst[x] = src[x * channels] * (1.0f / 255.0f);
+                        }
+                    }
+                }
+            });
+            finishLevel<V>(base, workers);
+
+            for (int l = 1; l < levels; ++l) {
+                const PyramidLevel& below = levels_[l - 1];
+                if (below.width < 2 * border || below.height < 2 * border) {
+                    break; // Too small to be useful for tracking
+                }
+                PyramidLevel& level = levels_[l];
+                detail::allocateLevel(level, (below.width + 1) / 2, (below.height + 1) / 2, border);
+                downsample<V>(below, level, workers);
+                finishLevel<V>(level, workers);
+                ++levelCount_;
+            }
+        }
+
+        int getLevelCount() const { return levelCount_; }
+        const PyramidLevel& getLevel(int level) const { return levels_[level]; }
+
+    private:
+        template<typename V>
+        void finishLevel(PyramidLevel& level, JobSystem& workers) {
+            detail::fillBorder(level);
+            detail::forEachRowBlock(level.height + 2 * level.border, workers, [&](int y0, int y1) {
+                detail::computeGradients<V>(level, y0, y1);
+            });
+        }
+
+        // Separable [1 4 6 4 1] / 16 filter and decimation. The vertical pass
+        // runs over contiguous rows in lanes; the stride-2 horizontal pass is scalar.
+        template<typename V>
+        void downsample(const PyramidLevel& src, PyramidLevel& dst, JobSystem& workers) {
+            const int span = src.width + 4; // columns [-2, width + 2)
+            const int blocks = (dst.height + detail::PYRAMID_ROW_BLOCK - 1) / detail::PYRAMID_ROW_BLOCK;
+            scratch_.resize(static_cast<std::size_t>(blocks) * (span + V::Width));
+
+            const V k1(1.0f / 16.0f), k4(4.0f / 16.0f), k6(6.0f / 16.0f);
+            detail::forEachRowBlock(dst.height, workers, [&](int y0, int y1) {
+                float* column = scratch_.data() + static_cast<std::size_t>(y0 / detail::PYRAMID_ROW_BLOCK) * (span + V::Width);
+                for (int y = y0; y < y1; ++y) {
+                    const float* r[5];
+                    for (int k = 0; k < 5; ++k) {
+                        r[k] = src.intensity.data() + src.index(-2, 2 * y - 2 + k);
+                    }
+                    int x = 0;
+                    for (; x + V::Width <= span; x += V::Width) {
+                        const V outer = V::load(r[0] + x) + V::load(r[4] + x);
+                        const V inner = V::load(r[1] + x) + V::load(r[3] + x);
+                        simd::fmadd(k1, outer, simd::fmadd(k4, inner, k6 * V::load(r[2] + x))).store(column + x);
+                    }
+                    for (; x < span; ++x) {
+                        column[x] = (r[0][x] + r[4][x] + 4.0f * (r[1][x] + r[3][x]) + 6.0f * r[2][x]) / 16.0f;
+                    }
+
+                    float* out = dst.intensity.data() + dst.index(0, y);
+                    for (int ox = 0; ox < dst.width; ++ox) {
+                        const float* c = column + 2 * ox; // centre at column[2 * ox + 2]
+                        out[ox] = (c[0] + c[4] + 4.0f * (c[1] + c[3]) + 6.0f * c[2]) * (1.0f / 16.0f);
+                    }
+                }
+            });
+        }
+
+        std::vector<PyramidLevel> levels_; // never shrinks, so level storage is reused
+        std::vector<float> scratch_;
+        int levelCount_ = 0;
+    };
+
+    namespace detail {
+
+        // Window planes for one point: (2r+1) rows of paddedWidth floats
+        constexpr int TRACK_WINDOW_ROWS = 2 * MAX_TRACKER_WINDOW_RADIUS + 1;
+        constexpr int TRACK_WINDOW_STRIDE = 32;
+
+        inline bool windowInside(const PyramidLevel& level, float x, float y, int radius) {
+            const float lo = static_cast<float>(radius - level.border);
+            return x >= lo && y >= lo &&
+                x < static_cast<float>(level.width - 1 + level.border - radius - 1) &&
+                y < static_cast<float>(level.height - 1 + level.border - radius - 1);
+        }
+
+        // Bilinear weights are the same for every pixel of a window anchored
+        // at a sub-pixel point, so each window row is four shifted row loads
+        template<typename V>
+        void sampleWindowRow(const float* r0, const float* r1, const V w[4], float* out, int paddedWidth) {
+            for (int c = 0; c < paddedWidth; c += V::Width) {
+                const V top = simd::fmadd(w[1], V::load(r0 + c + 1), w[0] * V::load(r0 + c));
+                const V bottom = simd::fmadd(w[3], V::load(r1 + c + 1), w[2] * V::load(r1 + c));
+                (top + bottom).store(out + c);
+            }
+        }
+
+        template<typename V>
+        void bilinearWeights(float x, float y, int& ix, int& iy, V w[4]) {
+            const float fx = std::floor(x), fy = std::floor(y);
+            ix = static_cast<int>(fx);
+            iy = static_cast<int>(fy);
+            const float ax = x - fx, ay = y - fy;
+            w[0] = V((1.0f - ax) * (1.0f - ay));
+            w[1] = V(ax * (1.0f - ay));
+            w[2] = V((1.0f - ax) * ay);
+            w[3] = V(ax * ay);
+        }
+
+        // Iterative Lucas-Kanade (Bouguet) on one level. point is the
+        // position in prev; flow is the incoming guess in level units and is
+        // updated in place. Returns false when the point is lost.
+        template<typename V>
+        bool trackLevel(const PyramidLevel& prev, const PyramidLevel& next, glm::vec2 point, glm::vec2& flow,
+            const TrackerOptions& options) {
+            const int r = options.windowRadius;
+            const int n = 2 * r + 1;
+            const int paddedWidth = (n + V::Width - 1) / V::Width * V::Width;
+            if (!windowInside(prev, point.x, point.y, r)) {
+                return false;
+            }
+
+            alignas(64) float T[TRACK_WINDOW_ROWS * TRACK_WINDOW_STRIDE];
+            alignas(64) float Tx[TRACK_WINDOW_ROWS * TRACK_WINDOW_STRIDE];
+            alignas(64) float Ty[TRACK_WINDOW_ROWS * TRACK_WINDOW_STRIDE];
+
+            // Template window and its gradients from the previous frame
+            int ix, iy;
+            V w[4];
+            bilinearWeights(point.x - r, point.y - r, ix, iy, w);
+            for (int k = 0; k < n; ++k) {
+                const std::size_t offset = prev.index(ix, iy + k);
+                float* t = T + k * TRACK_WINDOW_STRIDE;
+                float* tx = Tx + k * TRACK_WINDOW_STRIDE;
+                float* ty = Ty + k * TRACK_WINDOW_STRIDE;
+                sampleWindowRow(prev.intensity.data() + offset, prev.intensity.data() + offset + prev.stride, w, t, paddedWidth);
+                sampleWindowRow(prev.gradX.data() + offset, prev.gradX.data() + offset + prev.stride, w, tx, paddedWidth);
+                sampleWindowRow(prev.gradY.data() + offset, prev.gradY.data() + offset + prev.stride, w, ty, paddedWidth);
+                // Columns past the window then contribute nothing to any sum
+                std::fill(tx + n, tx + paddedWidth, 0.0f);
+                std::fill(ty + n, ty + paddedWidth, 0.0f);
+            }
+
+            V sxx(0.0f), sxy(0.0f), syy(0.0f);
+            for (int k = 0; k < n; ++k) {
+                for (int c = 0; c < paddedWidth; c += V::Width) {
+                    const V gx = V::load(Tx + k * TRACK_WINDOW_STRIDE + c);
+                    const V gy = V::load(Ty + k * TRACK_WINDOW_STRIDE + c);
+                    sxx = simd::fmadd(gx, gx, sxx);
+                    sxy = simd::fmadd(gx, gy, sxy);
+                    syy = simd::fmadd(gy, gy, syy);
+                }
+            }
+            const float gxx = simd::reduceAdd(sxx), gxy = simd::reduceAdd(sxy), gyy = simd::reduceAdd(syy);
+            const float det = gxx * gyy - gxy * gxy;
+            const float minEigenvalue = 0.5f * (gxx + gyy - std::sqrt((gxx - gyy) * (gxx - gyy) + 4.0f * gxy * gxy));
+            if (minEigenvalue / static_cast<float>(n * n) < options.minEigenvalue || det <= 0.0f) {
+                return false;
+            }
+            const float invDet = 1.0f / det;
+
+            glm::vec2 v(0.0f);
+            for (int iteration = 0; iteration < options.maxIterations; ++iteration) {
+                const glm::vec2 target = point + flow + v;
+                if (!windowInside(next, target.x, target.y, r)) {
+                    return false;
+                }
+                bilinearWeights(target.x - r, target.y - r, ix, iy, w);
+
+                V bx(0.0f), by(0.0f);
+                for (int k = 0; k < n; ++k) {
+                    const float* r0 = next.intensity.data() + next.index(ix, iy + k);
+                    const float* r1 = r0 + next.stride;
+                    const float* t = T + k * TRACK_WINDOW_STRIDE;
+                    const float* tx = Tx + k * TRACK_WINDOW_STRIDE;
+                    const float* ty = Ty + k * TRACK_WINDOW_STRIDE;
+                    for (int c = 0; c < paddedWidth; c += V::Width) {
+                        const V top = simd::fmadd(w[1], V::load(r0 + c + 1), w[0] * V::load(r0 + c));
+                        const V bottom = simd::fmadd(w[3], V::load(r1 + c + 1), w[2] * V::load(r1 + c));
+                        const V diff = V::load(t + c) - (top + bottom);
+                        bx = simd::fmadd(diff, V::load(tx + c), bx);
+                        by = simd::fmadd(diff, V::load(ty + c), by);
+                    }
+                }
+                const float ex = simd::reduceAdd(bx), ey = simd::reduceAdd(by);
+                const glm::vec2 step((gyy * ex - gxy * ey) * invDet, (gxx * ey - gxy * ex) * invDet);
+                v += step;
+                if (step.x * step.x + step.y * step.y < options.epsilon * options.epsilon) {
+                    break;
+                }
+            }
+            flow += v;
+            return std::isfinite(flow.x) && std::isfinite(flow.y);
+        }
+
+    } // namespace detail
+
+    // Pyramidal Lucas-Kanade: track prevPoints from prev into next. On input
+    // nextPoints holds initial guesses (copy prevPoints when there is no
+    // prediction); on output it holds the tracked positions. status is 1 for
+    // points that were tracked and 0 for lost ones. Levels run coarse to
+    // fine with points split over the pool on every level.
+    template<typename V = simd::NativeFloat>
+    void trackPoints(const ImagePyramid& prev, const ImagePyramid& next, std::span<const glm::vec2> prevPoints,
+        std::span<glm::vec2> nextPoints, std::span<std::uint8_t> status, const TrackerOptions& options = {}) {
+        if (prevPoints.size() != nextPoints.size() || prevPoints.size() != status.size()) {
+            throw std::invalid_argument("Tracking point and status sizes differ");
+        }
+        if (options.windowRadius < 1 || options.windowRadius > MAX_TRACKER_WINDOW_RADIUS) {
+            throw std::invalid_argument("Tracker window radius out of range");
+        }
+        const int levels = std::min(prev.getLevelCount(), next.getLevelCount());
+        if (levels == 0 || prev.getLevel(0).border < options.windowRadius + 2 ||
+            next.getLevel(0).border < options.windowRadius + 2) {
+            throw std::invalid_argument("Pyramids must be built with a border of at least windowRadius + 2");
+        }
+
+        const std::size_t count = prevPoints.size();
+        std::vector<glm::vec2> flow(count);
+        const float top = std::ldexp(1.0f, -(levels - 1));
+        for (std::size_t i = 0; i < count; ++i) {
+            flow[i] = (nextPoints[i] - prevPoints[i]) * top;
+            status[i] = 1;
+        }
+
+        JobSystem& workers = options.pool ? *options.pool : getDefaultJobSystem();
+        const std::size_t blocks = (count + detail::TRACK_POINT_BLOCK - 1) / detail::TRACK_POINT_BLOCK;
+        for (int level = levels - 1; level >= 0; --level) {
+            const float scale = std::ldexp(1.0f, -level);
+            const PyramidLevel& a = prev.getLevel(level);
+            const PyramidLevel& b = next.getLevel(level);
+            workers.parallelFor(blocks, [&](std::size_t block) {
+                const std::size_t end = std::min(count, (block + 1) * detail::TRACK_POINT_BLOCK);
+                for (std::size_t i = block * detail::TRACK_POINT_BLOCK; i < end; ++i) {
+                    if (!status[i]) continue;
+                    if (!detail::trackLevel<V>(a, b, prevPoints[i] * scale, flow[i], options)) {
+                        status[i] = 0;
+                    }
+                    else if (level > 0) {
+                        flow[i] *= 2.0f;
+                    }
+                }
+            });
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (status[i]) {
+                nextPoints[i] = prevPoints[i] + flow[i];
+            }
+        }
+    }
+
+    // Shi-Tomasi corners: local maxima of the minimum eigenvalue of the 3x3
+    // gradient matrix, strongest first, at least minDistance apart
+    template<typename V = simd::NativeFloat>
+    std::vector<glm::vec2> detectGoodFeatures(const PyramidLevel& level, const CornerOptions& options = {},
+        JobSystem* pool = nullptr) {
+        const int w = level.width, h = level.height;
+        const int margin = std::max(options.margin, 1);
+        if (w <= 2 * margin || h <= 2 * margin) {
+            return {};
+        }
+        JobSystem& workers = pool ? *pool : getDefaultJobSystem();
+
+        std::vector<float> response(static_cast<std::size_t>(w) * h, 0.0f);
+        detail::forEachRowBlock(h - 2 * margin, workers, [&](int y0, int y1) {
+            for (int y = y0 + margin; y < y1 + margin; ++y) {
+                float* out = response.data() + static_cast<std::size_t>(y) * w;
+                int x = margin;
+                auto evaluate = [&]<typename L>(int x0) {
+                    L a(0.0f), b(0.0f), c(0.0f);
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            const std::size_t i = level.index(x0 + dx, y + dy);
+                            const L gx = L::load(level.gradX.data() + i);
+                            const L gy = L::load(level.gradY.data() + i);
+                            a = simd::fmadd(gx, gx, a);
+                            b = simd::fmadd(gx, gy, b);
+                            c = simd::fmadd(gy, gy, c);
+                        }
+                    }
+                    const L half(0.5f);
+                    const L d = (a - c) * half;
+                    ((a + c) * half - simd::sqrt(simd::fmadd(d, d, b * b))).store(out + x0);
+                };
+                for (; x + V::Width <= w - margin; x += V::Width) {
+                    evaluate.template operator()<V>(x);
+                }
+                for (; x < w - margin; ++x) {
+                    evaluate.template operator()<simd::FloatX1>(x);
+                }
+            }
+        });
+
+        const float strongest = *std::max_element(response.begin(), response.end());
+        if (strongest <= 0.0f) {
+            return {};
+        }
+        const float threshold = strongest * options.qualityLevel;
+
+        struct Candidate {
+            float response;
+            int x, y;
+        };
+        std::vector<Candidate> candidates;
+        for (int y = margin; y < h - margin; ++y) {
+            const float* row = response.data() + static_cast<std::size_t>(y) * w;
+            for (int x = margin; x < w - margin; ++x) {
+                const float v = row[x];
+                if (v < threshold) continue;
+                bool peak = true;
+                for (int dy = -1; dy <= 1 && peak; ++dy) {
+                    const float* neighbours = row + dy * w;
+                    peak = v >= neighbours[x - 1] && v >= neighbours[x] && v >= neighbours[x + 1];
+                }
+                if (peak) {
+                    candidates.push_back({ v, x, y });
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) { return a.response > b.response; });
+
+        // Greedy spacing with a grid of minDistance-sized cells
+        const float minDistance = std::max(options.minDistance, 1.0f);
+        const int cellsX = static_cast<int>(w / minDistance) + 1;
+        const int cellsY = static_cast<int>(h / minDistance) + 1;
+        std::vector<std::vector<glm::vec2>> grid(static_cast<std::size_t>(cellsX) * cellsY);
+        std::vector<glm::vec2> corners;
+        for (const Candidate& candidate : candidates) {
+            if (corners.size() >= options.maxCorners) break;
+            const glm::vec2 p(static_cast<float>(candidate.x), static_cast<float>(candidate.y));
+            const int cx = static_cast<int>(p.x / minDistance), cy = static_cast<int>(p.y / minDistance);
+            bool free = true;
+            for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, cellsY - 1) && free; ++gy) {
+                for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, cellsX - 1) && free; ++gx) {
+                    for (const glm::vec2& q : grid[static_cast<std::size_t>(gy) * cellsX + gx]) {
+                        const glm::vec2 d = p - q;
+                        if (d.x * d.x + d.y * d.y < minDistance * minDistance) {
+                            free = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (free) {
+                grid[static_cast<std::size_t>(cy) * cellsX + cx].push_back(p);
+                corners.push_back(p);
+            }
+        }
+        return corners;
+    }
+
+    // Per-frame summary from FeatureTracker::track
+    struct TrackerFrameStats {
+        std::size_t tracked = 0;       // Points still tracked after this frame
+        std::size_t lost = 0;          // Points dropped this frame (tracking or outliers)
+        int refineIterations = 0;      // LM iterations spent on the homography
+        float error = 0.0f;            // RMS reprojection error of the tracked points
+        bool homographyUpdated = false;
+        bool reestimated = false;      // Incremental update failed; RANSAC ran from scratch
+    };
+
+    // Tracks corner points through an image sequence and maintains the
+    // homography from the first (reference) frame to the current one. Each
+    // frame's homography starts from the previous solution and is refined
+    // with Levenberg-Marquardt over the surviving points, which usually
+    // takes a couple of iterations; RANSAC from scratch is only the fallback.
+    class FeatureTracker {
+    public:
+        explicit FeatureTracker(const TrackerOptions& options = {})
+            : options_(options) {
+        }
+
+        // Start a sequence on frame with the given reference points (for
+        // example from detectGoodFeatures); the homography resets to identity
+        template<typename V = simd::NativeFloat>
+        void reset(const Image& frame, std::span<const glm::vec2> points) {
+            pyramids_[current_].build<V>(frame, options_.levels, options_.windowRadius + 2, options_.pool);
+            reference_.assign(points.begin(), points.end());
+            points_ = reference_;
+            status_.assign(points.size(), 1);
+            homography_ = glm::mat3(1.0f);
+            stats_ = {};
+            stats_.tracked = points.size();
+        }
+
+        // Track into the next frame and update the homography
+        template<typename V = simd::NativeFloat>
+        const TrackerFrameStats& track(const Image& frame) {
+            const int previous = current_;
+            current_ ^= 1;
+            pyramids_[current_].build<V>(frame, options_.levels, options_.windowRadius + 2, options_.pool);
+
+            stats_ = {};
+            active_.clear();
+            prevPoints_.clear();
+            for (std::uint32_t i = 0; i < status_.size(); ++i) {
+                if (status_[i]) {
+                    active_.push_back(i);
+                    prevPoints_.push_back(points_[i]);
+                }
+            }
+            nextPoints_ = prevPoints_;
+            trackStatus_.resize(active_.size());
+            trackPoints<V>(pyramids_[previous], pyramids_[current_], prevPoints_, nextPoints_, trackStatus_, options_);
+
+            for (std::size_t k = 0; k < active_.size(); ++k) {
+                if (trackStatus_[k]) {
+                    points_[active_[k]] = nextPoints_[k];
+                }
+                else {
+                    status_[active_[k]] = 0;
+                    ++stats_.lost;
+                }
+            }
+
+            updateHomography<V>();
+            stats_.tracked = getTrackedCount();
+            return stats_;
+        }
+
+        const glm::mat3& getHomography() const { return homography_; }
+        const std::vector<glm::vec2>& getReferencePoints() const { return reference_; }
+        const std::vector<glm::vec2>& getPoints() const { return points_; } // Stale for lost points
+        const std::vector<std::uint8_t>& getStatus() const { return status_; }
+        const TrackerFrameStats& getStats() const { return stats_; }
+
+        std::size_t getTrackedCount() const {
+            return static_cast<std::size_t>(std::count(status_.begin(), status_.end(), std::uint8_t(1)));
+        }
+
+    private:
+        void gatherTracked() {
+            active_.clear();
+            src_.clear();
+            dst_.clear();
+            for (std::uint32_t i = 0; i < status_.size(); ++i) {
+                if (status_[i]) {
+                    active_.push_back(i);
+                    src_.push_back(reference_[i]);
+                    dst_.push_back(points_[i]);
+                }
+            }
+        }
+
+        // Drop points farther than outlierThreshold from H; returns how many
+        std::size_t rejectOutliers(const glm::mat3& H) {
+            std::size_t rejected = 0;
+            const float limit = options_.outlierThreshold * options_.outlierThreshold;
+            for (std::size_t k = 0; k < active_.size(); ++k) {
+                const glm::vec2 d = projectPoint(H, src_[k]) - dst_[k];
+                if (!(d.x * d.x + d.y * d.y <= limit)) {
+                    status_[active_[k]] = 0;
+                    ++rejected;
+                }
+            }
+            return rejected;
+        }
+
+        template<typename V>
+        void updateHomography() {
+            gatherTracked();
+            if (active_.size() < std::max<std::size_t>(options_.minPoints, 4)) {
+                return;
+            }
+
+            // Incremental: refine from the last solution over every tracked
+            // point, drop the outliers, and polish on the rest
+            HomographyRefineResult refined = refineHomography<V>(src_, dst_, homography_, options_.refine);
+            stats_.refineIterations = refined.iterations;
+            const std::size_t before = active_.size();
+            std::size_t rejected = rejectOutliers(refined.homography);
+
+            if (2 * rejected > before) {
+                // Most points disagree with the propagated model; start over.
+                // Nothing was committed yet, so restore the rejected points.
+                for (std::uint32_t index : active_) {
+                    status_[index] = 1;
+                }
+                RansacOptions ransacOptions = options_.ransac;
+                ransacOptions.inlierThreshold = options_.outlierThreshold;
+                ransacOptions.pool = options_.pool;
+                RansacResult estimate = estimateHomographyRansac(src_, dst_, ransacOptions);
+                if (!estimate.success) {
+                    return;
+                }
+                stats_.reestimated = true;
+                refined.homography = estimate.homography;
+                rejected = rejectOutliers(estimate.homography);
+            }
+            stats_.lost += rejected;
+
+            if (rejected > 0) {
+                gatherTracked();
+                if (active_.size() < std::max<std::size_t>(options_.minPoints, 4)) {
+                    return;
+                }
+                refined = refineHomography<V>(src_, dst_, refined.homography, options_.refine);
+                stats_.refineIterations += refined.iterations;
+            }
+
+            homography_ = refined.homography;
+            stats_.error = refined.finalError;
+            stats_.homographyUpdated = true;
+        }
+
+        TrackerOptions options_;
+        ImagePyramid pyramids_[2]; // Previous and current frame, swapped every frame
+        int current_ = 0;
+
+        std::vector<glm::vec2> reference_;
+        std::vector<glm::vec2> points_;
+        std::vector<std::uint8_t> status_;
+        glm::mat3 homography_ = glm::mat3(1.0f);
+        TrackerFrameStats stats_;
+
+        // Per-frame scratch, kept to avoid reallocating
+        std::vector<std::uint32_t> active_;
+        std::vector<glm::vec2> prevPoints_;
+        std::vector<glm::vec2> nextPoints_;
+        std::vector<std::uint8_t> trackStatus_;
+        std::vector<glm::vec2> src_;
+        std::vector<glm::vec2> dst_;
+    };
+
+} // namespace gl
+
+#endif // GL_TRACKING_HPP
@@ -0,0 +1,439 @@
+#ifndef GL_WARP_HPP
+#define GL_WARP_HPP
+
+#include "image.hpp"
+#include "simd.hpp"
+#include "job_system.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace gl {
+
+    enum class WarpFilter {
+        Nearest,
+        Bilinear
+    };
+
+    // How source coordinates are produced along each destination row
+    enum class WarpStepping {
+        // Evaluate H * (x, y, 1) and divide for every pixel (exact)
+        PerPixel,
+        // Step the homogeneous coordinates by forward differences and divide
+        // only at subspan ends; pixels in between are interpolated affinely,
+        // with subspans shortened until the error is within maxSubspanError
+        ForwardDifference
+    };
+
+    struct WarpOptions {
+        WarpFilter filter = WarpFilter::Bilinear;
+        WarpStepping stepping = WarpStepping::PerPixel;
+
+        // Largest source-space error (in pixels) allowed by ForwardDifference
+        float maxSubspanError = 1.0f / 16.0f;
+
+        // Destination is split into tileSize x tileSize blocks distributed over the pool
+        int tileSize = 64;
+
+        // Pool to run on; nullptr uses getDefaultJobSystem()
+        JobSystem* pool = nullptr;
+
+        // Written wherever the source is sampled out of bounds (bytes in channel order)
+        std::uint8_t borderColor[4] = { 0, 0, 0, 0 };
+
+        // Use the SIMD kernels (off forces scalar coordinate and sampling loops)
+        bool vectorize = true;
+    };
+
+    namespace detail {
+
+        // Maps a destination pixel to source coordinates: (u, v) = H * (x, y, 1)
+        struct WarpMapping {
+            float h[9]; // Row-major copy of H
+
+            explicit WarpMapping(const glm::mat3& H) {
+                for (int r = 0; r < 3; ++r) {
+                    for (int c = 0; c < 3; ++c) {
+                        h[r * 3 + c] = H[c][r];
+                    }
+                }
+            }
+        };
+
+        // Longest run of pixels processed per coordinate batch
+        constexpr int WARP_MAX_SPAN = 256;
+
+        // Longest affine subspan used by forward differencing
+        constexpr int WARP_MAX_SUBSPAN = 32;
+
+        // Exact coordinates, one divide per pixel
+        inline void rowCoordinatesPerPixel(const WarpMapping& m, int y, int x0, int count,
+            float* us, float* vs, bool vectorize) {
+            const float fy = static_cast<float>(y);
+            const float rowX = m.h[1] * fy + m.h[2];
+            const float rowY = m.h[4] * fy + m.h[5];
+            const float rowZ = m.h[7] * fy + m.h[8];
+
+            int i = 0;
+            if (vectorize) {
+                using V = simd::NativeFloat;
+                alignas(64) float ramp[V::Width];
+                for (int k = 0; k < V::Width; ++k) {
+                    ramp[k] = static_cast<float>(k);
+                }
+                const V offsets = V::load(ramp);
+                for (; i + V::Width <= count; i += V::Width) {
+                    V fx = V(static_cast<float>(x0 + i)) + offsets;
+                    V Z = simd::fmadd(fx, V(m.h[6]), V(rowZ));
+                    (simd::fmadd(fx, V(m.h[0]), V(rowX)) / Z).store(us + i);
+                    (simd::fmadd(fx, V(m.h[3]), V(rowY)) / Z).store(vs + i);
+                }
+            }
+            for (; i < count; ++i) {
+                const float fx = static_cast<float>(x0 + i);
+                float Z = m.h[6] * fx + rowZ;
+                us[i] = (m.h[0] * fx + rowX) / Z;
+                vs[i] = (m.h[3] * fx + rowY) / Z;
+            }
+        }
+
+        // Forward-differenced coordinates. Along a row X, Y and Z are linear in
+        // x, so they advance by constant steps. Between two exact samples a and
+        // b the affine approximation of u = X / Z deviates from the true value by
+        // at most max(|du|, |dv|) * |sqrt(r) - 1| / (sqrt(r) + 1), r = Zb / Za;
+        // subspans are halved until that bound is below maxError, then grow again.
+        inline void rowCoordinatesForwardDifference(const WarpMapping& m, int y, int x0, int count,
+            float* us, float* vs, float maxError) {
+            const float fy = static_cast<float>(y);
+            const float fx0 = static_cast<float>(x0);
+            const float dX = m.h[0], dY = m.h[3], dZ = m.h[6];
+            float X = m.h[0] * fx0 + m.h[1] * fy + m.h[2];
+            float Y = m.h[3] * fx0 + m.h[4] * fy + m.h[5];
+            float Z = m.h[6] * fx0 + m.h[7] * fy + m.h[8];
+
+            float invZ = simd::fastReciprocal(Z);
+            float ua = X * invZ;
+            float va = Y * invZ;
+            int span = WARP_MAX_SUBSPAN;
+
+            for (int i = 0; i < count;) {
+                int len = std::min(span, count - i);
+                float Zb, ub, vb, invZb;
+                bool affine = false;
+
+                for (;;) {
+                    const float step = static_cast<float>(len);
+                    Zb = Z + dZ * step;
+                    invZb = simd::fastReciprocal(Zb);
+                    ub = (X + dX * step) * invZb;
+                    vb = (Y + dY * step) * invZb;
+
+                    float r = Zb * invZ;
+                    if (!(r > 0.0f) || !std::isfinite(ub) || !std::isfinite(vb)) {
+                        break; // Crosses the horizon: evaluate exactly
+                    }
+                    float root = std::sqrt(r);
+                    float bound = std::max(std::abs(ub - ua), std::abs(vb - va)) *
+                        std::abs(root - 1.0f) / (root + 1.0f);
+                    if (bound <= maxError) {
+                        affine = true;
+                        break;
+                    }
+                    if (len == 1) break;
+                    len = (len + 1) / 2;
+                }
+
+                if (affine) {
+                    const float inv = 1.0f / static_cast<float>(len);
+                    const float du = (ub - ua) * inv;
+                    const float dv = (vb - va) * inv;
+                    for (int k = 0; k < len; ++k) {
+                        us[i + k] = ua + du * static_cast<float>(k);
+                        vs[i + k] = va + dv * static_cast<float>(k);
+                    }
+                    span = std::min(span * 2, WARP_MAX_SUBSPAN);
+                }
+                else {
+                    for (int k = 0; k < len; ++k) {
+                        const float t = static_cast<float>(k);
+                        const float z = Z + dZ * t;
+                        us[i + k] = (X + dX * t) / z;
+                        vs[i + k] = (Y + dY * t) / z;
+                    }
+                    span = len;
+                }
+
+                // Advance the homogeneous coordinates to the end of the subspan
+                const float step = static_cast<float>(len);
+                X += dX * step;
+                Y += dY * step;
+                Z = Zb;
+                invZ = invZb;
+                ua = ub;
+                va = vb;
+                i += len;
+            }
+        }
+
+        // Generic sampler for any channel count
+        inline void sampleSpanScalar(const Image& src, const float* us, const float* vs, int count,
+            std::uint8_t* out, const WarpOptions& options) {
+            const int channels = src.getChannels();
+            const int w = src.getWidth();
+            const int h = src.getHeight();
+
+            for (int i = 0; i < count; ++i, out += channels) {
+                float u = us[i];
+                float v = vs[i];
+
+                if (options.filter == WarpFilter::Nearest) {
+                    if (!(u >= -0.5f && v >= -0.5f && u < w - 0.5f && v < h - 0.5f)) {
+                        std::memcpy(out, options.borderColor, channels);
+                        continue;
+                    }
+                    int sx = static_cast<int>(u + 0.5f);
+                    int sy = static_cast<int>(v + 0.5f);
+                    std::memcpy(out, src.getRow(sy) + sx * channels, channels);
+                    continue;
+                }
+
+                if (!(u >= 0.0f && v >= 0.0f && u <= w - 1.0f && v <= h - 1.0f)) {
+                    std::memcpy(out, options.borderColor, channels);
+                    continue;
+                }
+
+                int sx = static_cast<int>(u);
+                int sy = static_cast<int>(v);
+                float ax = u - sx;
+                float ay = v - sy;
+                int sx1 = std::min(sx + 1, w - 1);
+                int sy1 = std::min(sy + 1, h - 1);
+
+                const std::uint8_t* r0 = src.getRow(sy);
+                const std::uint8_t* r1 = src.getRow(sy1);
+                for (int c = 0; c < channels; ++c) {
+                    float top = r0[sx * channels + c] + (r0[sx1 * channels + c] - r0[sx * channels + c]) * ax;
+                    float bottom = r1[sx * channels + c] + (r1[sx1 * channels + c] - r1[sx * channels + c]) * ax;
+                    out[c] = static_cast<std::uint8_t>(top + (bottom - top) * ay + 0.5f);
+                }
+            }
+        }
+
+#ifdef GL_SIMD_SSE2
+        // RGBA sampler: the four channels of a pixel are interpolated in parallel
+        inline void sampleSpanSSE(const Image& src, const float* us, const float* vs, int count,
+            std::uint8_t* out, const WarpOptions& options) {
+            const int w = src.getWidth();
+            const int h = src.getHeight();
+            const std::uint32_t* pixels = reinterpret_cast<const std::uint32_t*>(src.getData());
+            std::uint32_t* dst = reinterpret_cast<std::uint32_t*>(out);
+            std::uint32_t border;
+            std::memcpy(&border, options.borderColor, 4);
+            const __m128i zero = _mm_setzero_si128();
+
+            auto toFloats = [zero](std::uint32_t p) {
+                __m128i v = _mm_cvtsi32_si128(static_cast<int>(p));
+                v = _mm_unpacklo_epi8(v, zero);
+                v = _mm_unpacklo_epi16(v, zero);
+                return _mm_cvtepi32_ps(v);
+            };
+
+            for (int i = 0; i < count; ++i) {
+                float u = us[i];
+                float v = vs[i];
+
+                if (options.filter == WarpFilter::Nearest) {
+                    dst[i] = (u >= -0.5f && v >= -0.5f && u < w - 0.5f && v < h - 0.5f) ?
+                        pixels[static_cast<int>(v + 0.5f) * w + static_cast<int>(u + 0.5f)] : border;
+                    continue;
+                }
+
+                if (!(u >= 0.0f && v >= 0.0f && u <= w - 1.0f && v <= h - 1.0f)) {
+                    dst[i] = border;
+                    continue;
+                }
+
+                int sx = static_cast<int>(u);
+                int sy = static_cast<int>(v);
+                int dx = sx + 1 < w ? 1 : 0;
+                int dy = sy + 1 < h ? w : 0;
+                const std::uint32_t* p = pixels + sy * w + sx;
+
+                __m128 ax = _mm_set1_ps(u - sx);
+                __m128 ay = _mm_set1_ps(v - sy);
+                __m128 p00 = toFloats(p[0]), p01 = toFloats(p[dx]);
+                __m128 p10 = toFloats(p[dy]), p11 = toFloats(p[dy + dx]);
+                __m128 top = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p01, p00), ax));
+                __m128 bottom = _mm_add_ps(p10, _mm_mul_ps(_mm_sub_ps(p11, p10), ax));
+                __m128 value = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), ay));
+
+                __m128i packed = _mm_cvtps_epi32(value);
+                packed = _mm_packs_epi32(packed, packed);
+                packed = _mm_packus_epi16(packed, packed);
+                dst[i] = static_cast<std::uint32_t>(_mm_cvtsi128_si32(packed));
+            }
+        }
+#endif
+
+#ifdef __AVX2__
+        // RGBA sampler: eight pixels per iteration with hardware gathers
+        inline void sampleSpanAVX2(const Image& src, const float* us, const float* vs, int count,
+            std::uint8_t* out, const WarpOptions& options) {
+            const int w = src.getWidth();
+            const int h = src.getHeight();
+            const int* pixels = reinterpret_cast<const int*>(src.getData());
+            std::uint32_t borderBits;
+            std::memcpy(&borderBits, options.borderColor, 4);
+            const __m256i border = _mm256_set1_epi32(static_cast<int>(borderBits));
+
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 maxU = _mm256_set1_ps(w - 1.0f);
+            const __m256 maxV = _mm256_set1_ps(h - 1.0f);
+            const __m256i lastX = _mm256_set1_epi32(w - 1);
+            const __m256i lastY = _mm256_set1_epi32(h - 1);
+            const __m256i stride = _mm256_set1_epi32(w);
+            const __m256i byteMask = _mm256_set1_epi32(0xFF);
+
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 u = _mm256_loadu_ps(us + i);
+                __m256 v = _mm256_loadu_ps(vs + i);
+                __m256i* dst = reinterpret_cast<__m256i*>(out + static_cast<std::size_t>(i) * 4);
+
+                if (options.filter == WarpFilter::Nearest) {
+                    __m256 valid = _mm256_and_ps(
+                        _mm256_and_ps(_mm256_cmp_ps(u, _mm256_set1_ps(-0.5f), _CMP_GE_OQ),
+                            _mm256_cmp_ps(v, _mm256_set1_ps(-0.5f), _CMP_GE_OQ)),
+                        _mm256_and_ps(_mm256_cmp_ps(u, _mm256_set1_ps(w - 0.5f), _CMP_LT_OQ),
+                            _mm256_cmp_ps(v, _mm256_set1_ps(h - 0.5f), _CMP_LT_OQ)));
+                    __m256i sx = _mm256_cvttps_epi32(_mm256_and_ps(_mm256_add_ps(u, half), valid));
+                    __m256i sy = _mm256_cvttps_epi32(_mm256_and_ps(_mm256_add_ps(v, half), valid));
+                    __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(sy, stride), sx);
+                    _mm256_storeu_si256(dst, _mm256_mask_i32gather_epi32(border, pixels, index,
+                        _mm256_castps_si256(valid), 4));
+                    continue;
+                }
+
+                __m256 valid = _mm256_and_ps(
+                    _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(v, zero, _CMP_GE_OQ)),
+                    _mm256_and_ps(_mm256_cmp_ps(u, maxU, _CMP_LE_OQ), _mm256_cmp_ps(v, maxV, _CMP_LE_OQ)));
+                if (_mm256_movemask_ps(valid) == 0) {
+                    _mm256_storeu_si256(dst, border);
+                    continue;
+                }
+
+                // Invalid lanes are zeroed and skipped by the masked gathers
+                u = _mm256_and_ps(u, valid);
+                v = _mm256_and_ps(v, valid);
+                __m256 fu = _mm256_floor_ps(u);
+                __m256 fv = _mm256_floor_ps(v);
+                __m256 ax = _mm256_sub_ps(u, fu);
+                __m256 ay = _mm256_sub_ps(v, fv);
+                __m256i sx0 = _mm256_cvttps_epi32(fu);
+                __m256i sy0 = _mm256_cvttps_epi32(fv);
+                __m256i sx1 = _mm256_min_epi32(_mm256_add_epi32(sx0, _mm256_set1_epi32(1)), lastX);
+                __m256i sy1 = _mm256_min_epi32(_mm256_add_epi32(sy0, _mm256_set1_epi32(1)), lastY);
+                __m256i row0 = _mm256_mullo_epi32(sy0, stride);
+                __m256i row1 = _mm256_mullo_epi32(sy1, stride);
+
+                __m256i mask = _mm256_castps_si256(valid);
+                __m256i none = _mm256_setzero_si256();
+                __m256i p00 = _mm256_mask_i32gather_epi32(none, pixels, _mm256_add_epi32(row0, sx0), mask, 4);
+                __m256i p01 = _mm256_mask_i32gather_epi32(none, pixels, _mm256_add_epi32(row0, sx1), mask, 4);
+                __m256i p10 = _mm256_mask_i32gather_epi32(none, pixels, _mm256_add_epi32(row1, sx0), mask, 4);
+                __m256i p11 = _mm256_mask_i32gather_epi32(none, pixels, _mm256_add_epi32(row1, sx1), mask, 4);
+
+                __m256i result = _mm256_setzero_si256();
+                for (int c = 0; c < 4; ++c) {
+                    auto channel = [&](__m256i p) {
+                        return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p, c * 8), byteMask));
+                    };
+                    __m256 c00 = channel(p00), c01 = channel(p01);
+                    __m256 c10 = channel(p10), c11 = channel(p11);
+                    __m256 top = _mm256_add_ps(c00, _mm256_mul_ps(_mm256_sub_ps(c01, c00), ax));
+                    __m256 bottom = _mm256_add_ps(c10, _mm256_mul_ps(_mm256_sub_ps(c11, c10), ax));
+                    __m256 value = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), ay));
+                    __m256i bits = _mm256_cvtps_epi32(value);
+                    result = _mm256_or_si256(result, _mm256_slli_epi32(bits, c * 8));
+                }
+
+                _mm256_storeu_si256(dst, _mm256_blendv_epi8(border, result, mask));
+            }
+
+            if (i < count) {
+                sampleSpanSSE(src, us + i, vs + i, count - i, out + static_cast<std::size_t>(i) * 4, options);
+            }
+        }
+#endif
+
+        inline void sampleSpan(const Image& src, const float* us, const float* vs, int count,
+            std::uint8_t* out, const WarpOptions& options) {
+            if (options.vectorize && src.getChannels() == 4) {
+#if defined(__AVX2__)
+                sampleSpanAVX2(src, us, vs, count, out, options);
+                return;
+#elif defined(GL_SIMD_SSE2)
+                sampleSpanSSE(src, us, vs, count, out, options);
+                return;
+#endif
+            }
+            sampleSpanScalar(src, us, vs, count, out, options);
+        }
+
+        // Warp destination pixels [x0, x1) of row y
+        inline void warpSpan(const Image& src, const WarpMapping& m, std::uint8_t* out,
+            int y, int x0, int x1, const WarpOptions& options) {
+            alignas(64) float us[WARP_MAX_SPAN];
+            alignas(64) float vs[WARP_MAX_SPAN];
+
+            for (int x = x0; x < x1; x += WARP_MAX_SPAN) {
+                const int count = std::min(WARP_MAX_SPAN, x1 - x);
+                if (options.stepping == WarpStepping::ForwardDifference) {
+                    rowCoordinatesForwardDifference(m, y, x, count, us, vs, options.maxSubspanError);
+                }
+                else {
+                    rowCoordinatesPerPixel(m, y, x, count, us, vs, options.vectorize);
+                }
+                sampleSpan(src, us, vs, count, out + static_cast<std::size_t>(x - x0) * src.getChannels(), options);
+            }
+        }
+
+    } // namespace detail
+
+    // Perspective warp on the CPU. H maps destination pixel coordinates to
+    // source pixel coordinates (the same direction as the u_homography uniform
+    // in cube.frag), with pixel centres at integer coordinates. dst must be
+    // allocated with the output size and the same channel count as src.
+    inline void warpPerspective(const Image& src, const glm::mat3& H, Image& dst,
+        const WarpOptions& options = {}) {
+        if (src.empty() || dst.empty()) {
+            throw std::invalid_argument("warpPerspective requires non-empty images");
+        }
+        if (src.getChannels() != dst.getChannels()) {
+            throw std::invalid_argument("warpPerspective source and destination channel counts differ");
+        }
+
+        const detail::WarpMapping mapping(H);
+        const int tile = std::max(options.tileSize, 8);
+        const int tilesX = (dst.getWidth() + tile - 1) / tile;
+        const int tilesY = (dst.getHeight() + tile - 1) / tile;
+        JobSystem& pool = options.pool ? *options.pool : getDefaultJobSystem();
+
+        pool.parallelFor(static_cast<std::size_t>(tilesX) * tilesY, [&](std::size_t index) {
+            const int tx = static_cast<int>(index % tilesX) * tile;
+            const int ty = static_cast<int>(index / tilesX) * tile;
+            const int x1 = std::min(tx + tile, dst.getWidth());
+            const int y1 = std::min(ty + tile, dst.getHeight());
+            for (int y = ty; y < y1; ++y) {
+                detail::warpSpan(src, mapping, dst.getRow(y) + tx * dst.getChannels(), y, tx, x1, options);
+            }
+        });
+    }
+
+} // namespace gl
+
+#endif // GL_WARP_HPP
@@ -0,0 +1,13 @@
+#version 460 core
+in vec3 DecalCoord;
+out vec4 FragColor;
+
+uniform sampler2D texture1;
+
+void main()
+{
+    if (DecalCoord.z <= 0.0) discard;
+    vec2 uv = DecalCoord.xy / DecalCoord.z;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) discard;
+    FragColor = texture(texture1, uv);
+}
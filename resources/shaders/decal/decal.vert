@@ -0,0 +1,23 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in mat3 aHomography; // per instance, locations 2-4
+
+uniform vec2 u_tileOrigin;
+uniform vec2 u_tileSize;
+uniform int u_tilesPerRow;
+
+out vec3 DecalCoord;
+
+void main()
+{
+    // Tiles fill rows right to left, starting at the bottom-right corner
+    int column = gl_InstanceID % u_tilesPerRow;
+    int row = gl_InstanceID / u_tilesPerRow;
+    vec2 center = u_tileOrigin + vec2(-float(column), float(row)) * u_tileSize;
+    gl_Position = vec4(center + aPos.xy * u_tileSize, 0.0, 1.0);
+
+    // The tile is affine on screen, so the homogeneous coordinate can be
+    // interpolated linearly and divided per fragment
+    DecalCoord = aHomography * vec3(aTexCoord, 1.0);
+}
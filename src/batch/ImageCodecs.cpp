@@ -0,0 +1,81 @@
+#include "ImageCodecs.hpp"
+#include "RecyclingAllocator.hpp"
+
+#include <cstring>
+
+#define STBI_MALLOC(size) recycling::allocate(size)
+#define STBI_REALLOC(block, size) recycling::reallocate(block, size)
+#define STBI_FREE(block) recycling::release(block)
+#define STBI_NO_STDIO
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#define STBIW_MALLOC(size) recycling::allocate(size)
+#define STBIW_REALLOC(block, size) recycling::reallocate(block, size)
+#define STBIW_FREE(block) recycling::release(block)
+#define STBI_WRITE_NO_STDIO
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <glfw/deps/stb_image_write.h>
+
+namespace codecs {
+
+    bool formatFromExtension(const std::string& extension, Format& format) {
+        if (extension == ".png") {
+            format = Format::Png;
+        }
+        else if (extension == ".jpg" || extension == ".jpeg") {
+            format = Format::Jpeg;
+        }
+        else if (extension == ".bmp") {
+            format = Format::Bmp;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    const char* getExtension(Format format) {
+        switch (format) {
+        case Format::Png: return ".png";
+        case Format::Jpeg: return ".jpg";
+        case Format::Bmp: return ".bmp";
+        }
+        return "";
+    }
+
+    bool decode(const std::vector<std::uint8_t>& bytes, gl::Image& image, std::string& error) {
+        int width = 0, height = 0, channels = 0;
+        stbi_uc* pixels = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()),
+            &width, &height, &channels, 4);
+        if (!pixels) {
+            error = stbi_failure_reason();
+            return false;
+        }
+        image.resize(width, height, 4);
+        std::memcpy(image.getData(), pixels, image.getSizeInBytes());
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    bool encode(const gl::Image& image, Format format, int quality, std::vector<std::uint8_t>& bytes) {
+        bytes.clear(); // Keeps capacity from earlier frames
+        auto append = [](void* context, void* data, int size) {
+            auto* out = static_cast<std::vector<std::uint8_t>*>(context);
+            const auto* begin = static_cast<const std::uint8_t*>(data);
+            out->insert(out->end(), begin, begin + size);
+        };
+
+        const int w = image.getWidth(), h = image.getHeight(), c = image.getChannels();
+        switch (format) {
+        case Format::Png:
+            return stbi_write_png_to_func(append, &bytes, w, h, c, image.getData(), static_cast<int>(image.getStride())) != 0;
+        case Format::Jpeg:
+            return stbi_write_jpg_to_func(append, &bytes, w, h, c, image.getData(), quality) != 0;
+        case Format::Bmp:
+            return stbi_write_bmp_to_func(append, &bytes, w, h, c, image.getData()) != 0;
+        }
+        return false;
+    }
+
+} // namespace codecs
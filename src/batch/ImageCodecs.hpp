@@ -0,0 +1,33 @@
+#ifndef IMAGE_CODECS_HPP
+#define IMAGE_CODECS_HPP
+
+#include "gl/image.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// stb_image / stb_image_write wrappers working on caller-owned buffers.
+// Codec scratch memory comes from the recycling allocator, and the image
+// and byte vectors are reused by resizing, so steady-state frames of the
+// same size allocate nothing.
+namespace codecs {
+
+    enum class Format {
+        Png,
+        Jpeg,
+        Bmp
+    };
+
+    // Format for an extension such as ".png"; false when unsupported
+    bool formatFromExtension(const std::string& extension, Format& format);
+    const char* getExtension(Format format);
+
+    // Decode any stb_image format to 8-bit RGBA
+    bool decode(const std::vector<std::uint8_t>& bytes, gl::Image& image, std::string& error);
+
+    // Encode a 1-4 channel image; quality only applies to JPEG
+    bool encode(const gl::Image& image, Format format, int quality, std::vector<std::uint8_t>& bytes);
+
+} // namespace codecs
+
+#endif // IMAGE_CODECS_HPP
@@ -0,0 +1,207 @@
+#include "RectifyPipeline.hpp"
+#include "gl/homography.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    void printUsage() {
+        std::fprintf(stderr,
+            "Usage: Rectify [options] <image files or directories...>\n"
+            "\n"
+            "Warps every input image through one homography and writes the results.\n"
+            "\n"
+            "  --size WxH             Output size in pixels (required)\n"
+            "  --quad x0,y0,...,x3,y3 Input-image corners that map to the output's top-left,\n"
+            "                         top-right, bottom-right and bottom-left corners\n"
+            "  --matrix m00,...,m22   Row-major output-to-input homography (instead of --quad)\n"
+            "  --output DIR           Output directory (default: rectified)\n"
+            "  --format png|jpg|bmp   Output format (default: png)\n"
+            "  --quality N            JPEG quality (default: 90)\n"
+            "  --threads N            Worker threads (default: all cores)\n"
+            "  --in-flight N          Frames in the pipeline at once (default: 2 x threads)\n"
+            "  --nearest              Nearest-neighbour instead of bilinear sampling\n");
+    }
+
+    bool parseFloats(const std::string& text, std::vector<float>& values) {
+        std::stringstream stream(text);
+        std::string item;
+        values.clear();
+        while (std::getline(stream, item, ',')) {
+            char* end = nullptr;
+            values.push_back(std::strtof(item.c_str(), &end));
+            if (end == item.c_str() || *end != '\0') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Regular files with an extension stb_image decodes, sorted by name
+    void collectInputs(const std::filesystem::path& path, std::vector<std::filesystem::path>& inputs) {
+        static const char* EXTENSIONS[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".psd", ".gif", ".hdr", ".pic", ".pnm", ".ppm", ".pgm" };
+        auto decodable = [](const std::filesystem::path& p) {
+            std::string extension = p.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return std::find(std::begin(EXTENSIONS), std::end(EXTENSIONS), extension) != std::end(EXTENSIONS);
+        };
+
+        if (std::filesystem::is_directory(path)) {
+            std::vector<std::filesystem::path> found;
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file() && decodable(entry.path())) {
+                    found.push_back(entry.path());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            inputs.insert(inputs.end(), found.begin(), found.end());
+        }
+        else {
+            inputs.push_back(path);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    RectifyOptions options;
+    std::filesystem::path outputDirectory = "rectified";
+    std::vector<std::filesystem::path> inputs;
+    std::vector<float> quad, matrix;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        else if (arg == "--size") {
+            if (std::sscanf(next().c_str(), "%dx%d", &options.outputWidth, &options.outputHeight) != 2) {
+                std::fprintf(stderr, "--size expects WxH\n");
+                return 2;
+            }
+        }
+        else if (arg == "--quad") {
+            if (!parseFloats(next(), quad) || quad.size() != 8) {
+                std::fprintf(stderr, "--quad expects 8 comma-separated numbers\n");
+                return 2;
+            }
+        }
+        else if (arg == "--matrix") {
+            if (!parseFloats(next(), matrix) || matrix.size() != 9) {
+                std::fprintf(stderr, "--matrix expects 9 comma-separated numbers\n");
+                return 2;
+            }
+        }
+        else if (arg == "--output") {
+            outputDirectory = next();
+        }
+        else if (arg == "--format") {
+            if (!codecs::formatFromExtension(std::string(".") + next(), options.format)) {
+                std::fprintf(stderr, "--format must be png, jpg or bmp\n");
+                return 2;
+            }
+        }
+        else if (arg == "--quality") {
+            options.quality = std::clamp(std::atoi(next().c_str()), 1, 100);
+        }
+        else if (arg == "--threads") {
+            options.threads = static_cast<std::size_t>(std::max(1, std::atoi(next().c_str())));
+        }
+        else if (arg == "--in-flight") {
+            options.inFlight = static_cast<std::size_t>(std::max(1, std::atoi(next().c_str())));
+        }
+        else if (arg == "--nearest") {
+            options.filter = gl::WarpFilter::Nearest;
+        }
+        else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            printUsage();
+            return 2;
+        }
+        else {
+            collectInputs(arg, inputs);
+        }
+    }
+
+    if (inputs.empty() || options.outputWidth <= 0 || options.outputHeight <= 0 || quad.empty() == matrix.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    if (!matrix.empty()) {
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                options.homography[c][r] = matrix[r * 3 + c];
+            }
+        }
+    }
+    else {
+        const float w = static_cast<float>(options.outputWidth - 1);
+        const float h = static_cast<float>(options.outputHeight - 1);
+        const std::array<glm::vec2, 4> rect = { glm::vec2(0, 0), glm::vec2(w, 0), glm::vec2(w, h), glm::vec2(0, h) };
+        const std::array<glm::vec2, 4> corners = {
+            glm::vec2(quad[0], quad[1]), glm::vec2(quad[2], quad[3]), glm::vec2(quad[4], quad[5]), glm::vec2(quad[6], quad[7])
+        };
+        const std::optional<glm::mat3> H = gl::solveHomographyRefined(rect, corners);
+        if (!H) {
+            std::fprintf(stderr, "--quad is degenerate\n");
+            return 2;
+        }
+        options.homography = *H;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(outputDirectory, error);
+    if (error) {
+        std::fprintf(stderr, "Couldn't create %s: %s\n", outputDirectory.string().c_str(), error.message().c_str());
+        return 1;
+    }
+
+    std::vector<RectifyJob> jobs;
+    jobs.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        jobs.push_back({ input, outputDirectory / input.stem().concat(codecs::getExtension(options.format)) });
+    }
+
+    RectifyPipeline pipeline(options);
+    const RectifyReport report = pipeline.run(jobs);
+
+    const double megapixels = static_cast<double>(report.processed) * options.outputWidth * options.outputHeight / 1e6;
+    std::printf("Rectified %zu frames (%zu failed) in %.3f s with %zu threads\n",
+        report.processed, report.failed, report.seconds, report.threads);
+    std::printf("  %.1f frames/s, %.1f output Mpix/s, %.1f MB/s in, %.1f MB/s out\n",
+        report.processed / report.seconds, megapixels / report.seconds,
+        report.inputBytes / report.seconds / 1e6, report.outputBytes / report.seconds / 1e6);
+
+    // Occupancy: share of the workers' wall time spent in each stage
+    static const char* STAGE_NAMES[] = { "read", "decode", "warp", "encode", "write" };
+    const double capacity = report.seconds * static_cast<double>(report.threads);
+    double busy = 0.0;
+    std::printf("  %-10s %10s %10s %12s\n", "stage", "total s", "ms/frame", "occupancy");
+    for (std::size_t s = 0; s < report.stageSeconds.size(); ++s) {
+        const double seconds = report.stageSeconds[s];
+        busy += seconds;
+        std::printf("  %-10s %10.3f %10.3f %11.1f%%\n", STAGE_NAMES[s], seconds,
+            report.processed ? 1e3 * seconds / report.processed : 0.0, 100.0 * seconds / capacity);
+    }
+    std::printf("  %-10s %10.3f %10s %11.1f%%\n", "all", busy, "", 100.0 * busy / capacity);
+    std::printf("  reader blocked on full pipeline: %.3f s; codec blocks from the system: %llu\n",
+        report.backpressureSeconds, static_cast<unsigned long long>(report.codecAllocations));
+
+    return report.failed == 0 ? 0 : 1;
+}
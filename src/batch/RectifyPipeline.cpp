@@ -0,0 +1,214 @@
+#include "RectifyPipeline.hpp"
+#include "RecyclingAllocator.hpp"
+#include "gl/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t elapsedNanoseconds(Clock::time_point start) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Read a whole file into bytes, reusing its capacity
+    bool readFile(const std::filesystem::path& path, std::vector<std::uint8_t>& bytes) {
+        std::FILE* file = std::fopen(path.string().c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        bool ok = std::fseek(file, 0, SEEK_END) == 0;
+        const long size = ok ? std::ftell(file) : -1;
+        ok = ok && size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+        if (ok) {
+            bytes.resize(static_cast<std::size_t>(size));
+            ok = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    bool writeFile(const std::filesystem::path& path, const std::vector<std::uint8_t>& bytes) {
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+} // namespace
+
+RectifyPipeline::RectifyPipeline(const RectifyOptions& options)
+    : options_(options) {
+    if (options_.outputWidth <= 0 || options_.outputHeight <= 0) {
+        throw std::invalid_argument("RectifyPipeline needs a positive output size");
+    }
+    if (options_.threads == 0) {
+        options_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options_.inFlight == 0) {
+        options_.inFlight = 2 * options_.threads;
+    }
+
+    pool_ = std::make_unique<gl::JobSystem>(options_.threads);
+    slots_.resize(options_.inFlight);
+    for (FrameSlot& slot : slots_) {
+        slot.rectified.resize(options_.outputWidth, options_.outputHeight, 4);
+        freeSlots_.push_back(&slot);
+    }
+}
+
+RectifyReport RectifyPipeline::run(const std::vector<RectifyJob>& jobs) {
+    jobs_ = &jobs;
+    for (auto& nanoseconds : stageNanoseconds_) {
+        nanoseconds = 0;
+    }
+    processed_ = 0;
+    failed_ = 0;
+    inputBytes_ = 0;
+    outputBytes_ = 0;
+
+    const std::uint64_t allocationsBefore = recycling::getSystemAllocationCount();
+    const auto start = Clock::now();
+    std::uint64_t waitNanoseconds = 0;
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const auto waitStart = Clock::now();
+        FrameSlot* slot = acquireSlot();
+        waitNanoseconds += elapsedNanoseconds(waitStart);
+
+        slot->job = i;
+        submitStage(slot, &RectifyPipeline::readAndDecode);
+    }
+
+    // Drain: every slot back means every frame has been written or dropped
+    {
+        std::unique_lock<std::mutex> lock(slotMutex_);
+        slotAvailable_.wait(lock, [this] { return freeSlots_.size() == slots_.size(); });
+    }
+
+    RectifyReport report;
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.processed = processed_;
+    report.failed = failed_;
+    report.inputBytes = inputBytes_;
+    report.outputBytes = outputBytes_;
+    for (std::size_t s = 0; s < report.stageSeconds.size(); ++s) {
+        report.stageSeconds[s] = static_cast<double>(stageNanoseconds_[s]) * 1e-9;
+    }
+    report.backpressureSeconds = static_cast<double>(waitNanoseconds) * 1e-9;
+    report.codecAllocations = recycling::getSystemAllocationCount() - allocationsBefore;
+    report.threads = options_.threads;
+    jobs_ = nullptr;
+    return report;
+}
+
+RectifyPipeline::FrameSlot* RectifyPipeline::acquireSlot() {
+    std::unique_lock<std::mutex> lock(slotMutex_);
+    slotAvailable_.wait(lock, [this] { return !freeSlots_.empty(); });
+    FrameSlot* slot = freeSlots_.back();
+    freeSlots_.pop_back();
+    return slot;
+}
+
+void RectifyPipeline::releaseSlot(FrameSlot* slot, bool succeeded) {
+    (succeeded ? processed_ : failed_).fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        freeSlots_.push_back(slot);
+    }
+    slotAvailable_.notify_all();
+}
+
+void RectifyPipeline::submitStage(FrameSlot* slot, void (RectifyPipeline::*stage)(FrameSlot*)) {
+    pool_->submit([this, slot, stage] {
+        // A stage that throws drops its frame; the slot has to come back
+        // either way or run() would wait for it forever
+        try {
+            (this->*stage)(slot);
+        }
+        catch (const std::exception& e) {
+            gl::logWarning("Couldn't rectify " + (*jobs_)[slot->job].input.string() + ": " + e.what());
+            releaseSlot(slot, false);
+        }
+        catch (...) {
+            gl::logWarning("Couldn't rectify " + (*jobs_)[slot->job].input.string());
+            releaseSlot(slot, false);
+        }
+    });
+}
+
+void RectifyPipeline::readAndDecode(FrameSlot* slot) {
+    const RectifyJob& job = (*jobs_)[slot->job];
+
+    auto start = Clock::now();
+    const bool read = readFile(job.input, slot->encoded);
+    addStageTime(RectifyStage::Read, elapsedNanoseconds(start));
+    if (!read) {
+        gl::logWarning("Couldn't read " + job.input.string());
+        releaseSlot(slot, false);
+        return;
+    }
+    inputBytes_.fetch_add(slot->encoded.size(), std::memory_order_relaxed);
+
+    start = Clock::now();
+    std::string error;
+    const bool decoded = codecs::decode(slot->encoded, slot->source, error);
+    addStageTime(RectifyStage::Decode, elapsedNanoseconds(start));
+    if (!decoded) {
+        gl::logWarning("Couldn't decode " + job.input.string() + ": " + error);
+        releaseSlot(slot, false);
+        return;
+    }
+
+    submitStage(slot, &RectifyPipeline::warp);
+}
+
+void RectifyPipeline::warp(FrameSlot* slot) {
+    const auto start = Clock::now();
+    gl::WarpOptions warpOptions;
+    warpOptions.filter = options_.filter;
+    warpOptions.pool = &inlinePool_;
+    gl::warpPerspective(slot->source, options_.homography, slot->rectified, warpOptions);
+    addStageTime(RectifyStage::Warp, elapsedNanoseconds(start));
+
+    submitStage(slot, &RectifyPipeline::encodeAndWrite);
+}
+
+void RectifyPipeline::encodeAndWrite(FrameSlot* slot) {
+    const RectifyJob& job = (*jobs_)[slot->job];
+
+    auto start = Clock::now();
+    // The encoded buffer is free again once decoding is done, so it takes the output
+    const bool encoded = codecs::encode(slot->rectified, options_.format, options_.quality, slot->encoded);
+    addStageTime(RectifyStage::Encode, elapsedNanoseconds(start));
+    if (!encoded) {
+        gl::logWarning("Couldn't encode " + job.output.string());
+        releaseSlot(slot, false);
+        return;
+    }
+
+    start = Clock::now();
+    const bool written = writeFile(job.output, slot->encoded);
+    addStageTime(RectifyStage::Write, elapsedNanoseconds(start));
+    if (!written) {
+        gl::logWarning("Couldn't write " + job.output.string());
+        releaseSlot(slot, false);
+        return;
+    }
+    outputBytes_.fetch_add(slot->encoded.size(), std::memory_order_relaxed);
+    releaseSlot(slot, true);
+}
+
+void RectifyPipeline::addStageTime(RectifyStage stage, std::uint64_t nanoseconds) {
+    stageNanoseconds_[static_cast<std::size_t>(stage)].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
@@ -0,0 +1,119 @@
+#ifndef RECTIFY_PIPELINE_HPP
+#define RECTIFY_PIPELINE_HPP
+
+#include "ImageCodecs.hpp"
+#include "gl/image.hpp"
+#include "gl/job_system.hpp"
+#include "gl/warp.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct RectifyJob {
+    std::filesystem::path input;
+    std::filesystem::path output;
+};
+
+struct RectifyOptions {
+    // Output pixel -> input pixel, as warpPerspective takes it
+    glm::mat3 homography = glm::mat3(1.0f);
+    int outputWidth = 0;
+    int outputHeight = 0;
+
+    codecs::Format format = codecs::Format::Png;
+    int quality = 90;
+
+    gl::WarpFilter filter = gl::WarpFilter::Bilinear;
+
+    // Worker threads for the stages
+    std::size_t threads = 0;
+
+    // Frames in the pipeline at once. Each owns a set of buffers; when all
+    // are busy the reader waits, which bounds memory and queue length.
+    std::size_t inFlight = 0;
+};
+
+enum class RectifyStage {
+    Read,
+    Decode,
+    Warp,
+    Encode,
+    Write,
+    Count
+};
+
+struct RectifyReport {
+    std::size_t processed = 0;
+    std::size_t failed = 0;
+    double seconds = 0.0;
+    std::uint64_t inputBytes = 0;
+    std::uint64_t outputBytes = 0;
+
+    // Wall time spent inside each stage, summed over workers
+    std::array<double, static_cast<std::size_t>(RectifyStage::Count)> stageSeconds = {};
+
+    // Time the reader spent waiting for a free frame slot
+    double backpressureSeconds = 0.0;
+
+    // Codec blocks taken from the system allocator during the run
+    std::uint64_t codecAllocations = 0;
+
+    std::size_t threads = 0;
+};
+
+// Rectifies a list of image files through one homography. Every frame runs
+// read + decode, warp, and encode + write as separate pool tasks, so frames
+// overlap stage by stage across the workers. Frame buffers live in a fixed
+// set of slots that are recycled, so nothing is allocated per frame once
+// the slots have grown to the frame size.
+class RectifyPipeline {
+public:
+    explicit RectifyPipeline(const RectifyOptions& options);
+
+    RectifyReport run(const std::vector<RectifyJob>& jobs);
+
+private:
+    struct FrameSlot {
+        std::size_t job = 0;
+        std::vector<std::uint8_t> encoded;
+        gl::Image source;
+        gl::Image rectified;
+    };
+
+    FrameSlot* acquireSlot();
+    void releaseSlot(FrameSlot* slot, bool succeeded);
+
+    // Queue one stage of a frame on the pool
+    void submitStage(FrameSlot* slot, void (RectifyPipeline::*stage)(FrameSlot*));
+
+    void readAndDecode(FrameSlot* slot);
+    void warp(FrameSlot* slot);
+    void encodeAndWrite(FrameSlot* slot);
+
+    void addStageTime(RectifyStage stage, std::uint64_t nanoseconds);
+
+    RectifyOptions options_;
+    const std::vector<RectifyJob>* jobs_ = nullptr;
+
+    std::unique_ptr<gl::JobSystem> pool_;
+    gl::JobSystem inlinePool_{ 0 }; // Warps run on the worker that owns the frame
+
+    std::vector<FrameSlot> slots_;
+    std::vector<FrameSlot*> freeSlots_;
+    std::mutex slotMutex_;
+    std::condition_variable slotAvailable_;
+
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(RectifyStage::Count)> stageNanoseconds_ = {};
+    std::atomic<std::size_t> processed_{ 0 };
+    std::atomic<std::size_t> failed_{ 0 };
+    std::atomic<std::uint64_t> inputBytes_{ 0 };
+    std::atomic<std::uint64_t> outputBytes_{ 0 };
+};
+
+#endif // RECTIFY_PIPELINE_HPP
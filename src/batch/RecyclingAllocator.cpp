@@ -0,0 +1,103 @@
+#include "RecyclingAllocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+    // Header in front of every block; keeps the payload 16-byte aligned
+    struct alignas(16) BlockHeader {
+        std::uint32_t sizeClass;
+        BlockHeader* next; // Free-list link while the block is cached
+    };
+
+    constexpr int CLASS_COUNT = 48;
+    constexpr std::size_t MIN_CLASS = 5; // 32-byte blocks, header included
+
+    std::atomic<std::uint64_t> systemAllocations{ 0 };
+
+    // Cached blocks per size class, owned by the thread that freed them
+    struct FreeLists {
+        BlockHeader* heads[CLASS_COUNT] = {};
+
+        ~FreeLists() {
+            for (BlockHeader*& head : heads) {
+                while (head) {
+                    BlockHeader* next = head->next;
+                    std::free(head);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    thread_local FreeLists freeLists;
+
+    std::uint32_t sizeClassFor(std::size_t size) {
+        const std::size_t total = size + sizeof(BlockHeader);
+        return static_cast<std::uint32_t>(std::max<std::size_t>(MIN_CLASS, std::bit_width(total - 1)));
+    }
+
+    std::size_t capacityOf(const BlockHeader* header) {
+        return (std::size_t(1) << header->sizeClass) - sizeof(BlockHeader);
+    }
+
+} // namespace
+
+namespace recycling {
+
+    void* allocate(std::size_t size) {
+        const std::uint32_t sizeClass = sizeClassFor(size);
+        if (sizeClass >= CLASS_COUNT) {
+            return nullptr;
+        }
+
+        BlockHeader*& head = freeLists.heads[sizeClass];
+        BlockHeader* header = head;
+        if (header) {
+            head = header->next;
+        }
+        else {
+            header = static_cast<BlockHeader*>(std::malloc(std::size_t(1) << sizeClass));
+            if (!header) {
+                return nullptr;
+            }
+            header->sizeClass = sizeClass;
+            systemAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return header + 1;
+    }
+
+    void* reallocate(void* block, std::size_t size) {
+        if (!block) {
+            return allocate(size);
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+        if (size <= capacityOf(header)) {
+            return block;
+        }
+        void* grown = allocate(size);
+        if (grown) {
+            std::memcpy(grown, block, capacityOf(header));
+            release(block);
+        }
+        return grown;
+    }
+
+    void release(void* block) {
+        if (!block) {
+            return;
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+        header->next = freeLists.heads[header->sizeClass];
+        freeLists.heads[header->sizeClass] = header;
+    }
+
+    std::uint64_t getSystemAllocationCount() {
+        return systemAllocations.load(std::memory_order_relaxed);
+    }
+
+} // namespace recycling
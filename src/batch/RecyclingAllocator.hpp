@@ -0,0 +1,23 @@
+#ifndef RECYCLING_ALLOCATOR_HPP
+#define RECYCLING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// malloc/realloc/free replacement for the stb codecs. Blocks are rounded up
+// to power-of-two size classes and, when freed, kept on a per-thread free
+// list instead of going back to the system. A worker that decodes and
+// encodes frame after frame therefore stops allocating once it has seen
+// its largest frame.
+namespace recycling {
+
+    void* allocate(std::size_t size);
+    void* reallocate(void* block, std::size_t size);
+    void release(void* block);
+
+    // Blocks obtained from the system, across all threads
+    std::uint64_t getSystemAllocationCount();
+
+} // namespace recycling
+
+#endif // RECYCLING_ALLOCATOR_HPP
@@ -0,0 +1,114 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Run fn repeatedly for at least minSeconds and return the average
+    // wall-clock seconds per call
+    template<typename F>
+    double timeIt(F&& fn, double minSeconds = 0.25) {
+        fn(); // Warm up caches and lazily-initialized state
+
+        size_t iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            fn();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return elapsed / static_cast<double>(iterations);
+    }
+
+    // Keep a value alive so the optimizer can't discard the work behind it.
+    // The value escapes to an empty asm block that may read any memory, so
+    // it has to be computed and stored first
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+
+    inline void printHeader(const std::string& title) {
+        std::printf("\n== %s ==\n", title.c_str());
+    }
+
+    // Print one result row; when baseline > 0 also print the speed-up over it
+    inline void printRow(const std::string& label, double value, const char* unit, double baseline = 0.0) {
+        if (baseline > 0.0) {
+            std::printf("  %-40s %14.3f %-10s (%.2fx)\n", label.c_str(), value, unit, value / baseline);
+        }
+        else {
+            std::printf("  %-40s %14.3f %s\n", label.c_str(), value, unit);
+        }
+    }
+
+    using Quad = std::array<glm::vec2, 4>;
+
+    // Random convex-ish quads: a unit square with jittered corners, scaled
+    // into pixel coordinates so the systems are realistically conditioned
+    inline std::vector<Quad> makeQuads(size_t count, float scale, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+        std::vector<Quad> quads(count);
+        for (auto& q : quads) {
+            q = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f),
+                  glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+            for (auto& p : q) {
+                p = (p + glm::vec2(jitter(rng), jitter(rng))) * scale;
+            }
+        }
+        return quads;
+    }
+
+    // Largest element-wise difference relative to the reference matrix norm
+    inline float maxRelativeDifference(const std::vector<glm::mat3>& a, const std::vector<glm::mat3>& ref) {
+        float worst = 0.0f;
+        for (size_t n = 0; n < a.size(); ++n) {
+            float diff = 0.0f;
+            float norm = 0.0f;
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    diff = std::max(diff, std::abs(a[n][i][j] - ref[n][i][j]));
+                    norm = std::max(norm, std::abs(ref[n][i][j]));
+                }
+            }
+            worst = std::max(worst, diff / std::max(norm, 1e-12f));
+        }
+        return worst;
+    }
+
+} // namespace bench
+
+// Suite entry points
+void runHomographyBenchmarks();
+void runWarpBenchmarks();
+void runRansacBenchmarks();
+void runComputeBenchmarks();
+void runTrackingBenchmarks();
+void runFeatureBenchmarks();
+void runEcsBenchmarks();
+
+#endif // BENCHMARK_HPP
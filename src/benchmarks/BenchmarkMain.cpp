@@ -0,0 +1,53 @@
+#include "Benchmark.hpp"
+#include "gl/simd.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+    struct Suite {
+        const char* name;
+        void (*run)();
+    };
+
+    const Suite suites[] = {
+        { "homography", runHomographyBenchmarks },
+        { "warp", runWarpBenchmarks },
+        { "ransac", runRansacBenchmarks },
+        { "compute", runComputeBenchmarks },
+        { "tracking", runTrackingBenchmarks },
+        { "features", runFeatureBenchmarks },
+        { "ecs", runEcsBenchmarks },
+    };
+
+} // namespace
+
+// Usage: Benchmarks [suite ...]   (runs every suite when none is given)
+int main(int argc, char** argv) {
+    std::printf("SIMD instruction set: %s\n", gl::simd::nativeInstructionSet());
+
+    bool ranAny = false;
+    for (const Suite& suite : suites) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], suite.name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            suite.run();
+            ranAny = true;
+        }
+    }
+
+    if (!ranAny) {
+        std::fprintf(stderr, "Unknown suite. Available:");
+        for (const Suite& suite : suites) {
+            std::fprintf(stderr, " %s", suite.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
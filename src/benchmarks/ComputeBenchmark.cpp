@@ -0,0 +1,112 @@
+#include "Benchmark.hpp"
+#include "HeadlessContext.hpp"
+#include "gl/compute_homography.hpp"
+#include "gl/homography.hpp"
+#include "gl/warp.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+    using bench::Quad;
+
+    // Fraction of pixels whose channels differ by more than two steps (GPU
+    // bilinear filtering uses fixed-point weights, so small deviations are expected)
+    double mismatchRate(const gl::Image& a, const std::vector<std::uint8_t>& b) {
+        size_t mismatches = 0;
+        const size_t pixels = a.getSizeInBytes() / 4;
+        for (size_t i = 0; i < pixels; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                if (std::abs(int(a.getData()[i * 4 + c]) - int(b[i * 4 + c])) > 2) {
+                    ++mismatches;
+                    break;
+                }
+            }
+        }
+        return static_cast<double>(mismatches) / static_cast<double>(pixels);
+    }
+
+} // namespace
+
+void runComputeBenchmarks() {
+    bench::HeadlessContext context;
+    bench::printHeader("Compute shaders");
+    if (!context.isValid()) {
+        std::printf("  skipped: %s\n", context.getDescription().c_str());
+        return;
+    }
+    std::printf("  %s\n", context.getDescription().c_str());
+
+    gl::ComputeHomographySolver solver;
+    gl::ComputeWarp warp;
+
+    for (size_t count : { 1024, 16384, 131072 }) {
+        bench::printHeader("Homography solve, " + std::to_string(count) + " systems, CPU vs compute");
+        const std::vector<Quad> src = bench::makeQuads(count, 640.0f, 1);
+        const std::vector<Quad> dst = bench::makeQuads(count, 640.0f, 2);
+        std::vector<glm::mat3> cpu(count), gpu(count);
+
+        double cpuSeconds = bench::timeIt([&] {
+            gl::computeHomographyBatch(std::span<const Quad>(src), std::span<const Quad>(dst), std::span<glm::mat3>(cpu));
+        });
+        double dispatchSeconds = bench::timeIt([&] {
+            solver.dispatch(src, dst);
+            glFinish();
+        });
+        double roundTripSeconds = bench::timeIt([&] {
+            solver.solve(src, dst, gpu);
+        });
+
+        bench::printRow(std::string("CPU batch (") + gl::simd::nativeInstructionSet() + ")", count / cpuSeconds / 1e6, "Msys/s");
+        bench::printRow("Compute, upload + dispatch", count / dispatchSeconds / 1e6, "Msys/s", count / cpuSeconds / 1e6);
+        bench::printRow("Compute, with readback", count / roundTripSeconds / 1e6, "Msys/s", count / cpuSeconds / 1e6);
+        std::printf("    max relative difference vs CPU: %.2e\n", bench::maxRelativeDifference(gpu, cpu));
+    }
+
+    // Warp a 1024x1024 RGBA image with a homography solved by the compute pass
+    gl::Image source(1024, 1024, 4);
+    std::mt19937 rng(11);
+    for (size_t i = 0; i < source.getSizeInBytes(); ++i) {
+        source.getData()[i] = static_cast<std::uint8_t>(rng());
+    }
+    gl::Texture sourceTexture;
+    sourceTexture.allocate(source.getWidth(), source.getHeight());
+    sourceTexture.setPixels(source.getData(), gl::TextureFormat::RGBA);
+
+    for (int size : { 512, 1024, 2048 }) {
+        bench::printHeader("Perspective warp " + std::to_string(size) + "x" + std::to_string(size) + ", CPU vs compute");
+        const float w = static_cast<float>(size - 1);
+        const Quad rect = { glm::vec2(0, 0), glm::vec2(w, 0), glm::vec2(w, w), glm::vec2(0, w) };
+        const Quad quad = { glm::vec2(102, 51), glm::vec2(973, 205), glm::vec2(1075, 922), glm::vec2(-51, 819) };
+        const Quad rects[] = { rect };
+        const Quad quads[] = { quad };
+        solver.dispatch(rects, quads);
+        glm::mat3 H[1];
+        solver.readResults(H);
+
+        gl::Image cpu(size, size, 4);
+        double cpuSeconds = bench::timeIt([&] {
+            gl::warpPerspective(source, H[0], cpu);
+        });
+
+        gl::Texture destination;
+        destination.allocate(size, size);
+        double gpuSeconds = bench::timeIt([&] {
+            warp.dispatch(sourceTexture, destination, solver.getResultBuffer(), 0);
+            glFinish();
+        });
+
+        std::vector<std::uint8_t> gpu(static_cast<size_t>(size) * size * 4);
+        double roundTripSeconds = bench::timeIt([&] {
+            warp.dispatch(sourceTexture, destination, solver.getResultBuffer(), 0);
+            destination.getPixels(gpu.data(), gl::TextureFormat::RGBA);
+        });
+
+        const double pixels = static_cast<double>(size) * size;
+        bench::printRow("CPU warpPerspective (default pool)", pixels / cpuSeconds / 1e6, "Mpix/s");
+        bench::printRow("Compute, dispatch", pixels / gpuSeconds / 1e6, "Mpix/s", pixels / cpuSeconds / 1e6);
+        bench::printRow("Compute, with readback", pixels / roundTripSeconds / 1e6, "Mpix/s", pixels / cpuSeconds / 1e6);
+        std::printf("    pixels differing from CPU: %.3f%%\n", mismatchRate(cpu, gpu) * 100.0);
+    }
+}
@@ -0,0 +1,517 @@
+#include "Benchmark.hpp"
+#include "HeadlessContext.hpp"
+#include "../core/BlockPool.hpp"
+#include "../core/CommandBuffer.hpp"
+#include "../core/Entity.hpp"
+#include "../core/Scene.hpp"
+#include "../core/SystemScheduler.hpp"
+#include "../core/TaskGraph.hpp"
+#include "../core/World.hpp"
+#include "../managers/ResourceManager.hpp"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+    // The same two behaviours written as polymorphic components, the way
+    // the scene's own components are, and as plain data for a World
+
+    class MotionComponent : public Component {
+    public:
+        MotionComponent(const glm::vec3& position, const glm::vec3& velocity)
+            : position_(position), velocity_(velocity) {}
+
+        void update(float deltaTime) override {
+            position_ += velocity_ * deltaTime;
+        }
+
+        const glm::vec3& getPosition() const { return position_; }
+
+    private:
+        glm::vec3 position_;
+        glm::vec3 velocity_;
+    };
+
+    class SpinComponent : public Component {
+    public:
+        explicit SpinComponent(float speed) : speed_(speed) {}
+
+        void update(float deltaTime) override {
+            angle_ += speed_ * deltaTime;
+            if (angle_ >= 360.0f) {
+                angle_ -= 360.0f;
+            }
+        }
+
+    private:
+        float angle_ = 0.0f;
+        float speed_;
+    };
+
+    struct Position {
+        glm::vec3 value;
+    };
+
+    struct Velocity {
+        glm::vec3 value;
+    };
+
+    struct Spin {
+        float angle = 0.0f;
+        float speed = 0.0f;
+    };
+
+    struct Setup {
+        glm::vec3 position;
+        glm::vec3 velocity;
+        float speed;
+    };
+
+    // Busy work standing in for a frame task of known length
+    void spinFor(double microseconds) {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double, std::micro>(microseconds);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    }
+
+    std::vector<Setup> makeSetups(std::size_t count) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<Setup> setups(count);
+        for (Setup& setup : setups) {
+            setup.position = glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f;
+            setup.velocity = glm::vec3(unit(rng), unit(rng), unit(rng));
+            setup.speed = 30.0f + 30.0f * unit(rng);
+        }
+        return setups;
+    }
+
+} // namespace
+
+void runEcsBenchmarks() {
+    bench::printHeader("Entity update: per-entity virtual calls vs archetype storage");
+
+    const std::size_t counts[] = { 1000, 10000, 100000 };
+    for (std::size_t count : counts) {
+        const std::vector<Setup> setups = makeSetups(count);
+
+        // Current path: one heap Entity per object, components behind
+        // unique_ptrs, one virtual update per component
+        std::vector<std::unique_ptr<Entity>> entities;
+        entities.reserve(count);
+        for (const Setup& setup : setups) {
+            auto entity = std::make_unique<Entity>(nullptr);
+            entity->addComponent<MotionComponent>(setup.position, setup.velocity);
+            entity->addComponent<SpinComponent>(setup.speed);
+            entities.push_back(std::move(entity));
+        }
+
+        World world;
+        for (const Setup& setup : setups) {
+            world.create(Position{ setup.position }, Velocity{ setup.velocity }, Spin{ 0.0f, setup.speed });
+        }
+
+        const double virtualSeconds = bench::timeIt([&] {
+            for (auto& entity : entities) {
+                entity->update(DELTA_TIME);
+            }
+            bench::doNotOptimize(entities.back()->getComponent<MotionComponent>()->getPosition());
+        });
+
+        const double eachSeconds = bench::timeIt([&] {
+            world.each<Position, const Velocity>([](Position& p, const Velocity& v) {
+                p.value += v.value * DELTA_TIME;
+            });
+            world.each<Spin>([](Spin& s) {
+                s.angle += s.speed * DELTA_TIME;
+                if (s.angle >= 360.0f) {
+                    s.angle -= 360.0f;
+                }
+            });
+        });
+
+        // Same work over raw chunk arrays, which the compiler can vectorize
+        const double chunkSeconds = bench::timeIt([&] {
+            world.eachChunk<Position, const Velocity>([](std::size_t n, const EntityId*, Position* p, const Velocity* v) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    p[i].value += v[i].value * DELTA_TIME;
+                }
+            });
+            world.eachChunk<Spin>([](std::size_t n, const EntityId*, Spin* s) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const float angle = s[i].angle + s[i].speed * DELTA_TIME;
+                    s[i].angle = angle >= 360.0f ? angle - 360.0f : angle;
+                }
+            });
+        });
+
+        // Throughput, so the bracketed ratio is the speed-up over the virtual path
+        const double n = static_cast<double>(count) / 1e6;
+        std::printf("  %zu entities\n", count);
+        bench::printRow("per-entity virtual update", n / virtualSeconds, "M/s");
+        bench::printRow("World::each", n / eachSeconds, "M/s", n / virtualSeconds);
+        bench::printRow("World::eachChunk", n / chunkSeconds, "M/s", n / virtualSeconds);
+    }
+
+    bench::printHeader("Component lookup, 10000 entities x 3 lookups");
+    {
+        const std::vector<Setup> setups = makeSetups(10000);
+        std::vector<std::unique_ptr<Entity>> entities;
+        // What Entity kept before dense type ids: a type_index hash map per entity
+        std::vector<std::unordered_map<std::type_index, Component*>> hashed(setups.size());
+        for (std::size_t i = 0; i < setups.size(); ++i) {
+            auto entity = std::make_unique<Entity>(nullptr);
+            hashed[i][typeid(MotionComponent)] = entity->addComponent<MotionComponent>(setups[i].position, setups[i].velocity);
+            hashed[i][typeid(SpinComponent)] = entity->addComponent<SpinComponent>(setups[i].speed);
+            entities.push_back(std::move(entity));
+        }
+
+        const double hashSeconds = bench::timeIt([&] {
+            std::size_t found = 0;
+            for (const auto& map : hashed) {
+                found += map.count(typeid(MotionComponent));
+                found += map.count(typeid(SpinComponent));
+                found += map.count(typeid(Component));
+            }
+            bench::doNotOptimize(found);
+        });
+        const double maskSeconds = bench::timeIt([&] {
+            std::size_t found = 0;
+            for (const auto& entity : entities) {
+                found += entity->getComponent<MotionComponent>() != nullptr;
+                found += entity->getComponent<SpinComponent>() != nullptr;
+                found += entity->hasComponent<Component>();
+            }
+            bench::doNotOptimize(found);
+        });
+        const double lookups = 3.0 * static_cast<double>(setups.size()) / 1e6;
+        bench::printRow("type_index hash map", lookups / hashSeconds, "M/s");
+        bench::printRow("type id mask + slot", lookups / maskSeconds, "M/s", lookups / hashSeconds);
+    }
+
+    bench::printHeader("Entity lookup by name (Scene::findEntity)");
+    if (bench::HeadlessWindow window; !window.isValid()) {
+        std::printf("  skipped: %s\n", window.getDescription().c_str());
+    }
+    else {
+        ResourceManager resources;
+        for (std::size_t count : { std::size_t(100), std::size_t(10000), std::size_t(50000) }) {
+            Scene scene(window.get(), resources);
+            std::vector<Entity*> entities; // Creation order, as the old findEntity scanned
+            entities.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                entities.push_back(scene.createEntity("Entity" + std::to_string(i)));
+            }
+            const std::string targets[] = { "Entity0", "Entity" + std::to_string(count / 2), "Entity" + std::to_string(count - 1), "Missing" };
+
+            // The old findEntity: scan in creation order comparing strings
+            const double scanSeconds = bench::timeIt([&] {
+                std::size_t found = 0;
+                for (const std::string& name : targets) {
+                    for (Entity* entity : entities) {
+                        if (entity->getName() == name) {
+                            ++found;
+                            break;
+                        }
+                    }
+                }
+                bench::doNotOptimize(found);
+            }, 0.1);
+            const double indexSeconds = bench::timeIt([&] {
+                std::size_t found = 0;
+                for (const std::string& name : targets) {
+                    found += scene.findEntity(name) != nullptr;
+                }
+                bench::doNotOptimize(found);
+            }, 0.1);
+
+            const double lookups = static_cast<double>(std::size(targets)) / 1e6;
+            std::printf("  %zu entities\n", count);
+            bench::printRow("linear scan", lookups / scanSeconds, "M/s");
+            bench::printRow("Scene::findEntity", lookups / indexSeconds, "M/s", lookups / scanSeconds);
+        }
+    }
+
+    bench::printHeader("Parallel system update, 100000 entities, by thread count");
+    {
+        struct Orientation {
+            glm::vec3 right, up, forward;
+        };
+
+        const std::vector<Setup> setups = makeSetups(100000);
+        World world;
+        for (const Setup& setup : setups) {
+            world.create(Position{ setup.position }, Velocity{ setup.velocity }, Spin{ 0.0f, setup.speed }, Orientation{});
+        }
+
+        // Motion and Bounce conflict over Velocity and run in order; Spin
+        // and Orient share the first phase with Motion
+        SystemScheduler systems;
+        systems.addSystem("Motion", makeSystemAccess<Writes<Position>, Reads<Velocity>>(), [](World& w, gl::JobSystem& jobs, float dt) {
+            w.parallelEachChunk<Position, const Velocity>(jobs, [dt](std::size_t n, const EntityId*, Position* p, const Velocity* v) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    p[i].value += v[i].value * dt;
+                }
+            });
+        });
+        systems.addSystem("Spin", makeSystemAccess<Writes<Spin>>(), [](World& w, gl::JobSystem& jobs, float dt) {
+            w.parallelEachChunk<Spin>(jobs, [dt](std::size_t n, const EntityId*, Spin* s) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const float angle = s[i].angle + s[i].speed * dt;
+                    s[i].angle = angle >= 360.0f ? angle - 360.0f : angle;
+                }
+            });
+        });
+        systems.addSystem("Orient", makeSystemAccess<Writes<Orientation>, Reads<Velocity>>(), [](World& w, gl::JobSystem& jobs, float) {
+            w.parallelEachChunk<Orientation, const Velocity>(jobs, [](std::size_t n, const EntityId*, Orientation* o, const Velocity* v) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const glm::vec3 forward = glm::normalize(v[i].value + glm::vec3(0.0f, 0.0f, 1e-3f));
+                    const glm::vec3 right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), forward) + glm::vec3(1e-3f, 0.0f, 0.0f));
+                    o[i] = { right, glm::cross(forward, right), forward };
+                }
+            });
+        });
+        systems.addSystem("Bounce", makeSystemAccess<Writes<Velocity>, Reads<Position>>(), [](World& w, gl::JobSystem& jobs, float) {
+            w.parallelEachChunk<Velocity, const Position>(jobs, [](std::size_t n, const EntityId*, Velocity* v, const Position* p) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const glm::vec3 outside = glm::step(glm::vec3(100.0f), glm::abs(p[i].value));
+                    v[i].value *= 1.0f - 2.0f * outside * glm::step(glm::vec3(0.0f), p[i].value * v[i].value);
+                }
+            });
+        });
+        std::printf("  %zu systems in %zu phases\n", systems.getSystemCount(), systems.getPhases().size());
+
+        // At least up to 4 threads, so small machines still exercise stealing;
+        // counts past the core count only show the scheduling overhead
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> threadCounts = { 1 };
+        for (std::size_t threads = 2; threads <= std::max<std::size_t>(cores, 4); threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        if (threadCounts.back() < cores) {
+            threadCounts.push_back(cores);
+        }
+
+        double serialSeconds = 0.0;
+        for (std::size_t threads : threadCounts) {
+            gl::JobSystem jobs(threads - 1);
+            const double seconds = bench::timeIt([&] {
+                systems.run(world, jobs, DELTA_TIME);
+            });
+            if (threads == 1) {
+                serialSeconds = seconds;
+            }
+            // Updates per second, so the bracketed ratio is the speed-up over one thread
+            char label[64];
+            std::snprintf(label, sizeof(label), "%zu thread(s)%s, %.3f ms", threads, threads > cores ? " oversubscribed" : "", seconds * 1e3);
+            bench::printRow(label, 1.0 / seconds, "updates/s", 1.0 / serialSeconds);
+        }
+    }
+
+    bench::printHeader("Frame task graph, synthetic frame of the demo's shape");
+    {
+        // Input -> Update -> Animation -> { HomographySolve, Culling -> RecordDraws } -> Submit -> Swap,
+        // with made-up task lengths in microseconds
+        struct Node {
+            const char* name;
+            double microseconds;
+            TaskGraph::Affinity affinity;
+        };
+        const Node nodes[] = {
+            { "Input", 20, TaskGraph::Affinity::MainThread },
+            { "Update", 150, TaskGraph::Affinity::MainThread },
+            { "Animation", 100, TaskGraph::Affinity::AnyThread },
+            { "HomographySolve", 400, TaskGraph::Affinity::AnyThread },
+            { "Culling", 150, TaskGraph::Affinity::AnyThread },
+            { "RecordDraws", 200, TaskGraph::Affinity::AnyThread },
+            { "Submit", 250, TaskGraph::Affinity::MainThread },
+            { "Swap", 30, TaskGraph::Affinity::MainThread },
+        };
+        const std::initializer_list<TaskGraph::TaskId> dependencies[] = {
+            {}, { 0 }, { 1 }, { 2 }, { 2 }, { 4 }, { 3, 5 }, { 6 }
+        };
+
+        TaskGraph graph;
+        TaskGraph emptyGraph;
+        double serialMicroseconds = 0.0;
+        for (std::size_t i = 0; i < std::size(nodes); ++i) {
+            const double microseconds = nodes[i].microseconds;
+            graph.addTask(nodes[i].name, [microseconds] { spinFor(microseconds); }, nodes[i].affinity, dependencies[i]);
+            emptyGraph.addTask(nodes[i].name, [] {}, nodes[i].affinity, dependencies[i]);
+            serialMicroseconds += microseconds;
+        }
+
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        bench::printRow("serial sum of tasks", serialMicroseconds / 1e3, "ms");
+        for (std::size_t threads : { std::size_t(1), std::size_t(2), std::size_t(4) }) {
+            gl::JobSystem jobs(threads - 1);
+            const double seconds = bench::timeIt([&] { graph.run(jobs); });
+            const double overhead = bench::timeIt([&] { emptyGraph.run(jobs); });
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "%zu thread(s)%s", threads, threads > cores ? " oversubscribed" : "");
+            bench::printRow(label, seconds * 1e3, "ms/frame");
+            bench::printRow("  scheduling overhead (empty tasks)", overhead * 1e6, "us/frame");
+        }
+        gl::JobSystem jobs;
+        graph.run(jobs);
+        std::printf("  %s\n", graph.describeCriticalPath().c_str());
+    }
+
+    bench::printHeader("Entity spawn + despawn, 10000 entities x 2 components");
+    {
+        constexpr std::size_t COUNT = 10000;
+        const std::vector<Setup> setups = makeSetups(COUNT);
+        std::vector<Entity*> spawned(COUNT);
+
+        // Heap path: every entity and component is its own allocation
+        auto spawnHeap = [&] {
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                Entity* entity = new Entity(nullptr, "Particle");
+                entity->addComponent<MotionComponent>(setups[i].position, setups[i].velocity);
+                entity->addComponent<SpinComponent>(setups[i].speed);
+                spawned[i] = entity;
+            }
+            for (Entity* entity : spawned) {
+                delete entity;
+            }
+        };
+
+        // Pooled path, as Scene::createEntity and destroyEntity do it
+        BlockPool entityPool(sizeof(Entity), alignof(Entity));
+        ComponentPools componentPools;
+        auto spawnPooled = [&] {
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                Entity* entity = new (entityPool.allocate()) Entity(nullptr, "Particle", &componentPools);
+                entity->addComponent<MotionComponent>(setups[i].position, setups[i].velocity);
+                entity->addComponent<SpinComponent>(setups[i].speed);
+                spawned[i] = entity;
+            }
+            for (Entity* entity : spawned) {
+                entity->~Entity();
+                entityPool.deallocate(entity);
+            }
+        };
+
+        // Pools only reach the global allocator for new slabs, so their slab
+        // counts give the pooled path's allocations once warm. The heap path
+        // makes one for the entity and one per component by construction.
+        spawnPooled();
+        const std::size_t slabsBefore = entityPool.getSlabCount() + componentPools.getSlabCount();
+        spawnPooled();
+        const std::size_t slabsAfter = entityPool.getSlabCount() + componentPools.getSlabCount();
+        const double pooledAllocationsPerEntity = static_cast<double>(slabsAfter - slabsBefore) / COUNT;
+        const double heapAllocationsPerEntity = 3.0;
+        const double heapSeconds = bench::timeIt(spawnHeap);
+        const double pooledSeconds = bench::timeIt(spawnPooled);
+
+        bench::printRow("heap: allocations (entity + components)", heapAllocationsPerEntity, "per entity");
+        bench::printRow("pooled: allocations", pooledAllocationsPerEntity, "per entity");
+        bench::printRow("heap: spawn + despawn", COUNT / heapSeconds / 1e6, "M/s");
+        bench::printRow("pooled: spawn + despawn", COUNT / pooledSeconds / 1e6, "M/s", COUNT / heapSeconds / 1e6);
+        std::printf("  pools hold %zu entity + %zu component slabs\n", entityPool.getSlabCount(), componentPools.getSlabCount());
+    }
+
+    bench::printHeader("Deferred despawn + respawn wave from a parallel system, 100000 entities");
+    {
+        const std::vector<Setup> setups = makeSetups(100000);
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+        // Every wave replaces the half of the entities with odd ids, so the
+        // world stays at the same size from wave to wave
+        for (std::size_t threads : { std::size_t(1), std::size_t(4) }) {
+            gl::JobSystem jobs(threads - 1);
+
+            World lockedWorld;
+            World bufferedWorld;
+            for (const Setup& setup : setups) {
+                lockedWorld.create(Position{ setup.position }, Velocity{ setup.velocity });
+                bufferedWorld.create(Position{ setup.position }, Velocity{ setup.velocity });
+            }
+
+            // Baseline: closures pushed onto one mutex-guarded queue
+            std::mutex queueMutex;
+            std::vector<std::function<void(World&)>> queue;
+            const double lockedSeconds = bench::timeIt([&] {
+                lockedWorld.parallelEachChunk<const Position, const Velocity>(jobs,
+                    [&](std::size_t n, const EntityId* ids, const Position* p, const Velocity* v) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            if (ids[i] & 1) {
+                                std::lock_guard<std::mutex> lock(queueMutex);
+                                queue.push_back([id = ids[i]](World& w) { w.destroy(id); });
+                                queue.push_back([p = p[i], v = v[i]](World& w) { w.create(p, v); });
+                            }
+                        }
+                    });
+                for (auto& command : queue) {
+                    command(lockedWorld);
+                }
+                queue.clear();
+            });
+
+            CommandBuffer commands;
+            const double bufferedSeconds = bench::timeIt([&] {
+                bufferedWorld.parallelEachChunk<const Position, const Velocity>(jobs,
+                    [&](std::size_t n, const EntityId* ids, const Position* p, const Velocity* v) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            if (ids[i] & 1) {
+                                commands.destroy(ids[i]);
+                                commands.create(p[i], v[i]);
+                            }
+                        }
+                    });
+                commands.apply(bufferedWorld);
+            });
+
+            const double changes = lockedWorld.size() / 1e6; // One despawn and one respawn per two entities
+            std::printf("  %zu thread(s)%s, %zu entities\n", threads, threads > cores ? " oversubscribed" : "", bufferedWorld.size());
+            bench::printRow("mutex + std::function queue", changes / lockedSeconds, "M changes/s");
+            bench::printRow("CommandBuffer", changes / bufferedSeconds, "M changes/s", changes / lockedSeconds);
+        }
+    }
+
+    bench::printHeader("Structural changes, 100000 entities");
+    {
+        const std::vector<Setup> setups = makeSetups(100000);
+        World world;
+        std::vector<EntityId> ids;
+        ids.reserve(setups.size());
+
+        const double createSeconds = bench::timeIt([&] {
+            for (EntityId id : ids) {
+                world.destroy(id);
+            }
+            ids.clear();
+            for (const Setup& setup : setups) {
+                ids.push_back(world.create(Position{ setup.position }, Velocity{ setup.velocity }));
+            }
+        });
+        bench::printRow("destroy + create", createSeconds * 1e9 / setups.size(), "ns/entity");
+
+        const double addSeconds = bench::timeIt([&] {
+            for (EntityId id : ids) {
+                world.add(id, Spin{ 0.0f, 45.0f });
+            }
+            for (EntityId id : ids) {
+                world.remove<Spin>(id);
+            }
+        });
+        bench::printRow("add + remove component", addSeconds * 1e9 / setups.size(), "ns/entity");
+    }
+}
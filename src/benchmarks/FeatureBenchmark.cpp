@@ -0,0 +1,153 @@
+#include "Benchmark.hpp"
+#include "gl/features.hpp"
+#include "gl/homography.hpp"
+#include "gl/projection.hpp"
+#include "gl/warp.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr int WIDTH = 1920;
+    constexpr int HEIGHT = 1080;
+
+    // RGBA noise smoothed with a separable box filter (three passes of radius
+    // 2), giving blob-like texture with plenty of corners
+    gl::Image makeFrame(unsigned seed) {
+        std::mt19937 rng(seed);
+        const size_t count = static_cast<size_t>(WIDTH) * HEIGHT;
+        std::vector<float> a(count), b(count);
+        for (float& v : a) {
+            v = static_cast<float>(rng() & 255);
+        }
+        for (int pass = 0; pass < 3; ++pass) {
+            for (int y = 0; y < HEIGHT; ++y) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    float sum = 0.0f;
+                    for (int d = -2; d <= 2; ++d) {
+                        sum += a[static_cast<size_t>(y) * WIDTH + std::clamp(x + d, 0, WIDTH - 1)];
+                    }
+                    b[static_cast<size_t>(y) * WIDTH + x] = sum / 5.0f;
+                }
+            }
+            for (int y = 0; y < HEIGHT; ++y) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    float sum = 0.0f;
+                    for (int d = -2; d <= 2; ++d) {
+                        sum += b[static_cast<size_t>(std::clamp(y + d, 0, HEIGHT - 1)) * WIDTH + x];
+                    }
+                    a[static_cast<size_t>(y) * WIDTH + x] = sum / 5.0f;
+                }
+            }
+        }
+
+        const auto [lo, hi] = std::minmax_element(a.begin(), a.end());
+        const float scale = 255.0f / std::max(*hi - *lo, 1.0f);
+        gl::Image image(WIDTH, HEIGHT, 4);
+        for (size_t i = 0; i < count; ++i) {
+            const auto v = static_cast<std::uint8_t>((a[i] - *lo) * scale);
+            image.getData()[i * 4 + 0] = v;
+            image.getData()[i * 4 + 1] = v;
+            image.getData()[i * 4 + 2] = v;
+            image.getData()[i * 4 + 3] = 255;
+        }
+        return image;
+    }
+
+    double cornerError(const glm::mat3& a, const glm::mat3& b) {
+        const glm::vec2 corners[] = { {0, 0}, {WIDTH, 0}, {WIDTH, HEIGHT}, {0, HEIGHT} };
+        double sum = 0.0;
+        for (const glm::vec2& p : corners) {
+            sum += glm::length(gl::projectPoint(a, p) - gl::projectPoint(b, p));
+        }
+        return sum / 4.0;
+    }
+
+} // namespace
+
+void runFeatureBenchmarks() {
+    // The frame sees the reference plane turned by ~8 degrees and in mild perspective
+    const gl::Image reference = makeFrame(5);
+    const std::array<glm::vec2, 4> rect = { glm::vec2(0, 0), glm::vec2(WIDTH, 0), glm::vec2(WIDTH, HEIGHT), glm::vec2(0, HEIGHT) };
+    const std::array<glm::vec2, 4> seen = { glm::vec2(140, -60), glm::vec2(1980, 130), glm::vec2(1850, 1150), glm::vec2(-20, 1010) };
+    const glm::mat3 truth = gl::computeHomography(rect, seen);
+    gl::Image frame(WIDTH, HEIGHT, 4);
+    gl::warpPerspective(reference, gl::inverseHomography(truth), frame);
+
+    gl::JobSystem serial(0);
+    gl::FeatureOptions one;
+    one.pool = &serial;
+    gl::FeatureOptions pooled;
+    const std::string simdName = gl::simd::nativeInstructionSet();
+
+    bench::printHeader("Feature pipeline stages, " + std::to_string(WIDTH) + "x" + std::to_string(HEIGHT));
+
+    gl::Image referenceGray, gray;
+    double graySeconds = bench::timeIt([&] { gray = gl::toGrayscale(frame); });
+    referenceGray = gl::toGrayscale(reference);
+    bench::printRow("Grayscale conversion", 1e3 * graySeconds, "ms");
+
+    std::vector<gl::Keypoint> keypoints;
+    double fastScalar = bench::timeIt([&] { keypoints = gl::detectFast<gl::simd::ByteX1>(gray, one); });
+    double fastSimd = bench::timeIt([&] { keypoints = gl::detectFast(gray, one); });
+    double fastPooled = bench::timeIt([&] { keypoints = gl::detectFast(gray, pooled); });
+    bench::printRow("FAST, scalar", 1e3 * fastScalar, "ms");
+    bench::printRow("FAST, " + simdName, 1e3 * fastSimd, "ms");
+    bench::printRow("FAST, " + simdName + ", default pool", 1e3 * fastPooled, "ms");
+    std::printf("    %zu keypoints\n", keypoints.size());
+
+    std::vector<gl::Descriptor> descriptors;
+    auto describe = [&]<typename V>(const gl::FeatureOptions& options) {
+        std::vector<gl::Keypoint> k = keypoints;
+        return bench::timeIt([&] {
+            k = keypoints;
+            descriptors = gl::computeDescriptors<V>(gray, k, options);
+        });
+    };
+    double briefScalar = describe.template operator()<gl::simd::FloatX1>(one);
+    double briefSimd = describe.template operator()<gl::simd::NativeFloat>(one);
+    double briefPooled = describe.template operator()<gl::simd::NativeFloat>(pooled);
+    bench::printRow("Orientation + BRIEF, scalar", 1e3 * briefScalar, "ms");
+    bench::printRow("Orientation + BRIEF, " + simdName + " gathers", 1e3 * briefSimd, "ms");
+    bench::printRow("Orientation + BRIEF, default pool", 1e3 * briefPooled, "ms");
+
+    const gl::FeatureSet referenceFeatures = gl::extractFeatures(referenceGray);
+    const gl::FeatureSet frameFeatures = gl::extractFeatures(gray);
+
+    std::vector<gl::Match> matches;
+    auto match = [&]<typename V>(gl::JobSystem* pool) {
+        gl::MatchOptions options;
+        options.pool = pool;
+        return bench::timeIt([&] {
+            matches = gl::matchDescriptors<V>(referenceFeatures.descriptors, frameFeatures.descriptors, options);
+        });
+    };
+    double matchScalar = match.template operator()<gl::simd::FloatX1>(&serial);
+    double matchSimd = match.template operator()<gl::simd::NativeFloat>(&serial);
+    double matchPooled = match.template operator()<gl::simd::NativeFloat>(nullptr);
+    const double pairs = static_cast<double>(referenceFeatures.descriptors.size()) * frameFeatures.descriptors.size();
+    bench::printRow("Hamming matching, popcount", pairs / matchScalar / 1e6, "Mpairs/s");
+    bench::printRow("Hamming matching, " + simdName, pairs / matchSimd / 1e6, "Mpairs/s", pairs / matchScalar / 1e6);
+    bench::printRow("Hamming matching, default pool", pairs / matchPooled / 1e6, "Mpairs/s", pairs / matchScalar / 1e6);
+    std::printf("    %zu x %zu descriptors, %zu matches after ratio test\n",
+        referenceFeatures.descriptors.size(), frameFeatures.descriptors.size(), matches.size());
+
+    gl::ImageRegistration registration;
+    double registerSeconds = bench::timeIt([&] { registration = gl::registerFeatures(referenceFeatures, frameFeatures); });
+    bench::printRow("Match + RANSAC + refine", 1e3 * registerSeconds, "ms");
+
+    // End to end: the frame arrives as RGBA, the reference features are cached
+    double totalSeconds = bench::timeIt([&] {
+        const gl::Image g = gl::toGrayscale(frame);
+        registration = gl::registerFeatures(referenceFeatures, gl::extractFeatures(g));
+    });
+    bench::printRow("Frame latency (default pool)", 1e3 * totalSeconds, "ms");
+
+    // The decal corners mapped into the frame feed HomographyCalculator as usual
+    gl::HomographyCalculator calculator;
+    const glm::mat3 H = calculator.compute(rect, registration.mapQuad(rect), false);
+    std::printf("    %zu inliers of %zu matches, corner error %.3f px\n",
+        registration.inlierCount, registration.matches.size(), cornerError(H, truth));
+}
@@ -0,0 +1,149 @@
+#include "HeadlessContext.hpp"
+#include "../window/Window.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#ifdef BENCHMARKS_USE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <stdexcept>
+
+namespace bench {
+
+    namespace {
+
+        constexpr int VERSIONS[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 } };
+
+    } // namespace
+
+#ifdef BENCHMARKS_USE_EGL
+
+    HeadlessContext::HeadlessContext() {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        EGLDisplay display = getPlatformDisplay
+            ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+            : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+            description_ = "EGL display unavailable";
+            return;
+        }
+        display_ = display;
+        eglBindAPI(EGL_OPENGL_API);
+
+        EGLContext context = EGL_NO_CONTEXT;
+        for (const auto& version : VERSIONS) {
+            const EGLint attributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, version[0],
+                EGL_CONTEXT_MINOR_VERSION, version[1],
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+            };
+            context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+            if (context != EGL_NO_CONTEXT) break;
+        }
+        if (context == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            description_ = "No OpenGL 4.3+ context through EGL";
+            return;
+        }
+        context_ = context;
+
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+            description_ = "Failed to load OpenGL functions";
+            return;
+        }
+        valid_ = true;
+        description_ = std::string(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) +
+            ", OpenGL " + reinterpret_cast<const char*>(glGetString(GL_VERSION)) + " (EGL surfaceless)";
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        if (display_) {
+            EGLDisplay display = static_cast<EGLDisplay>(display_);
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context_) {
+                eglDestroyContext(display, static_cast<EGLContext>(context_));
+            }
+            eglTerminate(display);
+        }
+    }
+
+#else
+
+    HeadlessContext::HeadlessContext() {
+        if (!glfwInit()) {
+            description_ = "GLFW initialization failed";
+            return;
+        }
+        display_ = this; // Marks GLFW as initialized for the destructor
+
+        GLFWwindow* window = nullptr;
+        for (const auto& version : VERSIONS) {
+            glfwDefaultWindowHints();
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            window = glfwCreateWindow(64, 64, "Benchmarks", nullptr, nullptr);
+            if (window) break;
+        }
+        if (!window) {
+            description_ = "No OpenGL 4.3+ context through GLFW";
+            return;
+        }
+        context_ = window;
+        glfwMakeContextCurrent(window);
+
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+            description_ = "Failed to load OpenGL functions";
+            return;
+        }
+        valid_ = true;
+        description_ = std::string(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) +
+            ", OpenGL " + reinterpret_cast<const char*>(glGetString(GL_VERSION)) + " (hidden GLFW window)";
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        if (context_) {
+            glfwDestroyWindow(static_cast<GLFWwindow*>(context_));
+        }
+        if (display_) {
+            glfwTerminate();
+        }
+    }
+
+#endif
+
+    HeadlessWindow::HeadlessWindow() {
+        if (!glfwInit()) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            if (!glfwInit()) {
+                description_ = "GLFW initialization failed";
+                return;
+            }
+        }
+        initialized_ = true;
+
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        try {
+            window_ = std::make_unique<Window>(64, 64, "Headless");
+        }
+        catch (const std::runtime_error& e) {
+            description_ = e.what();
+        }
+    }
+
+    HeadlessWindow::~HeadlessWindow() {
+        window_.reset();
+        if (initialized_) {
+            glfwTerminate();
+        }
+    }
+
+} // namespace bench
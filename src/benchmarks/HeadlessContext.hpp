@@ -0,0 +1,60 @@
+#ifndef HEADLESS_CONTEXT_HPP
+#define HEADLESS_CONTEXT_HPP
+
+#include <memory>
+#include <string>
+
+class Window;
+
+namespace bench {
+
+    // Offscreen OpenGL context for GPU benchmark suites. Uses EGL's
+    // surfaceless platform where available (runs on Mesa llvmpipe without a
+    // display server) and a hidden GLFW window otherwise. Asks for the newest
+    // core profile it can get, down to the 4.3 minimum needed for compute.
+    class HeadlessContext {
+    public:
+        HeadlessContext();
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+        bool isValid() const { return valid_; }
+
+        // Renderer and version strings, or the reason creation failed
+        const std::string& getDescription() const { return description_; }
+
+    private:
+        bool valid_ = false;
+        std::string description_;
+        void* display_ = nullptr;
+        void* context_ = nullptr;
+    };
+
+    // A Window for code that needs one, such as Scene, but never draws to
+    // it: hidden and without a GL context of its own. Without a display
+    // server GLFW's null platform stands in, which it never picks by itself
+    class HeadlessWindow {
+    public:
+        HeadlessWindow();
+        ~HeadlessWindow();
+
+        HeadlessWindow(const HeadlessWindow&) = delete;
+        HeadlessWindow& operator=(const HeadlessWindow&) = delete;
+
+        bool isValid() const { return window_ != nullptr; }
+        Window& get() { return *window_; }
+
+        // Why creation failed, if it did
+        const std::string& getDescription() const { return description_; }
+
+    private:
+        bool initialized_ = false;
+        std::unique_ptr<Window> window_;
+        std::string description_;
+    };
+
+} // namespace bench
+
+#endif // HEADLESS_CONTEXT_HPP
@@ -0,0 +1,339 @@
+#include "Benchmark.hpp"
+#include "gl/decomposition.hpp"
+#include "gl/homography.hpp"
+#include "gl/projection.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+    using bench::Quad;
+
+    template<typename V>
+    void benchBatch(const char* label, const std::vector<Quad>& src, const std::vector<Quad>& dst,
+        const std::vector<glm::mat3>& reference, double baseline) {
+        std::vector<glm::mat3> out(src.size());
+        double seconds = bench::timeIt([&] {
+            gl::computeHomographyBatch<V>(src, dst, out);
+            bench::doNotOptimize(out);
+        });
+        bench::printRow(label, src.size() / seconds / 1e6, "Msys/s", baseline);
+        std::printf("  %-40s %14.2e\n", "  max relative error", bench::maxRelativeDifference(out, reference));
+    }
+
+    // Reference solve in double (LU with partial pivoting on the raw system)
+    glm::dmat3 solveDouble(const Quad& src, const Quad& dst) {
+        double A[8][9] = {};
+        for (int i = 0; i < 4; ++i) {
+            const double x = src[i].x, y = src[i].y, u = dst[i].x, v = dst[i].y;
+            double rx[9] = { x, y, 1, 0, 0, 0, -x * u, -y * u, u };
+            double ry[9] = { 0, 0, 0, x, y, 1, -x * v, -y * v, v };
+            std::copy(rx, rx + 9, A[2 * i]);
+            std::copy(ry, ry + 9, A[2 * i + 1]);
+        }
+        for (int i = 0; i < 8; ++i) {
+            int p = i;
+            for (int j = i + 1; j < 8; ++j) {
+                if (std::abs(A[j][i]) > std::abs(A[p][i])) p = j;
+            }
+            std::swap(A[i], A[p]);
+            for (int j = i + 1; j < 8; ++j) {
+                const double m = A[j][i] / A[i][i];
+                for (int k = i; k < 9; ++k) A[j][k] -= m * A[i][k];
+            }
+        }
+        double h[8];
+        for (int i = 7; i >= 0; --i) {
+            double s = A[i][8];
+            for (int j = i + 1; j < 8; ++j) s -= A[i][j] * h[j];
+            h[i] = s / A[i][i];
+        }
+        return glm::dmat3(h[0], h[3], h[6], h[1], h[4], h[7], h[2], h[5], 1.0);
+    }
+
+    // Worst distance, in pixels, between dst corners and src corners mapped
+    // (in double) through each float homography
+    double maxCornerError(const std::vector<glm::mat3>& Hs, const std::vector<Quad>& src, const std::vector<Quad>& dst) {
+        double worst = 0.0;
+        for (size_t n = 0; n < Hs.size(); ++n) {
+            const glm::dmat3 H(Hs[n]);
+            for (int i = 0; i < 4; ++i) {
+                const glm::dvec3 p = H * glm::dvec3(src[n][i], 1.0);
+                worst = std::max(worst, glm::length(glm::dvec2(p) / p.z - glm::dvec2(dst[n][i])));
+            }
+        }
+        return worst;
+    }
+
+} // namespace
+
+void runHomographyBenchmarks() {
+    for (size_t count : { size_t(64), size_t(1024), size_t(16384) }) {
+        bench::printHeader("Homography solve, " + std::to_string(count) + " systems");
+
+        auto src = bench::makeQuads(count, 1.0f, 1);
+        auto dst = bench::makeQuads(count, 512.0f, 2);
+
+        // Per-call path (cache disabled so every call solves)
+        gl::HomographyCalculator calculator;
+        std::vector<glm::mat3> reference(count);
+        double perCall = bench::timeIt([&] {
+            for (size_t n = 0; n < count; ++n) {
+                reference[n] = calculator.compute(src[n], dst[n], false);
+            }
+            bench::doNotOptimize(reference);
+        });
+        double baseline = count / perCall / 1e6;
+        bench::printRow("HomographyCalculator::compute", baseline, "Msys/s");
+
+        benchBatch<gl::simd::FloatX1>("computeHomographyBatch (scalar)", src, dst, reference, baseline);
+#ifdef GL_SIMD_SSE2
+        benchBatch<gl::simd::FloatX4>("computeHomographyBatch (SSE2 x4)", src, dst, reference, baseline);
+#endif
+#ifdef __AVX2__
+        benchBatch<gl::simd::FloatX8>("computeHomographyBatch (AVX2 x8)", src, dst, reference, baseline);
+#endif
+#ifdef __AVX512F__
+        benchBatch<gl::simd::FloatX16>("computeHomographyBatch (AVX-512 x16)", src, dst, reference, baseline);
+#endif
+    }
+
+    // Small quads at 4K pixel coordinates far from the origin, where the raw
+    // float system loses most of its digits. Corner errors include rounding
+    // the result to a float matrix, which is the floor every path shares.
+    {
+        const size_t count = 16384;
+        bench::printHeader("Mixed-precision solve, 4K coordinates, " + std::to_string(count) + " systems");
+        auto src = bench::makeQuads(count, 120.0f, 3);
+        auto dst = bench::makeQuads(count, 120.0f, 4);
+        for (size_t n = 0; n < count; ++n) {
+            for (int i = 0; i < 4; ++i) {
+                src[n][i] += glm::vec2(2600.0f, 1200.0f);
+                dst[n][i] += glm::vec2(2900.0f, 1100.0f);
+            }
+        }
+
+        std::vector<glm::mat3> exact(count), out(count);
+        double reference = bench::timeIt([&] {
+            for (size_t n = 0; n < count; ++n) {
+                exact[n] = glm::mat3(solveDouble(src[n], dst[n]));
+            }
+            bench::doNotOptimize(exact);
+        });
+        const double baseline = count / reference / 1e6;
+        bench::printRow("Double LU (scalar)", baseline, "Msys/s");
+        std::printf("  %-40s %14.2e px\n", "  max corner error", maxCornerError(exact, src, dst));
+
+        double plain = bench::timeIt([&] { gl::computeHomographyBatch(src, dst, out); });
+        bench::printRow("computeHomographyBatch (float)", count / plain / 1e6, "Msys/s", baseline);
+        std::printf("  %-40s %14.2e px, %.2e from double\n", "  max corner error",
+            maxCornerError(out, src, dst), bench::maxRelativeDifference(out, exact));
+
+        std::vector<float> conditions(count);
+        for (int steps : { 0, 1, 2 }) {
+            double seconds = bench::timeIt([&] {
+                gl::computeHomographyBatchRefined(src, dst, out, std::span<float>(conditions), steps);
+            });
+            bench::printRow("Refined batch, " + std::to_string(steps) + " step(s)", count / seconds / 1e6, "Msys/s", baseline);
+            std::printf("  %-40s %14.2e px, %.2e from double\n", "  max corner error",
+                maxCornerError(out, src, dst), bench::maxRelativeDifference(out, exact));
+        }
+        std::printf("    condition estimate: median %.1f, max %.1f\n",
+            [&] { auto c = conditions; std::nth_element(c.begin(), c.begin() + c.size() / 2, c.end()); return c[c.size() / 2]; }(),
+            *std::max_element(conditions.begin(), conditions.end()));
+    }
+
+    // Unit square to quad, the HomographyEffect case: closed form vs the LU solve
+    {
+        const size_t count = 4096;
+        bench::printHeader("Unit square -> quad, " + std::to_string(count) + " systems");
+
+        const Quad square = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f),
+                              glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+        auto src = bench::makeQuads(count, 1.0f, 3);
+        auto dst = bench::makeQuads(count, 512.0f, 4);
+        gl::HomographyCalculator calculator;
+        std::vector<glm::mat3> out(count);
+
+        double lu = bench::timeIt([&] {
+            for (size_t n = 0; n < count; ++n) {
+                out[n] = calculator.compute(src[n], dst[n], false);
+            }
+            bench::doNotOptimize(out);
+        });
+        double baseline = count / lu / 1e6;
+        bench::printRow("compute, general quad (LU)", baseline, "Msys/s");
+
+        double closedForm = bench::timeIt([&] {
+            for (size_t n = 0; n < count; ++n) {
+                out[n] = calculator.compute(square, dst[n], false);
+            }
+            bench::doNotOptimize(out);
+        });
+        bench::printRow("compute, unit square (closed form)", count / closedForm / 1e6, "Msys/s", baseline);
+
+        std::vector<gl::HomographyPair> pairs(count);
+        double withInverse = bench::timeIt([&] {
+            for (size_t n = 0; n < count; ++n) {
+                pairs[n] = calculator.computeWithInverse(square, dst[n], false);
+            }
+            bench::doNotOptimize(pairs);
+        });
+        bench::printRow("computeWithInverse, unit square", count / withInverse / 1e6, "Msys/s", baseline);
+    }
+
+    // Recurring-quad workload through the cache at several capacities
+    {
+        const size_t distinct = 256;
+        const size_t lookups = 20000;
+        bench::printHeader("Homography cache, " + std::to_string(distinct) + " recurring quads");
+
+        auto src = bench::makeQuads(distinct, 1.0f, 5);
+        auto dst = bench::makeQuads(distinct, 512.0f, 6);
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<size_t> pick(0, distinct - 1);
+        std::vector<size_t> sequence(lookups);
+        for (auto& i : sequence) {
+            i = pick(rng);
+        }
+
+        double baseline = 0.0;
+        for (size_t capacity : { size_t(0), size_t(4), size_t(64), size_t(512) }) {
+            gl::HomographyCalculator calculator(capacity);
+            glm::mat3 sink(0.0f);
+            double seconds = bench::timeIt([&] {
+                for (size_t i : sequence) {
+                    sink += calculator.compute(src[i], dst[i], capacity > 0);
+                }
+                bench::doNotOptimize(sink);
+            });
+
+            double rate = lookups / seconds / 1e6;
+            if (capacity == 0) {
+                baseline = rate;
+                bench::printRow("no cache", rate, "Mlookups/s");
+                continue;
+            }
+
+            auto stats = calculator.getCacheStats();
+            bench::printRow("capacity " + std::to_string(capacity), rate, "Mlookups/s", baseline);
+            std::printf("    hit rate %.1f%%, %llu evictions\n", stats.hitRate() * 100.0,
+                static_cast<unsigned long long>(stats.evictions));
+        }
+    }
+
+    // Point projection: hand-written glm loop vs the batched API
+    gl::JobSystem serial(0);
+    const glm::mat3 H = gl::computeHomography(bench::makeQuads(1, 640.0f, 9)[0], bench::makeQuads(1, 640.0f, 10)[0]);
+    for (size_t count : { 1000, 100000, 1000000 }) {
+        bench::printHeader("Point projection, " + std::to_string(count) + " points");
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float> coord(0.0f, 640.0f);
+        std::vector<glm::vec2> points(count), projected(count);
+        for (auto& p : points) {
+            p = glm::vec2(coord(rng), coord(rng));
+        }
+
+        double loop = bench::timeIt([&] {
+            for (size_t i = 0; i < count; ++i) {
+                glm::vec3 q = H * glm::vec3(points[i], 1.0f);
+                projected[i] = glm::vec2(q) / q.z;
+            }
+            bench::doNotOptimize(projected);
+        });
+        double scalar = bench::timeIt([&] {
+            gl::projectPoints<gl::simd::FloatX1>(H, points, projected, &serial);
+        });
+        double simd = bench::timeIt([&] {
+            gl::projectPoints(H, points, projected, &serial);
+        });
+        double pooled = bench::timeIt([&] {
+            gl::projectPoints(H, points, projected);
+        });
+        bench::printRow("glm loop", count / loop / 1e6, "Mpts/s");
+        bench::printRow("projectPoints, scalar lanes", count / scalar / 1e6, "Mpts/s", count / loop / 1e6);
+        bench::printRow(std::string("projectPoints, ") + gl::simd::nativeInstructionSet(), count / simd / 1e6, "Mpts/s", count / loop / 1e6);
+        bench::printRow("projectPoints, default pool", count / pooled / 1e6, "Mpts/s", count / loop / 1e6);
+    }
+
+    // Many matrices with a few points each, as when reprojecting decal corners
+    {
+        const size_t decals = 20000;
+        bench::printHeader("Decal corners, " + std::to_string(decals) + " homographies x 4 points");
+        std::vector<glm::mat3> matrices;
+        for (const Quad& q : bench::makeQuads(decals, 640.0f, 12)) {
+            matrices.push_back(gl::computeHomography(Quad{ glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1) }, q));
+        }
+        const std::vector<glm::vec2> corners = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+        std::vector<glm::vec2> projected(decals * corners.size());
+
+        double loop = bench::timeIt([&] {
+            for (size_t m = 0; m < decals; ++m) {
+                for (size_t i = 0; i < corners.size(); ++i) {
+                    glm::vec3 q = matrices[m] * glm::vec3(corners[i], 1.0f);
+                    projected[m * corners.size() + i] = glm::vec2(q) / q.z;
+                }
+            }
+            bench::doNotOptimize(projected);
+        });
+        double simd = bench::timeIt([&] {
+            gl::projectPoints(std::span<const glm::mat3>(matrices), corners, projected, &serial);
+        });
+        bench::printRow("glm loop", projected.size() / loop / 1e6, "Mpts/s");
+        bench::printRow("projectPoints (many matrices)", projected.size() / simd / 1e6, "Mpts/s", projected.size() / loop / 1e6);
+    }
+
+    // Plane poses from homographies, as for AR overlays on many planes per frame
+    for (size_t planes : { size_t(64), size_t(16384) }) {
+        bench::printHeader("Pose decomposition, " + std::to_string(planes) + " planes");
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+        const gl::CameraIntrinsics K = gl::intrinsicsFromProjection(projection, glm::vec2(800.0f, 600.0f));
+
+        // Random planes in front of the camera, H = s * K [r1 r2 t] with a
+        // random scale (including its sign) as a solver would return
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<glm::mat4> truth(planes);
+        std::vector<glm::mat3> homographies(planes);
+        for (size_t i = 0; i < planes; ++i) {
+            glm::vec3 axis = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+            glm::mat4 pose = glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng), unit(rng), -4.0f + unit(rng)));
+            truth[i] = glm::rotate(pose, unit(rng) * 1.2f, axis);
+            glm::mat3 Rt(glm::vec3(truth[i][0]), glm::vec3(truth[i][1]), glm::vec3(truth[i][3]));
+            float s = unit(rng) * 10.0f;
+            homographies[i] = K.toMatrix() * Rt * (std::abs(s) < 0.1f ? 1.0f : s);
+        }
+
+        std::vector<gl::HomographyPose> poses(planes);
+        double single = bench::timeIt([&] {
+            for (size_t i = 0; i < planes; ++i) {
+                poses[i] = *gl::decomposeHomography(homographies[i], K).pose();
+            }
+            bench::doNotOptimize(poses);
+        });
+        double scalar = bench::timeIt([&] {
+            gl::decomposeHomographyBatch<gl::simd::FloatX1>(homographies, K, poses);
+        });
+        double simd = bench::timeIt([&] {
+            gl::decomposeHomographyBatch(homographies, K, poses);
+        });
+
+        float rotationError = 0.0f, translationError = 0.0f;
+        for (size_t i = 0; i < planes; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                rotationError = std::max(rotationError, glm::length(poses[i].rotation[c] - glm::vec3(truth[i][c])));
+            }
+            translationError = std::max(translationError,
+                glm::length(poses[i].translation - glm::vec3(truth[i][3])) / glm::length(glm::vec3(truth[i][3])));
+        }
+
+        bench::printRow("decomposeHomography (both candidates)", planes / single / 1e6, "Mplanes/s");
+        bench::printRow("decomposeHomographyBatch (scalar)", planes / scalar / 1e6, "Mplanes/s", planes / single / 1e6);
+        bench::printRow(std::string("decomposeHomographyBatch (") + gl::simd::nativeInstructionSet() + ")",
+            planes / simd / 1e6, "Mplanes/s", planes / single / 1e6);
+        std::printf("    max rotation column error %.2e, max relative translation error %.2e\n",
+            rotationError, translationError);
+    }
+}
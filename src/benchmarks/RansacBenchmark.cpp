@@ -0,0 +1,151 @@
+#include "Benchmark.hpp"
+#include "gl/ransac.hpp"
+#include "gl/refine.hpp"
+#include "gl/projection.hpp"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct Correspondences {
+        std::vector<glm::vec2> src;
+        std::vector<glm::vec2> dst;
+        std::vector<bool> isOutlier;
+    };
+
+    // Points scattered over a 640x480 frame, mapped through H with Gaussian
+    // noise, and a fraction replaced by uniformly random destinations
+    Correspondences makeCorrespondences(const glm::mat3& H, size_t count, float outlierRatio,
+        float noiseSigma, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> ux(0.0f, 640.0f), uy(0.0f, 480.0f), unit(0.0f, 1.0f);
+        std::normal_distribution<float> noise(0.0f, noiseSigma);
+
+        Correspondences c;
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec2 s(ux(rng), uy(rng));
+            bool outlier = unit(rng) < outlierRatio;
+            glm::vec2 d = outlier ? glm::vec2(ux(rng), uy(rng))
+                : gl::projectPoint(H, s) + glm::vec2(noise(rng), noise(rng));
+            c.src.push_back(s);
+            c.dst.push_back(d);
+            c.isOutlier.push_back(outlier);
+        }
+        return c;
+    }
+
+    // Mean distance between the corners of the frame mapped by each homography
+    double cornerError(const glm::mat3& a, const glm::mat3& b) {
+        const glm::vec2 corners[] = { {0, 0}, {640, 0}, {640, 480}, {0, 480} };
+        double sum = 0.0;
+        for (const glm::vec2& p : corners) {
+            sum += glm::length(gl::projectPoint(a, p) - gl::projectPoint(b, p));
+        }
+        return sum / 4.0;
+    }
+
+} // namespace
+
+void runRansacBenchmarks() {
+    const std::array<glm::vec2, 4> quad = { glm::vec2(0, 0), glm::vec2(640, 0), glm::vec2(640, 480), glm::vec2(0, 480) };
+    const std::array<glm::vec2, 4> seen = { glm::vec2(40, 25), glm::vec2(610, 60), glm::vec2(590, 455), glm::vec2(20, 430) };
+    const glm::mat3 truth = gl::computeHomography(quad, seen);
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    gl::JobSystem serial(0);
+
+    // Fixed hypothesis count (no early exit) so the rate is comparable
+    for (size_t count : { 100, 500, 2000 }) {
+        const Correspondences c = makeCorrespondences(truth, count, 0.3f, 1.0f, 21);
+        bench::printHeader("RANSAC throughput, " + std::to_string(count) + " correspondences");
+
+        gl::RansacOptions options;
+        options.confidence = 1.0f;
+        options.maxIterations = 1024;
+
+        options.pool = &serial;
+        double serialSeconds = bench::timeIt([&] {
+            bench::doNotOptimize(gl::estimateHomographyRansac(c.src, c.dst, options));
+        });
+        double serialRate = options.maxIterations / serialSeconds;
+        bench::printRow("1 thread", serialRate / 1e3, "Khyp/s");
+
+        options.pool = nullptr;
+        double poolSeconds = bench::timeIt([&] {
+            bench::doNotOptimize(gl::estimateHomographyRansac(c.src, c.dst, options));
+        });
+        bench::printRow(std::to_string(hardwareThreads + 1) + " threads (default pool)",
+            options.maxIterations / poolSeconds / 1e3, "Khyp/s", serialRate / 1e3);
+    }
+
+    // Accuracy and adaptive termination at increasing outlier ratios
+    bench::printHeader("RANSAC accuracy (500 correspondences, sigma 1px, threshold 3px)");
+    for (float ratio : { 0.1f, 0.3f, 0.5f, 0.7f }) {
+        const Correspondences c = makeCorrespondences(truth, 500, ratio, 1.0f, 33);
+        gl::RansacResult result = gl::estimateHomographyRansac(c.src, c.dst);
+
+        size_t trueInliers = 0, recovered = 0, falseInliers = 0;
+        for (size_t i = 0; i < c.src.size(); ++i) {
+            if (!c.isOutlier[i]) {
+                ++trueInliers;
+                recovered += result.inliers.empty() ? 0 : result.inliers[i];
+            }
+            else if (!result.inliers.empty() && result.inliers[i]) {
+                ++falseInliers;
+            }
+        }
+
+        std::string label = std::to_string(static_cast<int>(ratio * 100)) + "% outliers";
+        std::printf("  %-14s iterations %5d  recall %6.2f%%  false inliers %3zu  corner error %.3f px\n",
+            label.c_str(), result.iterations,
+            100.0 * static_cast<double>(recovered) / static_cast<double>(trueInliers),
+            falseInliers, result.success ? cornerError(result.homography, truth) : -1.0);
+    }
+
+    // Levenberg-Marquardt refinement of the RANSAC estimate over its inliers
+    bench::printHeader("LM refinement (inliers of 500 correspondences, 30% outliers)");
+    {
+        const Correspondences c = makeCorrespondences(truth, 500, 0.3f, 1.0f, 45);
+        const gl::RansacResult initial = gl::estimateHomographyRansac(c.src, c.dst);
+        std::vector<glm::vec2> src, dst;
+        for (size_t i = 0; i < c.src.size(); ++i) {
+            if (initial.inliers[i]) {
+                src.push_back(c.src[i]);
+                dst.push_back(c.dst[i]);
+            }
+        }
+
+        // A deliberately perturbed start shows the convergence behaviour
+        glm::mat3 perturbed = initial.homography;
+        perturbed[2][0] += 4.0f;
+        perturbed[0][2] += 2e-5f;
+        for (const auto& [label, start] : { std::pair{ "from RANSAC", initial.homography }, std::pair{ "from perturbed", perturbed } }) {
+            gl::HomographyRefineResult refined = gl::refineHomography(src, dst, start);
+            std::printf("  %-16s RMS %.4f -> %.4f px in %2d iterations, corner error %.3f -> %.3f px\n",
+                label, refined.initialError, refined.finalError, refined.iterations,
+                cornerError(start, truth), cornerError(refined.homography, truth));
+        }
+
+        double scalarSeconds = bench::timeIt([&] {
+            bench::doNotOptimize(gl::refineHomography<gl::simd::FloatX1>(src, dst, perturbed));
+        });
+        double simdSeconds = bench::timeIt([&] {
+            bench::doNotOptimize(gl::refineHomography(src, dst, perturbed));
+        });
+        bench::printRow("Scalar lanes", 1.0 / scalarSeconds, "refines/s");
+        bench::printRow(std::string(gl::simd::nativeInstructionSet()) + " lanes", 1.0 / simdSeconds, "refines/s", 1.0 / scalarSeconds);
+
+        std::vector<gl::HomographyRefineProblem> problems(64, { src, dst, perturbed });
+        std::vector<gl::HomographyRefineResult> results(problems.size());
+        double serialBatch = bench::timeIt([&] {
+            gl::refineHomographyBatch(std::span<const gl::HomographyRefineProblem>(problems), results, {}, &serial);
+        });
+        double poolBatch = bench::timeIt([&] {
+            gl::refineHomographyBatch(std::span<const gl::HomographyRefineProblem>(problems), results);
+        });
+        bench::printRow("Batch of 64 planes, 1 thread", problems.size() / serialBatch, "planes/s");
+        bench::printRow("Batch of 64 planes, default pool", problems.size() / poolBatch, "planes/s", problems.size() / serialBatch);
+    }
+}
@@ -0,0 +1,198 @@
+#include "Benchmark.hpp"
+#include "gl/homography.hpp"
+#include "gl/projection.hpp"
+#include "gl/ransac.hpp"
+#include "gl/refine.hpp"
+#include "gl/tracking.hpp"
+#include "gl/warp.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr int WIDTH = 640;
+    constexpr int HEIGHT = 480;
+    constexpr int FRAMES = 30;
+
+    // Grayscale noise smoothed with a few box passes, so it has corners at
+    // several scales, as a camera image of a textured plane would
+    gl::Image makeTexture(int width, int height, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::vector<float> a(static_cast<size_t>(width) * height), b(a.size());
+        for (float& v : a) {
+            v = static_cast<float>(rng() & 255);
+        }
+        for (int pass = 0; pass < 3; ++pass) {
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    float sum = 0.0f;
+                    for (int dy = -2; dy <= 2; ++dy) {
+                        const int sy = std::clamp(y + dy, 0, height - 1);
+                        for (int dx = -2; dx <= 2; ++dx) {
+                            sum += a[static_cast<size_t>(sy) * width + std::clamp(x + dx, 0, width - 1)];
+                        }
+                    }
+                    b[static_cast<size_t>(y) * width + x] = sum / 25.0f;
+                }
+            }
+            std::swap(a, b);
+        }
+
+        // Stretch the contrast the blur took away
+        const auto [lo, hi] = std::minmax_element(a.begin(), a.end());
+        const float scale = 255.0f / std::max(*hi - *lo, 1.0f);
+        gl::Image image(width, height, 1);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                image.getRow(y)[x] = static_cast<std::uint8_t>((a[static_cast<size_t>(y) * width + x] - *lo) * scale);
+            }
+        }
+        return image;
+    }
+
+    // Reference-to-frame homography: the plane drifts, turns and tilts a little every frame
+    glm::mat3 frameMotion(int frame) {
+        const float t = static_cast<float>(frame);
+        const float angle = 0.004f * t;
+        const float c = std::cos(angle), s = std::sin(angle);
+        const glm::vec2 centre(WIDTH * 0.5f, HEIGHT * 0.5f);
+        glm::mat3 H(1.0f);
+        H[0] = glm::vec3(c, s, 1.5e-6f * t);
+        H[1] = glm::vec3(-s, c, -1.0e-6f * t);
+        H[2] = glm::vec3(centre + glm::vec2(2.5f * t, 1.2f * t) - glm::vec2(c * centre.x - s * centre.y, s * centre.x + c * centre.y), 1.0f);
+        return H;
+    }
+
+    double cornerError(const glm::mat3& a, const glm::mat3& b) {
+        const glm::vec2 corners[] = { {0, 0}, {WIDTH, 0}, {WIDTH, HEIGHT}, {0, HEIGHT} };
+        double sum = 0.0;
+        for (const glm::vec2& p : corners) {
+            sum += glm::length(gl::projectPoint(a, p) - gl::projectPoint(b, p));
+        }
+        return sum / 4.0;
+    }
+
+} // namespace
+
+void runTrackingBenchmarks() {
+    const gl::Image texture = makeTexture(WIDTH, HEIGHT, 21);
+
+    // Frame k shows the texture through frameMotion(k); warpPerspective wants frame -> texture
+    std::vector<gl::Image> frames;
+    for (int k = 0; k < FRAMES; ++k) {
+        gl::Image frame(WIDTH, HEIGHT, 1);
+        gl::warpPerspective(texture, gl::inverseHomography(frameMotion(k)), frame);
+        frames.push_back(std::move(frame));
+    }
+
+    gl::TrackerOptions options;
+    gl::JobSystem serial(0);
+
+    gl::ImagePyramid pyramid;
+    pyramid.build(frames[0], options.levels, options.windowRadius + 2);
+    gl::CornerOptions cornerOptions;
+    cornerOptions.maxCorners = 300;
+    cornerOptions.margin = 20;
+    const std::vector<glm::vec2> corners = gl::detectGoodFeatures(pyramid.getLevel(0), cornerOptions);
+
+    bench::printHeader("Image pyramid, " + std::to_string(WIDTH) + "x" + std::to_string(HEIGHT) + ", " +
+        std::to_string(options.levels) + " levels");
+    {
+        gl::ImagePyramid p;
+        double scalarSeconds = bench::timeIt([&] { p.build<gl::simd::FloatX1>(frames[1], options.levels, options.windowRadius + 2, &serial); });
+        double simdSeconds = bench::timeIt([&] { p.build(frames[1], options.levels, options.windowRadius + 2, &serial); });
+        double pooledSeconds = bench::timeIt([&] { p.build(frames[1], options.levels, options.windowRadius + 2); });
+        bench::printRow("Scalar, one thread", 1e3 * scalarSeconds, "ms");
+        bench::printRow(std::string(gl::simd::nativeInstructionSet()) + ", one thread", 1e3 * simdSeconds, "ms");
+        bench::printRow(std::string(gl::simd::nativeInstructionSet()) + ", default pool", 1e3 * pooledSeconds, "ms");
+    }
+
+    bench::printHeader("Lucas-Kanade, " + std::to_string(corners.size()) + " corners, " +
+        std::to_string(2 * options.windowRadius + 1) + "px window");
+    {
+        gl::ImagePyramid next;
+        next.build(frames[1], options.levels, options.windowRadius + 2);
+        std::vector<glm::vec2> tracked(corners.size());
+        std::vector<std::uint8_t> status(corners.size());
+
+        auto run = [&]<typename V>(gl::JobSystem* pool) {
+            gl::TrackerOptions o = options;
+            o.pool = pool;
+            return bench::timeIt([&] {
+                std::copy(corners.begin(), corners.end(), tracked.begin());
+                gl::trackPoints<V>(pyramid, next, corners, tracked, status, o);
+            });
+        };
+        double scalarSeconds = run.template operator()<gl::simd::FloatX1>(&serial);
+        double simdSeconds = run.template operator()<gl::simd::NativeFloat>(&serial);
+        double pooledSeconds = run.template operator()<gl::simd::NativeFloat>(nullptr);
+        const double points = static_cast<double>(corners.size());
+        bench::printRow("Scalar, one thread", points / scalarSeconds / 1e3, "Kpts/s");
+        bench::printRow(std::string(gl::simd::nativeInstructionSet()) + ", one thread", points / simdSeconds / 1e3, "Kpts/s", points / scalarSeconds / 1e3);
+        bench::printRow(std::string(gl::simd::nativeInstructionSet()) + ", default pool", points / pooledSeconds / 1e3, "Kpts/s", points / scalarSeconds / 1e3);
+
+        // Mis-tracks are expected on repetitive texture; the tracker's
+        // outlier rejection deals with those
+        std::vector<double> errors;
+        const glm::mat3 motion = frameMotion(1);
+        for (size_t i = 0; i < corners.size(); ++i) {
+            if (status[i]) {
+                errors.push_back(glm::length(tracked[i] - gl::projectPoint(motion, corners[i])));
+            }
+        }
+        std::sort(errors.begin(), errors.end());
+        const auto accurate = std::lower_bound(errors.begin(), errors.end(), 0.5) - errors.begin();
+        std::printf("    tracked %zu/%zu, %td within 0.5 px, median error %.3f px\n", errors.size(), corners.size(),
+            accurate, errors.empty() ? 0.0 : errors[errors.size() / 2]);
+    }
+
+    bench::printHeader("Homography over " + std::to_string(FRAMES) + " frames, incremental vs from scratch");
+    {
+        gl::FeatureTracker tracker(options);
+        double trackSeconds = 0.0;
+        double refineSeconds = 0.0;
+        double ransacSeconds = 0.0;
+        double incrementalError = 0.0, scratchError = 0.0;
+        int refineIterations = 0, reestimates = 0;
+
+        tracker.reset(frames[0], corners);
+        for (int k = 1; k < FRAMES; ++k) {
+            auto start = bench::Clock::now();
+            const gl::TrackerFrameStats& stats = tracker.track(frames[k]);
+            trackSeconds += std::chrono::duration<double>(bench::Clock::now() - start).count();
+            refineIterations += stats.refineIterations;
+            reestimates += stats.reestimated ? 1 : 0;
+            incrementalError = cornerError(tracker.getHomography(), frameMotion(k));
+
+            // The same correspondences, estimated without the previous solution
+            std::vector<glm::vec2> src, dst;
+            for (size_t i = 0; i < corners.size(); ++i) {
+                if (tracker.getStatus()[i]) {
+                    src.push_back(tracker.getReferencePoints()[i]);
+                    dst.push_back(tracker.getPoints()[i]);
+                }
+            }
+            gl::RansacOptions ransacOptions;
+            ransacOptions.inlierThreshold = options.outlierThreshold;
+            start = bench::Clock::now();
+            gl::RansacResult estimate = gl::estimateHomographyRansac(src, dst, ransacOptions);
+            ransacSeconds += std::chrono::duration<double>(bench::Clock::now() - start).count();
+            start = bench::Clock::now();
+            gl::HomographyRefineResult refined = gl::refineHomography(src, dst, tracker.getHomography(), options.refine);
+            refineSeconds += std::chrono::duration<double>(bench::Clock::now() - start).count();
+            bench::doNotOptimize(refined);
+            scratchError = cornerError(estimate.homography, frameMotion(k));
+        }
+
+        const double updates = FRAMES - 1;
+        bench::printRow("Tracker frame (pyramid + LK + update)", 1e3 * trackSeconds / updates, "ms");
+        bench::printRow("Incremental LM refine", 1e6 * refineSeconds / updates, "us");
+        bench::printRow("RANSAC from scratch", 1e6 * ransacSeconds / updates, "us");
+        std::printf("    %zu/%zu points left, %.1f LM iterations/frame, %d re-estimates\n",
+            tracker.getTrackedCount(), corners.size(), refineIterations / updates, reestimates);
+        std::printf("    final corner error: incremental %.3f px, RANSAC %.3f px\n", incrementalError, scratchError);
+    }
+}
@@ -0,0 +1,189 @@
+#include "Benchmark.hpp"
+#include "gl/homography.hpp"
+#include "gl/warp.hpp"
+#include "gl/remap.hpp"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    gl::Image makeNoiseImage(int width, int height, unsigned seed) {
+        gl::Image image(width, height, 4);
+        std::mt19937 rng(seed);
+        for (size_t i = 0; i < image.getSizeInBytes(); ++i) {
+            image.getData()[i] = static_cast<std::uint8_t>(rng());
+        }
+        return image;
+    }
+
+    // Destination-to-source homography: the destination rectangle maps onto a
+    // perspective quad inside the source image, with some pixels off the edge
+    glm::mat3 makeWarp(int dstWidth, int dstHeight, int srcWidth, int srcHeight) {
+        float w = static_cast<float>(dstWidth - 1);
+        float h = static_cast<float>(dstHeight - 1);
+        float sw = static_cast<float>(srcWidth);
+        float sh = static_cast<float>(srcHeight);
+        std::array<glm::vec2, 4> dst = { glm::vec2(0, 0), glm::vec2(w, 0), glm::vec2(w, h), glm::vec2(0, h) };
+        std::array<glm::vec2, 4> src = {
+            glm::vec2(0.10f * sw, 0.05f * sh), glm::vec2(0.95f * sw, 0.20f * sh),
+            glm::vec2(1.05f * sw, 0.90f * sh), glm::vec2(-0.05f * sw, 0.80f * sh)
+        };
+        return gl::computeHomography(dst, src);
+    }
+
+    // Fraction of pixels whose channels differ by more than one step
+    double mismatchRate(const gl::Image& a, const gl::Image& b) {
+        size_t mismatches = 0;
+        const size_t pixels = a.getSizeInBytes() / 4;
+        for (size_t i = 0; i < pixels; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                if (std::abs(int(a.getData()[i * 4 + c]) - int(b.getData()[i * 4 + c])) > 1) {
+                    ++mismatches;
+                    break;
+                }
+            }
+        }
+        return static_cast<double>(mismatches) / static_cast<double>(pixels);
+    }
+
+} // namespace
+
+void runWarpBenchmarks() {
+    const gl::Image src = makeNoiseImage(1024, 1024, 11);
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int size : { 512, 1024, 2048 }) {
+        const glm::mat3 H = makeWarp(size, size, src.getWidth(), src.getHeight());
+        const double megapixels = static_cast<double>(size) * size / 1e6;
+
+        for (gl::WarpFilter filter : { gl::WarpFilter::Nearest, gl::WarpFilter::Bilinear }) {
+            const char* filterName = filter == gl::WarpFilter::Nearest ? "nearest" : "bilinear";
+            bench::printHeader("warpPerspective " + std::to_string(size) + "x" + std::to_string(size) +
+                " RGBA, " + filterName);
+
+            gl::Image reference(size, size, 4);
+            gl::Image dst(size, size, 4);
+
+            // Single thread, scalar vs vectorized kernels
+            gl::JobSystem serial(0);
+            gl::WarpOptions options;
+            options.filter = filter;
+            options.pool = &serial;
+            options.vectorize = false;
+            double scalar = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, reference, options); });
+            bench::printRow("1 thread, scalar", scalar, "MP/s");
+
+            options.vectorize = true;
+            double vectorized = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, dst, options); });
+            bench::printRow(std::string("1 thread, ") + gl::simd::nativeInstructionSet(), vectorized, "MP/s", scalar);
+            std::printf("    pixels differing from scalar: %.4f%%\n", mismatchRate(dst, reference) * 100.0);
+
+            // Thread scaling (the calling thread counts as one)
+            for (unsigned threads = 2; threads <= std::max(2u, hardwareThreads); threads *= 2) {
+                gl::JobSystem pool(threads - 1);
+                options.pool = &pool;
+                double rate = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, dst, options); });
+                bench::printRow(std::to_string(threads) + " threads", rate, "MP/s", scalar);
+            }
+        }
+    }
+
+    // Coordinate generation: per-pixel divide vs forward differencing
+    {
+        const int size = 1024;
+        const glm::mat3 H = makeWarp(size, size, src.getWidth(), src.getHeight());
+        const gl::detail::WarpMapping mapping(H);
+        const double megapixels = static_cast<double>(size) * size / 1e6;
+        bench::printHeader("Row coordinates " + std::to_string(size) + "x" + std::to_string(size));
+
+        std::vector<float> us(size), vs(size);
+        auto perPixel = [&](bool vectorize) {
+            return megapixels / bench::timeIt([&] {
+                for (int y = 0; y < size; ++y) {
+                    for (int x = 0; x < size; x += gl::detail::WARP_MAX_SPAN) {
+                        gl::detail::rowCoordinatesPerPixel(mapping, y, x, gl::detail::WARP_MAX_SPAN,
+                            us.data() + x, vs.data() + x, vectorize);
+                    }
+                    bench::doNotOptimize(us);
+                }
+            });
+        };
+        double naive = perPixel(false);
+        bench::printRow("per-pixel divide, scalar", naive, "MP/s");
+        bench::printRow("per-pixel divide, vectorized", perPixel(true), "MP/s", naive);
+
+        for (float tolerance : { 1.0f / 16.0f, 0.25f }) {
+            double rate = megapixels / bench::timeIt([&] {
+                for (int y = 0; y < size; ++y) {
+                    gl::detail::rowCoordinatesForwardDifference(mapping, y, 0, size, us.data(), vs.data(), tolerance);
+                    bench::doNotOptimize(us);
+                }
+            });
+
+            // Worst deviation from the exact mapping, evaluated in double
+            double worst = 0.0;
+            for (int y = 0; y < size; y += 7) {
+                gl::detail::rowCoordinatesForwardDifference(mapping, y, 0, size, us.data(), vs.data(), tolerance);
+                for (int x = 0; x < size; ++x) {
+                    glm::dvec3 p = glm::dmat3(H) * glm::dvec3(x, y, 1.0);
+                    worst = std::max(worst, std::max(std::abs(us[x] - p.x / p.z), std::abs(vs[x] - p.y / p.z)));
+                }
+            }
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "forward difference, tol %.4f px", tolerance);
+            bench::printRow(label, rate, "MP/s", naive);
+            std::printf("    max coordinate error: %.4f px\n", worst);
+        }
+
+        // Whole warp, single thread
+        gl::JobSystem serial(0);
+        gl::Image dst(size, size, 4);
+        for (bool vectorize : { false, true }) {
+            gl::WarpOptions options;
+            options.pool = &serial;
+            options.vectorize = vectorize;
+            const std::string kind = vectorize ? gl::simd::nativeInstructionSet() : "scalar";
+
+            options.stepping = gl::WarpStepping::PerPixel;
+            double exact = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, dst, options); });
+            bench::printRow("warp bilinear, per-pixel, " + kind, exact, "MP/s");
+
+            options.stepping = gl::WarpStepping::ForwardDifference;
+            double stepped = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, dst, options); });
+            bench::printRow("warp bilinear, forward difference, " + kind, stepped, "MP/s", exact);
+        }
+    }
+
+    // Static geometry: direct warp vs cached remap table
+    for (int size : { 512, 1024, 2048 }) {
+        const glm::mat3 H = makeWarp(size, size, src.getWidth(), src.getHeight());
+        const double megapixels = static_cast<double>(size) * size / 1e6;
+        bench::printHeader("Remap cache " + std::to_string(size) + "x" + std::to_string(size) + " RGBA, bilinear");
+
+        gl::JobSystem serial(0);
+        gl::WarpOptions options;
+        options.pool = &serial;
+        gl::Image direct(size, size, 4);
+        gl::Image cached(size, size, 4);
+
+        double warpRate = megapixels / bench::timeIt([&] { gl::warpPerspective(src, H, direct, options); });
+        bench::printRow("warpPerspective", warpRate, "MP/s");
+
+        double buildRate = megapixels / bench::timeIt([&] {
+            gl::RemapCache cold;
+            gl::warpPerspectiveCached(src, H, cached, cold, options);
+        });
+        bench::printRow("warpPerspectiveCached, cold (build + apply)", buildRate, "MP/s", warpRate);
+
+        gl::RemapCache cache;
+        double cachedRate = megapixels / bench::timeIt([&] { gl::warpPerspectiveCached(src, H, cached, cache, options); });
+        bench::printRow("warpPerspectiveCached, warm", cachedRate, "MP/s", warpRate);
+
+        auto stats = cache.getStats();
+        std::printf("    table memory %.2f MB of %.2f MB budget, pixels differing from direct warp: %.4f%%\n",
+            stats.bytesUsed / 1048576.0, stats.byteBudget / 1048576.0, mismatchRate(cached, direct) * 100.0);
+    }
+}
@@ -1,32 +1,100 @@
 #include "HomographyEffect.hpp"
 #include "../geometry/MeshComponent.hpp"
-#include "../camera/CameraComponent.hpp"
-#include "../rendering/MeshRenderer.hpp"
 #include "../../core/Entity.hpp"
 #include "../../core/Scene.hpp"
 #include "../../../include/gl/homography.hpp"
 #include "../../gl/logger.hpp"
 #include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+#include <chrono>
+#include <cmath>
+#include <string>
 
-HomographyEffect::HomographyEffect() {
-    name_ = "HomographyEffect";
+namespace {
+
+    struct CubeFace {
+        glm::vec3 normal;
+        // Corners in the order of texture coordinates (0,0), (1,0), (1,1), (0,1),
+        // matching the vertex data of MeshComponent::createCube
+        std::array<glm::vec3, 4> corners;
+    };
 
-    // Define the source points (unit square)
-    srcPoints_ = {
+    const std::array<CubeFace, 6> CUBE_FACES = { {
+        // front
+        { glm::vec3(0, 0, 1), { glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f),
+                                glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, 0.5f) } },
+        // back
+        { glm::vec3(0, 0, -1), { glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f),
+                                 glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(0.5f, 0.5f, -0.5f) } },
+        // left
+        { glm::vec3(-1, 0, 0), { glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, 0.5f),
+                                 glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f) } },
+        // right
+        { glm::vec3(1, 0, 0), { glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.5f, 0.5f, 0.5f),
+                                glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(0.5f, -0.5f, -0.5f) } },
+        // bottom
+        { glm::vec3(0, -1, 0), { glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f),
+                                 glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f) } },
+        // top
+        { glm::vec3(0, 1, 0), { glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(0.5f, 0.5f, 0.5f),
+                                glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(-0.5f, 0.5f, -0.5f) } }
+    } };
+
+    const std::array<glm::vec2, 4> UNIT_SQUARE = {
         glm::vec2(0.0f, 0.0f),
         glm::vec2(1.0f, 0.0f),
         glm::vec2(1.0f, 1.0f),
         glm::vec2(0.0f, 1.0f)
     };
 
-    // Initialize homography matrix
-    homographyCache_ = glm::mat3(1.0f);
+    // Camera movement below both thresholds keeps the last decals
+    constexpr float CAMERA_POSITION_THRESHOLD = 0.1f;
+    constexpr float CAMERA_ROTATION_THRESHOLD = 0.5f; // Degrees
+
+    // One solve running and the newest request queued behind it
+    constexpr std::size_t MAX_SOLVES_IN_FLIGHT = 2;
+
+    glm::vec3 getEye(const glm::mat4& view) {
+        return glm::vec3(glm::inverse(view)[3]);
+    }
+
+    glm::vec3 getForward(const glm::mat4& view) {
+        return -glm::vec3(view[0][2], view[1][2], view[2][2]);
+    }
+
+    // Tile layout in NDC: bottom-right tile centre, tile size, tiles per row
+    const glm::vec2 TILE_ORIGIN = glm::vec2(0.8f, -0.8f);
+    const glm::vec2 TILE_SIZE = glm::vec2(0.4f, 0.4f);
+    constexpr int TILES_PER_ROW = 5;
+
+    // Decal homographies for faces in [0,1] screen coordinates
+    std::vector<glm::mat3> solveDecals(const std::vector<std::array<glm::vec2, 4>>& faces) {
+        // Solve screen -> unit square directly, which is the inverse the shader needs
+        std::vector<std::array<glm::vec2, 4>> squares(faces.size(), UNIT_SQUARE);
+        std::vector<glm::mat3> homographies(faces.size());
+        gl::computeHomographyBatch(std::span<const std::array<glm::vec2, 4>>(faces),
+            std::span<const std::array<glm::vec2, 4>>(squares), std::span<glm::mat3>(homographies));
+
+        std::vector<glm::mat3> decals;
+        decals.reserve(faces.size());
+        for (size_t i = 0; i < faces.size(); ++i) {
+            glm::mat3 H = homographies[i];
+            if (H[2][2] == 0.0f) continue; // singular (degenerate face)
 
-    // Initialize quad model matrix
-    quadModelMatrix_ = glm::translate(glm::mat4(1.0f), glm::vec3(0.7f, -0.7f, 0.0f));
-    quadModelMatrix_ = glm::scale(quadModelMatrix_, glm::vec3(0.5f, 0.5f, 1.0f));
+            // Scale so w is positive over the face; the shader discards w <= 0,
+            // which removes the mirrored image beyond the horizon
+            const glm::vec2 centroid = (faces[i][0] + faces[i][1] + faces[i][2] + faces[i][3]) * 0.25f;
+            if ((H * glm::vec3(centroid, 1.0f)).z < 0.0f) {
+                H = -H;
+            }
+            decals.push_back(H);
+        }
+        return decals;
+    }
+
+} // namespace
+
+HomographyEffect::HomographyEffect() {
+    name_ = "HomographyEffect";
 }
 
 void HomographyEffect::init() {
@@ -35,110 +103,208 @@ void HomographyEffect::init() {
     if (!quadMesh_) {
         gl::logWarning("HomographyEffect requires a MeshComponent on the same entity");
     }
-
-    renderer_ = entity_->getComponent<MeshRenderer>();
-    if (!renderer_) {
-        gl::logWarning("HomographyEffect requires a MeshRenderer on the same entity");
+    else {
+        // Per-instance homography on locations 2-4 of the quad's VAO
+        gl::VertexArray* vao = quadMesh_->getVAO();
+        vao->bind();
+        instanceBuffer_.bind();
+        for (GLuint column = 0; column < 3; ++column) {
+            vao->setVertexAttribute(2 + column, 3, gl::DataType::Float, false,
+                sizeof(glm::mat3), column * sizeof(glm::vec3));
+            vao->setAttributeDivisor(2 + column, 1);
+        }
+        instanceBuffer_.unbind();
+        vao->unbind();
     }
 
-    // Find camera in scene
-    if (entity_->getScene()) {
-        auto cameraEntity = entity_->getScene()->findEntity("MainCamera");
-        if (cameraEntity) {
-            camera_ = cameraEntity->getComponent<CameraComponent>();
-        }
+    if (!shader_) {
+        gl::logWarning("HomographyEffect has no decal shader");
     }
 
-    if (!camera_) {
-        gl::logWarning("HomographyEffect couldn't find a CameraComponent in the scene");
+    // Decals are solved from the scene camera's matrices
+    if (!entity_->getScene() || !entity_->getScene()->findEntity("MainCamera")) {
+        gl::logWarning("HomographyEffect couldn't find a camera in the scene");
     }
 
     gl::logDebug("HomographyEffect initialized");
 }
 
-void HomographyEffect::update(float deltaTime) {
-    if (!camera_) return;
+void HomographyEffect::render() {
+    collectSolves();
 
-    // Update homography when camera moves significantly
-    float positionDelta = glm::distance(camera_->getPosition(), lastCameraPos_);
-    float rotationDelta = std::abs(camera_->getYaw() - lastCameraYaw_) +
-        std::abs(camera_->getPitch() - lastCameraPitch_);
+    if (!quadMesh_ || !shader_ || instanceCount_ == 0) return;
 
-    if (positionDelta > 0.1f || rotationDelta > 0.5f) {
-        homographyDirty_ = true;
-    }
+    shader_->use();
+    shader_->setVec2("u_tileOrigin", TILE_ORIGIN.x, TILE_ORIGIN.y);
+    shader_->setVec2("u_tileSize", TILE_SIZE.x, TILE_SIZE.y);
+    shader_->setInt("u_tilesPerRow", TILES_PER_ROW);
 
-    if (homographyDirty_) {
-        updateHomography();
+    if (texture_) {
+        texture_->bind(0);
+        shader_->setInt("texture1", 0);
     }
-}
 
-void HomographyEffect::render() {
-    if (!quadMesh_ || !renderer_ || !camera_) return;
+    // Tiles are drawn over the scene
+    glDisable(GL_DEPTH_TEST);
 
-    // Store current depth function
-    glGetIntegerv(GL_DEPTH_FUNC, &previousDepthFunc_);
+    quadMesh_->getVAO()->bind();
+    glDrawArraysInstanced(GL_TRIANGLES, 0, quadMesh_->getVertexCount(), instanceCount_);
+    quadMesh_->getVAO()->unbind();
 
-    // Make the quad always pass the depth test (appear in front)
-    glDepthFunc(GL_ALWAYS);
+    glEnable(GL_DEPTH_TEST);
+}
 
-    // Pass the cached inverse homography to the shader
-    renderer_->getShader()->setMat3("u_homography", glm::value_ptr(homographyCache_));
+std::vector<std::array<glm::vec2, 4>> HomographyEffect::computeVisibleFaces(const glm::mat4& view,
+    const glm::mat4& projection) const {
+    const glm::mat4 viewProjection = projection * view;
+    const glm::vec3 eye = getEye(view);
 
-    // Set up screen-space quad positioning
-    glm::mat4 quadView = glm::mat4(1.0f);  // Identity view matrix for screen space
-    glm::mat4 quadProj = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+    std::vector<std::array<glm::vec2, 4>> faces;
+    faces.reserve(targetMeshes_.size() * 3);
+    for (MeshComponent* cube : targetMeshes_) {
+        const glm::mat4& model = cube->getCachedModelMatrix();
+        const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+        const glm::mat4 mvp = viewProjection * model;
 
-    // Position in bottom right corner
-    glm::mat4 quadModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.7f, -0.7f, 0.0f));
-    quadModel = glm::scale(quadModel, glm::vec3(0.5f, 0.5f, 1.0f));
+        for (const CubeFace& face : CUBE_FACES) {
+            // Back-facing: the eye is behind the face plane
+            const glm::vec3 normal = normalMatrix * face.normal;
+            const glm::vec3 onFace = glm::vec3(model * glm::vec4(face.corners[0], 1.0f));
+            if (glm::dot(normal, eye - onFace) <= 0.0f) continue;
 
-    glm::mat4 mvp = quadProj * quadView * quadModel;
+            // Convert clip-space -> NDC -> [0,1] range; faces crossing the
+            // camera plane have no finite projection
+            std::array<glm::vec2, 4> screen;
+            bool inFront = true;
+            for (int i = 0; i < 4; ++i) {
+                glm::vec4 v = mvp * glm::vec4(face.corners[i], 1.0f);
+                if (v.w <= 0.0f) {
+                    inFront = false;
+                    break;
+                }
+                screen[i] = (glm::vec2(v) / v.w + 1.0f) * 0.5f;
+            }
+            if (inFront) {
+                faces.push_back(screen);
+            }
+        }
+    }
+    return faces;
+}
 
-    // Bypass camera transformations
-    renderer_->setMVPMatrix(mvp);
+void HomographyEffect::resolveTargets() {
+    targetMeshes_.clear();
+    Scene* scene = entity_ ? entity_->getScene() : nullptr;
+    std::erase_if(targets_, [&](EntityHandle handle) {
+        Entity* target = scene ? scene->getEntity(handle) : nullptr;
+        MeshComponent* mesh = target ? target->getComponent<MeshComponent>() : nullptr;
+        if (mesh) {
+            targetMeshes_.push_back(mesh);
+        }
+        return !target;
+    });
+}
 
-    // Manually trigger the renderer
-    renderer_->render();
+bool HomographyEffect::needsSolve(const glm::mat4& view, const glm::mat4& projection) const {
+    if (!solvedOnce_ || projection != lastProjection_ || targetMeshes_.size() != lastTargetModels_.size()) {
+        return true;
+    }
 
-    // Restore previous depth function
-    glDepthFunc(previousDepthFunc_);
+    const float positionDelta = glm::distance(getEye(view), lastCameraPos_);
+    const float rotationDelta = glm::degrees(std::acos(
+        glm::clamp(glm::dot(getForward(view), lastCameraForward_), -1.0f, 1.0f)));
+    if (positionDelta > CAMERA_POSITION_THRESHOLD || rotationDelta > CAMERA_ROTATION_THRESHOLD) {
+        return true;
+    }
 
-    // Clear external model matrix after rendering
-    renderer_->clearModelMatrix();
+    // Targets animate on their own, so any change to one re-solves
+    for (size_t i = 0; i < targetMeshes_.size(); ++i) {
+        if (targetMeshes_[i]->getCachedModelMatrix() != lastTargetModels_[i]) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void HomographyEffect::updateHomography() {
-    if (!camera_) return;
+void HomographyEffect::solve(const glm::mat4& view, const glm::mat4& projection) {
+    resolveTargets();
+    {
+        std::lock_guard<std::mutex> lock(solveMutex_);
+        if (solveFailed_) {
+            // Request again even if nothing moved
+            solvedOnce_ = false;
+            solveFailed_ = false;
+        }
+        // Moves meanwhile are picked up once a solve finishes
+        if (pendingSolves_.size() >= MAX_SOLVES_IN_FLIGHT) return;
+    }
+    if (!needsSolve(view, projection)) return;
 
-    // Compute homography for decal mapping
-    glm::mat4 fixedView = glm::lookAt(glm::vec3(0, 0, 3), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
-    glm::mat4 mvpFixed = camera_->getProjectionMatrix() * fixedView;
+    // Camera and mesh state is read here in the frame; the worker only sees copies
+    std::vector<std::array<glm::vec2, 4>> faces = computeVisibleFaces(view, projection);
+    const std::uint64_t version = ++requestedVersion_;
+    std::future<HomographyResult> result = solverJobs_.submit([faces = std::move(faces), version] {
+        return HomographyResult{ version, solveDecals(faces) };
+    });
+    {
+        std::lock_guard<std::mutex> lock(solveMutex_);
+        pendingSolves_.push_back(std::move(result));
+    }
 
-    std::array<glm::vec4, 4> faceVertsFixed = {
-        mvpFixed * glm::vec4(-0.5f, -0.5f, 0.5f, 1.0f),
-        mvpFixed * glm::vec4(0.5f, -0.5f, 0.5f, 1.0f),
-        mvpFixed * glm::vec4(0.5f,  0.5f, 0.5f, 1.0f),
-        mvpFixed * glm::vec4(-0.5f,  0.5f, 0.5f, 1.0f)
-    };
+    solvedOnce_ = true;
+    lastCameraPos_ = getEye(view);
+    lastCameraForward_ = getForward(view);
+    lastProjection_ = projection;
+    lastTargetModels_.clear();
+    for (MeshComponent* cube : targetMeshes_) {
+        lastTargetModels_.push_back(cube->getCachedModelMatrix());
+    }
+}
 
-    // Convert clip-space -> NDC -> [0,1] range
-    std::array<glm::vec2, 4> dstPoints;
-    for (int i = 0; i < 4; i++) {
-        glm::vec4 v = faceVertsFixed[i];
-        v /= v.w; // perspective divide
-        // map from [-1,1] to [0,1]
-        dstPoints[i] = glm::vec2((v.x + 1.0f) * 0.5f, (v.y + 1.0f) * 0.5f);
+void HomographyEffect::waitForSolves() {
+    std::lock_guard<std::mutex> lock(solveMutex_);
+    for (const std::future<HomographyResult>& pending : pendingSolves_) {
+        pending.wait();
     }
+}
 
-    glm::mat3 T = gl::computeHomography(srcPoints_, dstPoints);
-    homographyCache_ = glm::inverse(T);
-    homographyDirty_ = false;
+void HomographyEffect::collectSolves() {
+    std::vector<std::future<HomographyResult>> finished;
+    {
+        std::lock_guard<std::mutex> lock(solveMutex_);
+        std::erase_if(pendingSolves_, [&](std::future<HomographyResult>& pending) {
+            if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            finished.push_back(std::move(pending));
+            return true;
+        });
+    }
 
-    // Update last camera state
-    lastCameraPos_ = camera_->getPosition();
-    lastCameraYaw_ = camera_->getYaw();
-    lastCameraPitch_ = camera_->getPitch();
+    HomographyResult newest;
+    bool failed = false;
+    for (std::future<HomographyResult>& pending : finished) {
+        try {
+            HomographyResult result = pending.get();
+            if (result.version > newest.version) {
+                newest = std::move(result);
+            }
+        }
+        catch (const std::exception& e) {
+            // Keep the last good decals and request again
+            gl::logWarning("HomographyEffect solve failed: " + std::string(e.what()));
+            failed = true;
+        }
+    }
+    if (failed) {
+        std::lock_guard<std::mutex> lock(solveMutex_);
+        solveFailed_ = true;
+    }
 
-    gl::logDebug("HomographyEffect updated homography matrix");
-}
\ No newline at end of file
+    // Results older than the applied one are stale
+    if (newest.version > appliedVersion_) {
+        instanceBuffer_.setData(newest.decals, gl::BufferUsage::StreamDraw);
+        instanceCount_ = static_cast<int>(newest.decals.size());
+        appliedVersion_ = newest.version;
+    }
+}
@@ -2,46 +2,103 @@
 #define HOMOGRAPHY_EFFECT_HPP
 
 #include "../../core/Component.hpp"
+#include "../../core/EntityHandle.hpp"
+#include "../../../include/gl/buffer.hpp"
 #include "../../../include/gl/shader.hpp"
+#include "../../../include/gl/texture.hpp"
+#include "../../../include/gl/job_system.hpp"
 #include <glm/glm.hpp>
 #include <array>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 class MeshComponent;
-class CameraComponent;
-class MeshRenderer;
 
+// Draws a picture-in-picture decal for every camera-facing face of the
+// target cubes. Each tile shows the whole screen in miniature with the
+// texture warped onto where that face projects. All face homographies are
+// solved in one batch and all tiles go out in a single instanced draw.
 class HomographyEffect : public Component {
 public:
     HomographyEffect();
 
     void init() override;
-    void update(float deltaTime) override;
     void render() override;
 
-    void setQuadTransform(const glm::mat4& transform) {
-        quadModelMatrix_ = transform;
-        homographyDirty_ = true;
-    }
+    void setShader(std::shared_ptr<gl::Shader> shader) { shader_ = shader; }
+    void setTexture(std::shared_ptr<gl::Texture> texture) { texture_ = texture; }
+
+    // Entities with a cube mesh (MeshComponent::createCube) whose faces get
+    // decals. Targets that have been destroyed are dropped.
+    void addTarget(EntityHandle cube) { targets_.push_back(cube); }
+
+    // Start solving this frame's decals for the given camera matrices on
+    // the effect's solver thread. Runs in the scene's solveHomographies
+    // phase and touches no GL; render() uploads the newest finished result
+    // and keeps drawing the last good decals until then. Skipped while the
+    // camera stays within the movement thresholds and no target has moved
+    // since the last solve.
+    void solve(const glm::mat4& view, const glm::mat4& projection);
+
+    // Block until the solves in flight have finished; the next render()
+    // then uploads the newest
+    void waitForSolves();
+
+    // Decals uploaded by the last render()
+    int getDecalCount() const { return instanceCount_; }
 
 private:
-    void updateHomography();
+    // Output of a background solve, stamped with the request it answers.
+    // Each matrix maps [0,1] screen coordinates to face texture coordinates.
+    struct HomographyResult {
+        std::uint64_t version = 0;
+        std::vector<glm::mat3> decals;
+    };
+
+    // Upload the newest finished solve, dropping older ones
+    void collectSolves();
+
+    // Each face's corners in [0,1] screen coordinates
+    std::vector<std::array<glm::vec2, 4>> computeVisibleFaces(const glm::mat4& view,
+        const glm::mat4& projection) const;
+
+    // Resolve targets_ into targetMeshes_, forgetting destroyed entities
+    void resolveTargets();
+
+    // Whether the view or any target moved enough since the last solve
+    bool needsSolve(const glm::mat4& view, const glm::mat4& projection) const;
 
     MeshComponent* quadMesh_ = nullptr;
-    MeshRenderer* renderer_ = nullptr;
-    CameraComponent* camera_ = nullptr;
+    std::vector<EntityHandle> targets_;
+    std::vector<MeshComponent*> targetMeshes_; // This frame's live targets
+
+    std::shared_ptr<gl::Shader> shader_;
+    std::shared_ptr<gl::Texture> texture_;
 
-    std::array<glm::vec2, 4> srcPoints_;
-    glm::mat3 homographyCache_;
-    glm::mat4 quadModelMatrix_ = glm::mat4(1.0f);
+    // One mat3 per visible face, read with an attribute divisor of 1
+    gl::VertexBuffer instanceBuffer_;
+    int instanceCount_ = 0;
 
-    bool homographyDirty_ = true;
+    // State the last solve was requested for
+    bool solvedOnce_ = false;
     glm::vec3 lastCameraPos_ = glm::vec3(0.0f);
-    float lastCameraYaw_ = 0.0f;
-    float lastCameraPitch_ = 0.0f;
+    glm::vec3 lastCameraForward_ = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::mat4 lastProjection_ = glm::mat4(1.0f);
+    std::vector<glm::mat4> lastTargetModels_;
 
-    // For depth state management
-    GLint previousDepthFunc_ = GL_LESS;
+    // Solves run on a dedicated job system: the frame's own would run them
+    // while waiting on frame tasks, stalling the frame they should stay out
+    // of. solve() and render() may run at once, so pendingSolves_ and
+    // solveFailed_ are guarded by solveMutex_.
+    std::mutex solveMutex_;
+    std::vector<std::future<HomographyResult>> pendingSolves_;
+    bool solveFailed_ = false;
+    std::uint64_t requestedVersion_ = 0;
+    std::uint64_t appliedVersion_ = 0;
+    gl::JobSystem solverJobs_{ 1 };
 };
 
-#endif // HOMOGRAPHY_EFFECT_HPP
\ No newline at end of file
+#endif // HOMOGRAPHY_EFFECT_HPP
@@ -1,6 +1,7 @@
 #include "MeshComponent.hpp"
 #include "../../gl/logger.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 MeshComponent::MeshComponent()
     : vao_(std::make_unique<gl::VertexArray>()),
@@ -116,6 +117,11 @@ void MeshComponent::setVertices(const std::vector<Vertex>& vertices) {
 
     vertexCount_ = static_cast<int>(vertices.size());
     indexCount_ = 0;
+
+    boundingRadius_ = 0.0f;
+    for (const Vertex& vertex : vertices) {
+        boundingRadius_ = std::max(boundingRadius_, glm::length(vertex.position));
+    }
 }
 
 void MeshComponent::setIndices(const std::vector<unsigned int>& indices) {
@@ -142,6 +148,12 @@ void MeshComponent::setPositionsAndTexCoords(const std::vector<float>& data, int
 
     vertexCount_ = static_cast<int>(data.size() * sizeof(float) / stride);
     indexCount_ = 0;
+
+    boundingRadius_ = 0.0f;
+    const std::size_t floatStride = stride / sizeof(float);
+    for (std::size_t i = posOffset / sizeof(float); i + 2 < data.size(); i += floatStride) {
+        boundingRadius_ = std::max(boundingRadius_, glm::length(glm::vec3(data[i], data[i + 1], data[i + 2])));
+    }
 }
 
 void MeshComponent::animate(float deltaTime) {
@@ -4,6 +4,7 @@
 #include "../../../include/gl/buffer.hpp"
 #include "../../../include/gl/vertex_array.hpp"
 #include <glm/glm.hpp>
+#include <cassert>
 #include <memory>
 #include <vector>
 
@@ -59,6 +60,17 @@ public:
     bool hasIndices() const { return indexCount_ > 0; }
     glm::mat4 getModelMatrix();
 
+    // The matrix cached by the last getModelMatrix(). Frame phases that run
+    // side by side read this instead, so none of them writes the cache; the
+    // scene's animate phase refreshes it before they start.
+    const glm::mat4& getCachedModelMatrix() const {
+        assert(!transformDirty_ && "transform changed since the last getModelMatrix()");
+        return modelMatrix_;
+    }
+
+    // Radius of a sphere around the local origin that holds every vertex
+    float getBoundingRadius() const { return boundingRadius_; }
+
 private:
     void updateTransform();
     std::unique_ptr<gl::VertexArray> vao_;
@@ -66,6 +78,7 @@ private:
     std::unique_ptr<gl::ElementBuffer> ebo_;
     int vertexCount_ = 0;
     int indexCount_ = 0;
+    float boundingRadius_ = 0.0f;
 
     // Transform data
     glm::vec3 position_ = glm::vec3(0.0f);
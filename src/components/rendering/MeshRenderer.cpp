@@ -11,21 +11,16 @@ MeshRenderer::MeshRenderer() {
 }
 
 void MeshRenderer::init() {
-    // Find required components
-    meshComponent_ = entity_->getComponent<MeshComponent>();
-    if (!meshComponent_) {
+    if (!getMesh()) {
         gl::logWarning("MeshRenderer requires a MeshComponent on the same entity");
     }
 
     // Find camera in scene
     if (entity_->getScene()) {
-        auto cameraEntity = entity_->getScene()->findEntity("MainCamera");
-        if (cameraEntity) {
-            cameraComponent_ = cameraEntity->getComponent<CameraComponent>();
-        }
+        cameraEntity_ = entity_->getScene()->findEntityHandle("MainCamera");
     }
 
-    if (!cameraComponent_) {
+    if (!getCamera()) {
         gl::logWarning("MeshRenderer couldn't find a CameraComponent in the scene");
     }
 
@@ -37,50 +32,43 @@ void MeshRenderer::update(float deltaTime) {
 }
 
 void MeshRenderer::render() {
-    if (!meshComponent_ || !shader_) {
-        return;
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    if (CameraComponent* camera = getCamera()) {
+        view = camera->getViewMatrix();
+        projection = camera->getProjectionMatrix();
     }
 
-    shader_->use();
+    if (MeshComponent* mesh = getMesh()) {
+        mesh->getModelMatrix(); // Refresh the cache computeMVP reads
+    }
 
-    // Calculate MVP matrix based on flags
     glm::mat4 mvp;
+    if (computeMVP(view, projection, mvp)) {
+        draw(mvp);
+    }
+}
+
+bool MeshRenderer::computeMVP(const glm::mat4& view, const glm::mat4& projection, glm::mat4& mvp) {
+    MeshComponent* mesh = getMesh();
+    if (!mesh || !shader_) {
+        return false;
+    }
 
     if (useExternalModelMatrix_) {
-        if (useMVPDirectly_) {
-            // Use the provided matrix directly as MVP (for screen-space rendering)
-            mvp = modelMatrix_;
-        }
-        else {
-            // Get view and projection matrices from camera
-            glm::mat4 view = glm::mat4(1.0f);
-            glm::mat4 projection = glm::mat4(1.0f);
-
-            if (cameraComponent_) {
-                view = cameraComponent_->getViewMatrix();
-                projection = cameraComponent_->getProjectionMatrix();
-            }
-
-            // Calculate MVP with camera transformation
-            mvp = projection * view * modelMatrix_;
-        }
+        // Use the provided matrix directly as MVP (for screen-space rendering)
+        mvp = useMVPDirectly_ ? modelMatrix_ : projection * view * modelMatrix_;
     }
     else {
         // Use model matrix from mesh component
-        glm::mat4 model = meshComponent_->getModelMatrix();
-
-        // Get view and projection matrices from camera
-        glm::mat4 view = glm::mat4(1.0f);
-        glm::mat4 projection = glm::mat4(1.0f);
-
-        if (cameraComponent_) {
-            view = cameraComponent_->getViewMatrix();
-            projection = cameraComponent_->getProjectionMatrix();
-        }
-
-        // Calculate MVP
-        mvp = projection * view * model;
+        mvp = projection * view * mesh->getCachedModelMatrix();
     }
+    return true;
+}
+
+void MeshRenderer::draw(const glm::mat4& mvp) {
+    MeshComponent* mesh = getMesh();
+    shader_->use();
 
     // Set uniforms
     shader_->setMat4("u_MVP", glm::value_ptr(mvp));
@@ -92,14 +80,22 @@ void MeshRenderer::render() {
     }
 
     // Draw mesh
-    meshComponent_->getVAO()->bind();
+    mesh->getVAO()->bind();
 
-    if (meshComponent_->hasIndices()) {
-        glDrawElements(GL_TRIANGLES, meshComponent_->getIndexCount(), GL_UNSIGNED_INT, 0);
+    if (mesh->hasIndices()) {
+        glDrawElements(GL_TRIANGLES, mesh->getIndexCount(), GL_UNSIGNED_INT, 0);
     }
     else {
-        glDrawArrays(GL_TRIANGLES, 0, meshComponent_->getVertexCount());
+        glDrawArrays(GL_TRIANGLES, 0, mesh->getVertexCount());
     }
 
-    meshComponent_->getVAO()->unbind();
-}
\ No newline at end of file
+    mesh->getVAO()->unbind();
+}
+MeshComponent* MeshRenderer::getMesh() const {
+    return entity_ ? entity_->getComponent<MeshComponent>() : nullptr;
+}
+
+CameraComponent* MeshRenderer::getCamera() const {
+    Entity* cameraEntity = entity_ && entity_->getScene() ? entity_->getScene()->getEntity(cameraEntity_) : nullptr;
+    return cameraEntity ? cameraEntity->getComponent<CameraComponent>() : nullptr;
+}
@@ -2,6 +2,7 @@
 #define MESH_RENDERER_HPP
 
 #include "../../core/Component.hpp"
+#include "../../core/EntityHandle.hpp"
 #include "../../../include/gl/shader.hpp"
 #include "../../../include/gl/texture.hpp"
 #include <memory>
@@ -18,6 +19,11 @@ public:
     void update(float deltaTime) override;
     void render() override;
 
+    // render() in two steps, so the MVP can be worked out off the GL thread.
+    // computeMVP returns false when there is nothing to draw.
+    bool computeMVP(const glm::mat4& view, const glm::mat4& projection, glm::mat4& mvp);
+    void draw(const glm::mat4& mvp);
+
     void setShader(std::shared_ptr<gl::Shader> shader) { shader_ = shader; }
     void setTexture(std::shared_ptr<gl::Texture> texture) { texture_ = texture; }
 
@@ -41,10 +47,18 @@ public:
     }
 
     std::shared_ptr<gl::Shader> getShader() const { return shader_; }
+    std::shared_ptr<gl::Texture> getTexture() const { return texture_; }
+    // The MeshComponent on this renderer's entity, looked up on each call
+    MeshComponent* getMesh() const;
+
+    bool hasExternalModelMatrix() const { return useExternalModelMatrix_; }
 
 private:
-    CameraComponent* cameraComponent_ = nullptr;
-    MeshComponent* meshComponent_ = nullptr;
+    CameraComponent* getCamera() const;
+
+    // Resolved every frame, so a destroyed camera entity is skipped rather
+    // than dereferenced
+    EntityHandle cameraEntity_;
 
     std::shared_ptr<gl::Shader> shader_;
     std::shared_ptr<gl::Texture> texture_;
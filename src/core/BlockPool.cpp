@@ -0,0 +1,65 @@
+#include "BlockPool.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+
+    // Slabs of about this many bytes, but never fewer than MIN_SLAB_BLOCKS blocks
+    constexpr std::size_t SLAB_BYTES = 16 * 1024;
+    constexpr std::size_t MIN_SLAB_BLOCKS = 16;
+
+} // namespace
+
+BlockPool::BlockPool(std::size_t blockSize, std::size_t alignment)
+    : alignment_(std::max(alignment, alignof(FreeBlock))) {
+    // Every block must hold a free-list link and keep the next one aligned
+    blockSize_ = std::max(blockSize, sizeof(FreeBlock));
+    blockSize_ = (blockSize_ + alignment_ - 1) / alignment_ * alignment_;
+    blocksPerSlab_ = std::max(MIN_SLAB_BLOCKS, SLAB_BYTES / blockSize_);
+}
+
+BlockPool::~BlockPool() {
+    for (void* slab : slabs_) {
+        ::operator delete(slab, std::align_val_t(alignment_));
+    }
+}
+
+void* BlockPool::allocate() {
+    if (!freeList_) {
+        addSlab();
+    }
+    FreeBlock* block = freeList_;
+    freeList_ = block->next;
+    ++liveCount_;
+    return block;
+}
+
+void BlockPool::deallocate(void* block) {
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList_;
+    freeList_ = freed;
+    --liveCount_;
+}
+
+void BlockPool::addSlab() {
+    auto* slab = static_cast<std::byte*>(::operator new(blockSize_ * blocksPerSlab_, std::align_val_t(alignment_)));
+    slabs_.push_back(slab);
+
+    // Thread the new blocks so the first one in the slab is handed out first
+    for (std::size_t i = blocksPerSlab_; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+    }
+}
+
+std::size_t ComponentPools::getSlabCount() const {
+    std::size_t count = 0;
+    for (const auto& pool : pools_) {
+        if (pool) {
+            count += pool->getSlabCount();
+        }
+    }
+    return count;
+}
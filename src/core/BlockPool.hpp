@@ -0,0 +1,62 @@
+#ifndef BLOCK_POOL_HPP
+#define BLOCK_POOL_HPP
+
+#include "ComponentType.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Fixed-size blocks carved out of larger slabs. Freed blocks go on an
+// intrusive free list and are handed out again newest first, so allocate
+// and deallocate are O(1) and only a new slab reaches the global allocator.
+// Slabs are released when the pool is destroyed. Not thread-safe.
+class BlockPool {
+public:
+    BlockPool(std::size_t blockSize, std::size_t alignment);
+    ~BlockPool();
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    std::size_t getBlockSize() const { return blockSize_; }
+    std::size_t getSlabCount() const { return slabs_.size(); }
+    std::size_t getLiveCount() const { return liveCount_; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void addSlab();
+
+    std::size_t blockSize_;
+    std::size_t alignment_;
+    std::size_t blocksPerSlab_;
+    FreeBlock* freeList_ = nullptr;
+    std::vector<void*> slabs_;
+    std::size_t liveCount_ = 0;
+};
+
+// One BlockPool per component type, indexed by component type id and
+// created on first use
+class ComponentPools {
+public:
+    BlockPool& get(ComponentTypeId typeId, std::size_t size, std::size_t alignment) {
+        std::unique_ptr<BlockPool>& pool = pools_[typeId];
+        if (!pool) {
+            pool = std::make_unique<BlockPool>(size, alignment);
+        }
+        return *pool;
+    }
+
+    std::size_t getSlabCount() const;
+
+private:
+    std::array<std::unique_ptr<BlockPool>, MAX_COMPONENT_TYPES> pools_;
+};
+
+#endif // BLOCK_POOL_HPP
@@ -0,0 +1,135 @@
+#include "CommandBuffer.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+    std::atomic<std::uint64_t> nextBufferId{ 1 };
+
+    // Lane of the last buffer this thread recorded into, so repeated
+    // recording skips the lane lookup and its lock
+    struct LaneCache {
+        std::uint64_t bufferId = 0;
+        void* lane = nullptr;
+    };
+    thread_local LaneCache laneCache;
+
+    std::size_t alignUp(std::size_t offset, std::size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+} // namespace
+
+CommandBuffer::CommandBuffer()
+    : id_(nextBufferId.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+CommandBuffer::~CommandBuffer() {
+    clear();
+    for (auto& lane : lanes_) {
+        for (Block& block : lane->blocks) {
+            ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+    }
+}
+
+void CommandBuffer::apply(World& world) {
+    std::exception_ptr failure;
+    for (auto& lane : lanes_) {
+        for (Block& block : lane->blocks) {
+            for (std::size_t offset = 0; offset < block.used;) {
+                auto* command = reinterpret_cast<CommandHeader*>(block.data + offset);
+                void* payload = block.data + offset + command->payloadOffset;
+                if (!failure) {
+                    try {
+                        command->apply(world, payload);
+                    }
+                    catch (...) {
+                        failure = std::current_exception();
+                    }
+                }
+                command->destroy(payload);
+                offset = command->next;
+            }
+            block.used = 0;
+        }
+        lane->current = 0;
+        lane->count = 0;
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void CommandBuffer::clear() {
+    for (auto& lane : lanes_) {
+        for (Block& block : lane->blocks) {
+            for (std::size_t offset = 0; offset < block.used;) {
+                auto* command = reinterpret_cast<CommandHeader*>(block.data + offset);
+                command->destroy(block.data + offset + command->payloadOffset);
+                offset = command->next;
+            }
+            block.used = 0;
+        }
+        lane->current = 0;
+        lane->count = 0;
+    }
+}
+
+std::size_t CommandBuffer::size() const {
+    std::size_t count = 0;
+    for (const auto& lane : lanes_) {
+        count += lane->count;
+    }
+    return count;
+}
+
+void* CommandBuffer::reserve(Lane& lane, std::size_t payloadSize, std::size_t payloadAlignment) {
+    // Headers start at the payload's alignment, so the payload right after is aligned too
+    const std::size_t alignment = std::max(payloadAlignment, alignof(CommandHeader));
+    const std::size_t payloadOffset = alignUp(sizeof(CommandHeader), payloadAlignment);
+    const std::size_t commandBytes = payloadOffset + payloadSize;
+
+    // Blocks fill in order; the first one with room at its end takes the command
+    for (; lane.current < lane.blocks.size(); ++lane.current) {
+        const Block& block = lane.blocks[lane.current];
+        if (alignUp(block.used, alignment) + commandBytes <= block.capacity) {
+            break;
+        }
+    }
+    if (lane.current == lane.blocks.size()) {
+        // Oversized commands get a block of their own
+        const std::size_t capacity = std::max(BLOCK_BYTES, alignUp(commandBytes, BLOCK_ALIGNMENT));
+        auto* data = static_cast<std::byte*>(::operator new(capacity, std::align_val_t(BLOCK_ALIGNMENT)));
+        lane.blocks.push_back({ data, capacity });
+    }
+
+    Block& block = lane.blocks[lane.current];
+    const std::size_t offset = alignUp(block.used, alignment);
+    if (block.used > 0) {
+        // Step the previous command over the padding
+        reinterpret_cast<CommandHeader*>(block.data + block.last)->next = static_cast<std::uint32_t>(offset);
+    }
+    auto* command = reinterpret_cast<CommandHeader*>(block.data + offset);
+    command->payloadOffset = static_cast<std::uint32_t>(payloadOffset);
+    command->next = static_cast<std::uint32_t>(offset + commandBytes);
+    block.last = offset;
+    block.used = offset + commandBytes;
+    return command;
+}
+
+CommandBuffer::Lane& CommandBuffer::getLane() {
+    if (laneCache.bufferId == id_) {
+        return *static_cast<Lane*>(laneCache.lane);
+    }
+
+    std::lock_guard<std::mutex> lock(lanesMutex_);
+    Lane*& lane = laneByThread_[std::this_thread::get_id()];
+    if (!lane) {
+        lanes_.push_back(std::make_unique<Lane>());
+        lane = lanes_.back().get();
+    }
+    laneCache = { id_, lane };
+    return *lane;
+}
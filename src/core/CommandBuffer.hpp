@@ -0,0 +1,139 @@
+#ifndef COMMAND_BUFFER_HPP
+#define COMMAND_BUFFER_HPP
+
+#include "World.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Records World changes (create, destroy, add and remove components) to
+// apply later at a sync point, so systems can spawn and despawn while they
+// iterate, from any number of threads:
+//
+//     world.parallelEachChunk<const Health>(jobs, [&](std::size_t n, const EntityId* ids, const Health* h) {
+//         for (std::size_t i = 0; i < n; ++i) {
+//             if (h[i].value <= 0.0f) commands.destroy(ids[i]);
+//         }
+//     });
+//     ...
+//     commands.apply(world);
+//
+// Every recording thread gets its own lane, so recording takes no lock
+// once a thread has written to the buffer. Commands are packed into blocks
+// that are kept between frames, so a warm buffer doesn't allocate either.
+// apply() runs each lane's commands in the order they were recorded, one
+// lane after another. It must not overlap with recording. Commands on
+// entities that are gone by then are ignored, as World itself does.
+class CommandBuffer {
+public:
+    CommandBuffer();
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    template<typename... Ts>
+    void create(Ts... components) {
+        record<std::tuple<Ts...>>([](World& world, std::tuple<Ts...>& payload) {
+            std::apply([&world](Ts&... values) { world.create<Ts...>(std::move(values)...); }, payload);
+        }, std::move(components)...);
+    }
+
+    void destroy(EntityId entity) {
+        record<EntityId>([](World& world, EntityId& payload) { world.destroy(payload); }, entity);
+    }
+
+    // Add a component, or replace it when the entity already has one
+    template<typename T>
+    void add(EntityId entity, T component) {
+        record<std::pair<EntityId, T>>([](World& world, std::pair<EntityId, T>& payload) {
+            world.add<T>(payload.first, std::move(payload.second));
+        }, entity, std::move(component));
+    }
+
+    template<typename T>
+    void remove(EntityId entity) {
+        record<EntityId>([](World& world, EntityId& payload) { world.remove<T>(payload); }, entity);
+    }
+
+    // Apply and clear every recorded command. If one throws, the rest are
+    // dropped and the exception is rethrown once the buffer is empty.
+    void apply(World& world);
+
+    // Drop every recorded command
+    void clear();
+
+    // Recorded commands; only meaningful while no thread is recording
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr std::size_t BLOCK_BYTES = 16 * 1024;
+    static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+    // Precedes every payload. apply moves from the payload; destroy always
+    // runs after it.
+    struct CommandHeader {
+        void (*apply)(World& world, void* payload);
+        void (*destroy)(void* payload);
+        std::uint32_t payloadOffset; // From the header
+        std::uint32_t next;          // Offset of the next header, or the block's end
+    };
+
+    struct Block {
+        std::byte* data;
+        std::size_t capacity;
+        std::size_t used = 0;
+        std::size_t last = 0; // Header of the newest command
+    };
+
+    // Commands recorded by one thread
+    struct Lane {
+        std::vector<Block> blocks;
+        std::size_t current = 0; // Block being filled
+        std::size_t count = 0;
+    };
+
+    template<typename Payload, typename Apply, typename... Args>
+    void record(Apply, Args&&... args) {
+        static_assert(std::is_empty_v<Apply>, "Command functions must not capture");
+        static_assert(alignof(Payload) <= BLOCK_ALIGNMENT, "Command payload alignment exceeds the block alignment");
+
+        Lane& lane = getLane();
+        void* header = reserve(lane, sizeof(Payload), alignof(Payload));
+        CommandHeader& command = *static_cast<CommandHeader*>(header);
+        void* payload = static_cast<std::byte*>(header) + command.payloadOffset;
+
+        // A no-op until the payload exists, in case constructing it throws
+        command.apply = [](World&, void*) {};
+        command.destroy = [](void*) {};
+        new (payload) Payload{ std::forward<Args>(args)... };
+        command.apply = [](World& world, void* p) { Apply{}(world, *static_cast<Payload*>(p)); };
+        command.destroy = [](void* p) { static_cast<Payload*>(p)->~Payload(); };
+        ++lane.count;
+    }
+
+    // Room for a header and its payload in the lane's current block, moving
+    // on to the next block (or a new one) when it doesn't fit. Fills in the
+    // header's offsets.
+    void* reserve(Lane& lane, std::size_t payloadSize, std::size_t payloadAlignment);
+
+    Lane& getLane();
+
+    // Identifies this buffer in the per-thread lane cache; never reused
+    const std::uint64_t id_;
+    std::mutex lanesMutex_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::unordered_map<std::thread::id, Lane*> laneByThread_;
+};
+
+#endif // COMMAND_BUFFER_HPP
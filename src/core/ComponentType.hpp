@@ -0,0 +1,40 @@
+#ifndef COMPONENT_TYPE_HPP
+#define COMPONENT_TYPE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// Dense small integers for component types, shared by Entity and World.
+// Each type draws the next id the first time it is asked for one, so ids
+// fit a 64-bit mask and index plain arrays; no hashing of type_index.
+using ComponentTypeId = std::uint32_t;
+using ComponentMask = std::uint64_t;
+
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 64;
+
+namespace detail {
+
+    inline ComponentTypeId allocateComponentTypeId() {
+        static std::atomic<ComponentTypeId> next{ 0 };
+        const ComponentTypeId id = next.fetch_add(1, std::memory_order_relaxed);
+        if (id >= MAX_COMPONENT_TYPES) {
+            throw std::length_error("Too many component types; raise MAX_COMPONENT_TYPES");
+        }
+        return id;
+    }
+
+} // namespace detail
+
+template<typename T>
+ComponentTypeId getComponentTypeId() {
+    static const ComponentTypeId id = detail::allocateComponentTypeId();
+    return id;
+}
+
+template<typename T>
+ComponentMask getComponentMask() {
+    return ComponentMask(1) << getComponentTypeId<T>();
+}
+
+#endif // COMPONENT_TYPE_HPP
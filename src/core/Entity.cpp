@@ -2,29 +2,53 @@
 #include "Scene.hpp"
 #include "../gl/logger.hpp"
 
-Entity::Entity(Scene* scene, const std::string& name)
-    : scene_(scene), name_(name) {
-    gl::logDebug("Entity created: " + name);
+Entity::Entity(Scene* scene, const std::string& name, ComponentPools* componentPools)
+    : scene_(scene), name_(&ownedName_), ownedName_(name), componentPools_(componentPools) {
+    if (gl::isLogEnabled(gl::LogLevel::Debug)) {
+        gl::logDebug("Entity created: " + name);
+    }
+}
+
+Entity::Entity(Scene* scene, NameId nameId, const std::string& internedName, ComponentPools* componentPools)
+    : scene_(scene), name_(&internedName), nameId_(nameId), componentPools_(componentPools) {
+    if (gl::isLogEnabled(gl::LogLevel::Debug)) {
+        gl::logDebug("Entity created: " + internedName);
+    }
 }
 
 Entity::~Entity() {
-    gl::logDebug("Entity destroyed: " + name_);
+    for (std::size_t i = 0; i < componentCount_; ++i) {
+        const OwnedComponent& owned = components_[i];
+        if (owned.pool) {
+            // The most derived object is what the pool handed out
+            void* memory = dynamic_cast<void*>(owned.component);
+            owned.component->~Component();
+            owned.pool->deallocate(memory);
+        }
+        else {
+            delete owned.component;
+        }
+    }
+
+    if (gl::isLogEnabled(gl::LogLevel::Debug)) {
+        gl::logDebug("Entity destroyed: " + getName());
+    }
 }
 
 void Entity::init() {
-    for (auto& component : components_) {
-        component->init();
+    for (std::size_t i = 0; i < componentCount_; ++i) {
+        components_[i].component->init();
     }
 }
 
 void Entity::update(float deltaTime) {
-    for (auto& component : components_) {
-        component->update(deltaTime);
+    for (std::size_t i = 0; i < componentCount_; ++i) {
+        components_[i].component->update(deltaTime);
     }
 }
 
 void Entity::render() {
-    for (auto& component : components_) {
-        component->render();
+    for (std::size_t i = 0; i < componentCount_; ++i) {
+        components_[i].component->render();
     }
-}
\ No newline at end of file
+}
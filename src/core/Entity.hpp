@@ -1,63 +1,131 @@
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
 
+#include "BlockPool.hpp"
 #include "Component.hpp"
-#include <memory>
-#include <vector>
+#include "ComponentType.hpp"
+#include "EntityHandle.hpp"
+#include "NameTable.hpp"
+#include <array>
+#include <bit>
+#include <new>
+#include <stdexcept>
 #include <string>
-#include <typeindex>
-#include <unordered_map>
 
 class Scene;
 
 class Entity {
 public:
-    Entity(Scene* scene, const std::string& name = "Entity");
+    // Components come from componentPools when given, from the heap otherwise
+    Entity(Scene* scene, const std::string& name = "Entity", ComponentPools* componentPools = nullptr);
     ~Entity();
 
+    Entity(const Entity&) = delete;
+    Entity& operator=(const Entity&) = delete;
+
     void init();
     void update(float deltaTime);
     void render();
 
+    // Most components one entity can hold
+    static constexpr std::size_t MAX_COMPONENTS = 16;
+
     // Add a component
     template<typename T, typename... Args>
     T* addComponent(Args&&... args) {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
 
-        auto component = std::make_unique<T>(std::forward<Args>(args)...);
-        component->setEntity(this);
+        const ComponentTypeId typeId = getComponentTypeId<T>();
+        const ComponentMask bit = ComponentMask(1) << typeId;
+        const std::size_t slot = getSlot(typeId);
+        if (componentCount_ >= MAX_COMPONENTS) {
+            throw std::length_error("Entity " + getName() + " has too many components");
+        }
 
-        // Store component by type
-        std::type_index typeIdx = std::type_index(typeid(T));
-        componentsByType_[typeIdx] = component.get();
+        T* componentPtr;
+        BlockPool* pool = componentPools_ ? &componentPools_->get(typeId, sizeof(T), alignof(T)) : nullptr;
+        if (pool) {
+            void* memory = pool->allocate();
+            try {
+                componentPtr = new (memory) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                pool->deallocate(memory);
+                throw;
+            }
+        }
+        else {
+            componentPtr = new T(std::forward<Args>(args)...);
+        }
+        componentPtr->setEntity(this);
 
-        T* componentPtr = component.get();
-        components_.push_back(std::move(component));
+        // Slots stay ordered by type id; a second component of the same
+        // type replaces the first in lookups
+        if (!(componentMask_ & bit)) {
+            const std::size_t used = static_cast<std::size_t>(std::popcount(componentMask_));
+            for (std::size_t i = used; i > slot; --i) {
+                componentSlots_[i] = componentSlots_[i - 1];
+            }
+            componentMask_ |= bit;
+        }
+        componentSlots_[slot] = componentPtr;
+        components_[componentCount_++] = { componentPtr, pool };
 
         return componentPtr;
     }
 
-    // Get a component
+    // Get a component: a bit test and an array index
     template<typename T>
     T* getComponent() const {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
 
-        std::type_index typeIdx = std::type_index(typeid(T));
-        auto it = componentsByType_.find(typeIdx);
-        if (it != componentsByType_.end()) {
-            return static_cast<T*>(it->second);
+        const ComponentTypeId typeId = getComponentTypeId<T>();
+        if (componentMask_ & (ComponentMask(1) << typeId)) {
+            return static_cast<T*>(componentSlots_[getSlot(typeId)]);
         }
         return nullptr;
     }
 
+    template<typename T>
+    bool hasComponent() const {
+        return (componentMask_ & getComponentMask<T>()) != 0;
+    }
+
+    ComponentMask getComponentTypeMask() const { return componentMask_; }
+
     Scene* getScene() const { return scene_; }
-    const std::string& getName() const { return name_; }
+    const std::string& getName() const { return *name_; }
+
+    // Handle the owning scene resolves in O(1); null for entities made outside a scene
+    EntityHandle getHandle() const { return handle_; }
 
 private:
+    friend class Scene;
+
+    // Scene entities share the scene's interned copy of their name
+    Entity(Scene* scene, NameId nameId, const std::string& internedName, ComponentPools* componentPools);
+
+    // Slot of a type id: the number of present types with smaller ids
+    std::size_t getSlot(ComponentTypeId typeId) const {
+        return static_cast<std::size_t>(std::popcount(componentMask_ & ((ComponentMask(1) << typeId) - 1)));
+    }
+
+    // Components in the order added, with the pool each came from
+    struct OwnedComponent {
+        Component* component;
+        BlockPool* pool;
+    };
+
     Scene* scene_;
-    std::string name_;
-    std::vector<std::unique_ptr<Component>> components_;
-    std::unordered_map<std::type_index, Component*> componentsByType_;
+    const std::string* name_;
+    std::string ownedName_; // Used by entities outside a scene
+    EntityHandle handle_;
+    NameId nameId_ = INVALID_NAME;
+    ComponentPools* componentPools_;
+    std::array<OwnedComponent, MAX_COMPONENTS> components_ = {};
+    std::size_t componentCount_ = 0;
+    ComponentMask componentMask_ = 0;
+    std::array<Component*, MAX_COMPONENTS> componentSlots_ = {};
 };
 
 #endif // ENTITY_HPP
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef ENTITY_HANDLE_HPP
+#define ENTITY_HANDLE_HPP
+
+#include <cstdint>
+
+// Reference to a Scene entity that can outlive it. The index picks a slot
+// in the scene's slot map; the generation must match the slot's, which
+// changes every time the slot's entity is destroyed, so a handle to a
+// destroyed entity resolves to nullptr instead of to whatever reused the slot.
+struct EntityHandle {
+    static constexpr std::uint32_t INVALID_INDEX = ~std::uint32_t(0);
+
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isNull() const { return index == INVALID_INDEX; }
+
+    friend bool operator==(const EntityHandle& a, const EntityHandle& b) = default;
+};
+
+#endif // ENTITY_HANDLE_HPP
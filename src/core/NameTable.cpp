@@ -0,0 +1,17 @@
+#include "NameTable.hpp"
+
+NameId NameTable::intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const NameId id = static_cast<NameId>(strings_.size());
+    it = ids_.emplace(std::string(name), id).first;
+    strings_.push_back(&it->first);
+    return id;
+}
+
+NameId NameTable::find(std::string_view name) const {
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : INVALID_NAME;
+}
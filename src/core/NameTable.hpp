@@ -0,0 +1,36 @@
+#ifndef NAME_TABLE_HPP
+#define NAME_TABLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using NameId = std::uint32_t;
+constexpr NameId INVALID_NAME = ~NameId(0);
+
+// Interns strings to dense ids. Each distinct string is stored once, and
+// lookups take a string_view so finding a name never allocates.
+class NameTable {
+public:
+    NameId intern(std::string_view name);
+
+    // Id of an already interned name, or INVALID_NAME
+    NameId find(std::string_view name) const;
+
+    const std::string& getString(NameId id) const { return *strings_[id]; }
+    std::size_t size() const { return strings_.size(); }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::unordered_map<std::string, NameId, Hash, std::equal_to<>> ids_;
+    std::vector<const std::string*> strings_; // Keys of ids_, which stay put on rehash
+};
+
+#endif // NAME_TABLE_HPP
@@ -9,12 +9,78 @@
 #include "../components/input/InputHandler.hpp"
 #include "../gl/logger.hpp"
 
+#include <algorithm>
+#include <array>
+
+namespace {
+
+    // Inward-facing planes (xyz normal, w distance) of a view-projection
+    // frustum, taken from the rows of the matrix
+    using FrustumPlanes = std::array<glm::vec4, 6>;
+
+    FrustumPlanes getFrustumPlanes(const glm::mat4& viewProjection) {
+        const glm::mat4 m = glm::transpose(viewProjection);
+        FrustumPlanes planes = { m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2] };
+        for (glm::vec4& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return planes;
+    }
+
+    bool isSphereInFrustum(const FrustumPlanes& planes, const glm::mat4& model, float radius) {
+        const glm::vec3 center = glm::vec3(model[3]);
+        const float scale = std::max({ glm::length(glm::vec3(model[0])),
+            glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * scale) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
 Scene::Scene(Window& window, ResourceManager& resourceManager)
     : window_(window), resourceManager_(resourceManager) {
 
     // Register this scene with the window
     window_.addScene(this);
 
+    // Entity components may touch GL, input and each other, so their
+    // updates stay on the main thread, ahead of the World systems added later
+    systems_.addSystem("EntityUpdates", makeSystemAccess<MainThread>(), [this](World&, gl::JobSystem&, float deltaTime) {
+        for (auto& entity : entities_) {
+            entity->update(deltaTime);
+        }
+    });
+
+    // Each mesh only writes itself, so meshes animate across the job system,
+    // and the camera matrices are read alongside
+    animationSystems_.addSystem("MeshAnimation", makeSystemAccess<Writes<MeshComponent>>(), [this](World&, gl::JobSystem& jobs, float deltaTime) {
+        jobs.parallelFor(entities_.size(), 64, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (auto mesh = entities_[i]->getComponent<MeshComponent>()) {
+                    mesh->animate(deltaTime);
+                    // Fill the lazy caches now, so the later phases only read them
+                    mesh->getModelMatrix();
+                }
+            }
+        });
+    });
+    animationSystems_.addSystem("CameraMatrices", makeSystemAccess<Reads<CameraComponent>>(), [this](World&, gl::JobSystem&, float) {
+        view_ = glm::mat4(1.0f);
+        projection_ = glm::mat4(1.0f);
+        hasCamera_ = false;
+        if (Entity* cameraEntity = findEntity("MainCamera")) {
+            if (auto camera = cameraEntity->getComponent<CameraComponent>()) {
+                view_ = camera->getViewMatrix();
+                projection_ = camera->getProjectionMatrix();
+                hasCamera_ = true;
+            }
+        }
+    });
+
     gl::logInfo("Scene created");
 }
 
@@ -24,6 +90,8 @@ Scene::~Scene() {
 
     // Clear entities in reverse order
     while (!entities_.empty()) {
+        entitySlots_[entities_.back()->getHandle().index].entity = nullptr;
+        releaseEntity(entities_.back());
         entities_.pop_back();
     }
 
@@ -37,42 +105,97 @@ void Scene::init() {
     for (auto& entity : entities_) {
         entity->init();
     }
+    initialized_ = true;
 
     gl::logInfo("Scene initialized");
 }
 
 void Scene::update(float deltaTime) {
+    updateEntities(deltaTime);
+    animate(deltaTime);
+    solveHomographies();
+}
+
+void Scene::render() {
+    cull();
+    recordDraws();
+    submit();
+}
+
+void Scene::updateEntities(float deltaTime) {
     deltaTime_ = deltaTime;
+    systems_.run(world_, getJobSystem(), deltaTime);
+    applyCommands();
+}
 
-    // Update all entities
+void Scene::animate(float deltaTime) {
+    animationSystems_.run(world_, getJobSystem(), deltaTime);
+}
+
+void Scene::solveHomographies() {
+    if (!hasCamera_) return;
+
+    if (Entity* homographyEntity = findEntity("HomographyEffect")) {
+        if (auto homographyEffect = homographyEntity->getComponent<HomographyEffect>()) {
+            homographyEffect->solve(view_, projection_);
+        }
+    }
+}
+
+void Scene::cull() {
+    const FrustumPlanes frustum = getFrustumPlanes(projection_ * view_);
+
+    visibleRenderers_.clear();
     for (auto& entity : entities_) {
-        entity->update(deltaTime);
+        auto renderer = entity->getComponent<MeshRenderer>();
+        if (!renderer) continue;
+
+        // Only meshes placed by their own transform have a known bounding sphere
+        MeshComponent* mesh = renderer->getMesh();
+        if (mesh && !renderer->hasExternalModelMatrix() &&
+            !isSphereInFrustum(frustum, mesh->getCachedModelMatrix(), mesh->getBoundingRadius())) {
+            continue;
+        }
+        visibleRenderers_.push_back(renderer);
     }
+}
 
-    // Explicitly update mesh animations
-    Entity* cubeEntity = findEntity("Cube");
-    if (cubeEntity) {
-        auto cubeMesh = cubeEntity->getComponent<MeshComponent>();
-        if (cubeMesh) {
-            cubeMesh->animate(deltaTime);
+void Scene::recordDraws() {
+    drawList_.clear();
+    for (MeshRenderer* renderer : visibleRenderers_) {
+        glm::mat4 mvp;
+        if (renderer->computeMVP(view_, projection_, mvp)) {
+            drawList_.push_back({ renderer, mvp });
         }
     }
+
+    // Group by shader, then texture, to save state changes
+    std::stable_sort(drawList_.begin(), drawList_.end(), [](const DrawCommand& a, const DrawCommand& b) {
+        const auto* shaderA = a.renderer->getShader().get();
+        const auto* shaderB = b.renderer->getShader().get();
+        if (shaderA != shaderB) return shaderA < shaderB;
+        return a.renderer->getTexture().get() < b.renderer->getTexture().get();
+    });
 }
 
-void Scene::render() {
+void Scene::submit() {
     // Set a dark background color
     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Render all entities EXCEPT HomographyEffect entity
+    for (const DrawCommand& command : drawList_) {
+        command.renderer->draw(command.mvp);
+    }
+
+    // Entities without a MeshRenderer render as before, EXCEPT the
+    // HomographyEffect entity, whose tiles go over everything else
+    Entity* homographyEntity = findEntity("HomographyEffect");
     for (auto& entity : entities_) {
-        if (entity->getName() != "HomographyEffect") {
+        if (entity != homographyEntity && !entity->getComponent<MeshRenderer>()) {
             entity->render();
         }
     }
 
-    // Now render HomographyEffect entity separately
-    Entity* homographyEntity = findEntity("HomographyEffect");
     if (homographyEntity) {
         auto homographyEffect = homographyEntity->getComponent<HomographyEffect>();
         if (homographyEffect) {
@@ -90,20 +213,130 @@ void Scene::onWindowResize(int width, int height) {
     }
 }
 
-Entity* Scene::createEntity(const std::string& name) {
-    auto entity = std::make_unique<Entity>(this, name);
-    Entity* entityPtr = entity.get();
-    entities_.push_back(std::move(entity));
+Entity* Scene::createEntity(std::string_view name) {
+    std::uint32_t index;
+    if (!freeEntitySlots_.empty()) {
+        index = freeEntitySlots_.back();
+        freeEntitySlots_.pop_back();
+    }
+    else {
+        index = static_cast<std::uint32_t>(entitySlots_.size());
+        entitySlots_.emplace_back();
+    }
+
+    const NameId nameId = entityNames_.intern(name);
+    void* memory = entityPool_.allocate();
+    Entity* entityPtr = new (memory) Entity(this, nameId, entityNames_.getString(nameId), &componentPools_);
+
+    EntitySlot& slot = entitySlots_[index];
+    slot.entity = entityPtr;
+    entityPtr->handle_ = { index, slot.generation };
+    entities_.push_back(entityPtr);
+
+    // Only the first live entity with a name is indexed, as the old linear search found
+    if (entityPtr->nameId_ >= entitiesByName_.size()) {
+        entitiesByName_.resize(entityPtr->nameId_ + 1);
+    }
+    if (!isAlive(entitiesByName_[entityPtr->nameId_])) {
+        entitiesByName_[entityPtr->nameId_] = entityPtr->handle_;
+    }
     return entityPtr;
 }
 
-Entity* Scene::findEntity(const std::string& name) {
-    for (const auto& entity : entities_) {
-        if (entity->getName() == name) {
-            return entity.get();
+bool Scene::destroyEntity(EntityHandle handle) {
+    return destroyEntities({ &handle, 1 }) == 1;
+}
+
+std::size_t Scene::destroyEntities(std::span<const EntityHandle> handles) {
+    // Retire the handles first; the entities stay alive until the list is compacted
+    destroyedEntities_.clear();
+    bool namesVacated = false;
+    for (EntityHandle handle : handles) {
+        Entity* entity = getEntity(handle);
+        if (!entity) {
+            continue;
+        }
+        EntitySlot& slot = entitySlots_[handle.index];
+        ++slot.generation;
+        slot.entity = nullptr;
+        freeEntitySlots_.push_back(handle.index);
+        if (entitiesByName_[entity->nameId_] == handle) {
+            entitiesByName_[entity->nameId_] = {};
+            namesVacated = true;
+        }
+        destroyedEntities_.push_back(entity);
+    }
+    if (destroyedEntities_.empty()) {
+        return 0;
+    }
+
+    std::erase_if(entities_, [this](Entity* entity) { return !isAlive(entity->handle_); });
+    for (Entity* entity : destroyedEntities_) {
+        releaseEntity(entity);
+    }
+
+    // Hand each vacated name to the next-oldest entity that shares it, if any
+    if (namesVacated) {
+        for (Entity* entity : entities_) {
+            if (!isAlive(entitiesByName_[entity->nameId_])) {
+                entitiesByName_[entity->nameId_] = entity->handle_;
+            }
+        }
+    }
+    return destroyedEntities_.size();
+}
+
+void Scene::deferCreateEntity(std::string name, std::function<void(Entity&)> setup) {
+    deferEntityCommand([name = std::move(name), setup = std::move(setup)](Scene& scene) {
+        Entity* entity = scene.createEntity(name);
+        if (setup) {
+            setup(*entity);
         }
+        if (scene.initialized_) {
+            entity->init();
+        }
+    });
+}
+
+void Scene::deferDestroyEntity(EntityHandle handle) {
+    std::lock_guard<std::mutex> lock(deferredMutex_);
+    deferredDestroys_.push_back(handle);
+}
+
+void Scene::deferEntityCommand(std::function<void(Scene&)> command) {
+    std::lock_guard<std::mutex> lock(deferredMutex_);
+    deferredCommands_.push_back(std::move(command));
+}
+
+void Scene::applyCommands() {
+    commands_.apply(world_);
+
+    // Take the queues, so commands may defer more work to the next sync point
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex_);
+        applyingCommands_.swap(deferredCommands_);
+        applyingDestroys_.swap(deferredDestroys_);
+    }
+    for (auto& command : applyingCommands_) {
+        command(*this);
     }
-    return nullptr;
+    applyingCommands_.clear();
+    destroyEntities(applyingDestroys_);
+    applyingDestroys_.clear();
+}
+
+void Scene::releaseEntity(Entity* entity) {
+    entity->~Entity();
+    entityPool_.deallocate(entity);
+}
+
+Entity* Scene::findEntity(std::string_view name) const {
+    return getEntity(findEntityHandle(name));
+}
+
+EntityHandle Scene::findEntityHandle(std::string_view name) const {
+    const NameId nameId = entityNames_.find(name);
+    return nameId < entitiesByName_.size() ? entitiesByName_[nameId] : EntityHandle{};
 }
 
 void Scene::setupScene() {
@@ -138,34 +371,57 @@ void Scene::setupScene() {
         "resources/shaders/cube/cube.frag"
     );
 
-    // Create cube entity
-    Entity* cubeEntity = createEntity("Cube");
-    auto cubeMesh = cubeEntity->addComponent<MeshComponent>();
-    cubeMesh->createCube();
+    auto decalShader = resourceManager_.loadShader(
+        "decal",
+        "resources/shaders/decal/decal.vert",
+        "resources/shaders/decal/decal.frag"
+    );
+
+    // Create cube entities, each spinning about its own axis
+    struct CubeSetup {
+        const char* name;
+        glm::vec3 position;
+        glm::vec3 axis;
+    };
+    const CubeSetup cubes[] = {
+        { "Cube", glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f) },
+        { "CubeLeft", glm::vec3(-1.8f, 0.3f, -1.5f), glm::vec3(0.0f, 1.0f, 1.0f) },
+        { "CubeRight", glm::vec3(1.8f, 0.3f, -1.5f), glm::vec3(1.0f, 0.0f, 1.0f) }
+    };
 
-    // Set the rotation axis and initial angle
-    cubeMesh->setRotation(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+    std::vector<EntityHandle> cubeEntities;
+    for (const CubeSetup& setup : cubes) {
+        Entity* cubeEntity = createEntity(setup.name);
+        auto cubeMesh = cubeEntity->addComponent<MeshComponent>();
+        cubeMesh->createCube();
+        cubeMesh->setPosition(setup.position);
 
-    // Enable auto-rotation
-    cubeMesh->setAutoRotate(true);
+        // Set the rotation axis and initial angle
+        cubeMesh->setRotation(30.0f, setup.axis);
 
-    // Set up cube renderer with texture
-    auto cubeRenderer = cubeEntity->addComponent<MeshRenderer>();
-    cubeRenderer->setShader(cubeShader);
-    cubeRenderer->setTexture(texture);
+        // Enable auto-rotation
+        cubeMesh->setAutoRotate(true);
 
-    // Create homography quad
+        // Set up cube renderer with texture
+        auto cubeRenderer = cubeEntity->addComponent<MeshRenderer>();
+        cubeRenderer->setShader(cubeShader);
+        cubeRenderer->setTexture(texture);
+
+        cubeEntities.push_back(cubeEntity->getHandle());
+    }
+
+    // Create homography decal quad; its mesh is drawn once per visible cube face
     Entity* homographyEntity = createEntity("HomographyEffect");
     auto quadMesh = homographyEntity->addComponent<MeshComponent>();
     quadMesh->createQuad();
 
-    // Add the required MeshRenderer component for the quad
-    auto quadRenderer = homographyEntity->addComponent<MeshRenderer>();
-    quadRenderer->setShader(cubeShader);
-    quadRenderer->setTexture(texture);
-
     // Add the homography effect component
     auto homographyEffect = homographyEntity->addComponent<HomographyEffect>();
+    homographyEffect->setShader(decalShader);
+    homographyEffect->setTexture(texture);
+    for (EntityHandle cubeEntity : cubeEntities) {
+        homographyEffect->addTarget(cubeEntity);
+    }
 
     gl::logInfo("Scene setup complete");
 }
\ No newline at end of file
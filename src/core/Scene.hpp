@@ -1,13 +1,22 @@
 #ifndef SCENE_HPP
 #define SCENE_HPP
 
+#include "CommandBuffer.hpp"
 #include "Entity.hpp"
+#include "SystemScheduler.hpp"
+#include "World.hpp"
+#include <glm/glm.hpp>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
 #include <vector>
 #include <string>
 
 class Window;
 class ResourceManager;
+class MeshRenderer;
 
 class Scene {
 public:
@@ -18,13 +27,82 @@ public:
     virtual void update(float deltaTime);
     virtual void render();
 
+    // The frame in phases. update() runs updateEntities, animate and
+    // solveHomographies, and render() runs cull, recordDraws and submit; a
+    // TaskGraph can run the phases instead, with solveHomographies and the
+    // cull/record chain side by side. solveHomographies only starts the
+    // HomographyEffect's background solve, so submit needn't wait for it.
+    // A graph calls the phases directly, so it doesn't see overrides of
+    // update() and render().
+    // updateEntities and animate run the scene's systems (see getSystems).
+    // updateEntities and submit touch input and GL and must stay on the main
+    // thread. The rest only read entities and write their own outputs, and
+    // must run after animate: it refreshes the cached transforms and camera
+    // matrices they read (MeshComponent::getCachedModelMatrix asserts this).
+    void updateEntities(float deltaTime);
+    void animate(float deltaTime);
+    void solveHomographies();
+    void cull();
+    void recordDraws();
+    void submit();
+
     void onWindowResize(int width, int height);
 
     // Create a new entity
-    Entity* createEntity(const std::string& name = "Entity");
+    Entity* createEntity(std::string_view name = "Entity");
+
+    // Destroy an entity and invalidate its handle. Not safe while the
+    // scene is iterating its entities (update, render); defer it there
+    bool destroyEntity(EntityHandle handle);
+
+    // Destroy a batch of entities with one pass over the entity list.
+    // Returns how many were still alive
+    std::size_t destroyEntities(std::span<const EntityHandle> handles);
+
+    // Entity changes to make at the next sync point instead of right away.
+    // Safe from inside component updates and from any thread. Entities and
+    // components made this way are initialized if the scene already is.
+    void deferCreateEntity(std::string name, std::function<void(Entity&)> setup = {});
+    void deferDestroyEntity(EntityHandle handle);
+
+    template<typename T, typename... Args>
+    void deferAddComponent(EntityHandle handle, Args... args) {
+        deferEntityCommand([handle, ... args = std::move(args)](Scene& scene) mutable {
+            if (Entity* entity = scene.getEntity(handle)) {
+                T* component = entity->addComponent<T>(std::move(args)...);
+                if (scene.initialized_) {
+                    component->init();
+                }
+            }
+        });
+    }
+
+    // World changes recorded during the frame, e.g. by systems
+    CommandBuffer& getCommands() { return commands_; }
 
-    // Find an entity by name
-    Entity* findEntity(const std::string& name);
+    // Sync point: apply the World commands, then deferred entity creation
+    // and components in order, then deferred destruction as one batch.
+    // updateEntities calls it once the updates are done.
+    void applyCommands();
+
+    // Resolve a handle; nullptr once its entity has been destroyed
+    Entity* getEntity(EntityHandle handle) const {
+        if (handle.index < entitySlots_.size()) {
+            const EntitySlot& slot = entitySlots_[handle.index];
+            if (slot.generation == handle.generation) {
+                return slot.entity;
+            }
+        }
+        return nullptr;
+    }
+
+    bool isAlive(EntityHandle handle) const { return getEntity(handle) != nullptr; }
+
+    // Find an entity by name; the first one created when several share it
+    Entity* findEntity(std::string_view name) const;
+    EntityHandle findEntityHandle(std::string_view name) const;
+
+    std::size_t getEntityCount() const { return entities_.size(); }
 
     // Getters
     Window& getWindow() const { return window_; }
@@ -32,13 +110,76 @@ public:
 
     float getDeltaTime() const { return deltaTime_; }
 
+    // Dense storage for bulk plain-data entities (particles, instances, ...)
+    World& getWorld() { return world_; }
+
+    // Systems run by updateEntities on the job system, then the sync point.
+    // The first one is the main-thread "EntityUpdates" (Entity::update for
+    // every entity), so World systems added here run after it
+    SystemScheduler& getSystems() { return systems_; }
+
+    // Job system for parallel updates; the process default when none is set
+    void setJobSystem(gl::JobSystem* jobSystem) { jobSystem_ = jobSystem; }
+    gl::JobSystem& getJobSystem() const { return jobSystem_ ? *jobSystem_ : gl::getDefaultJobSystem(); }
+
 protected:
     Window& window_;
     ResourceManager& resourceManager_;
-    std::vector<std::unique_ptr<Entity>> entities_;
+    // Entities and their components come from pools owned by the scene,
+    // so spawning and despawning reuse memory instead of going to the heap
+    BlockPool entityPool_{ sizeof(Entity), alignof(Entity) };
+    ComponentPools componentPools_;
+
+    // Entities live in a slot map indexed by handle; entities_ keeps them
+    // in creation order for update and render
+    struct EntitySlot {
+        Entity* entity = nullptr;
+        std::uint32_t generation = 0;
+    };
+    std::vector<EntitySlot> entitySlots_;
+    std::vector<std::uint32_t> freeEntitySlots_;
+    std::vector<Entity*> entities_;
+
+    // Interned entity names and, per name, the first entity created with it
+    NameTable entityNames_;
+    std::vector<EntityHandle> entitiesByName_;
+
+    World world_;
+    SystemScheduler systems_;
+    SystemScheduler animationSystems_; // Mesh animation and camera matrices, run by animate
+    gl::JobSystem* jobSystem_ = nullptr;
     float deltaTime_ = 0.0f;
 
+    // Per-frame outputs of the phases: camera matrices from animate, the
+    // renderers that passed the frustum test and their sorted draws
+    struct DrawCommand {
+        MeshRenderer* renderer;
+        glm::mat4 mvp;
+    };
+    glm::mat4 view_ = glm::mat4(1.0f);
+    glm::mat4 projection_ = glm::mat4(1.0f);
+    bool hasCamera_ = false;
+    std::vector<MeshRenderer*> visibleRenderers_;
+    std::vector<DrawCommand> drawList_;
+
     virtual void setupScene();
+
+private:
+    void releaseEntity(Entity* entity);
+    void deferEntityCommand(std::function<void(Scene&)> command);
+
+    CommandBuffer commands_;
+    bool initialized_ = false;
+
+    // Deferred entity changes, guarded by deferredMutex_
+    std::mutex deferredMutex_;
+    std::vector<std::function<void(Scene&)>> deferredCommands_;
+    std::vector<EntityHandle> deferredDestroys_;
+
+    // Scratch space for applyCommands and destroyEntities, kept between frames
+    std::vector<std::function<void(Scene&)>> applyingCommands_;
+    std::vector<EntityHandle> applyingDestroys_;
+    std::vector<Entity*> destroyedEntities_;
 };
 
 #endif // SCENE_HPP
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "SystemScheduler.hpp"
+
+#include <algorithm>
+
+void SystemScheduler::addSystem(const std::string& name, const SystemAccess& access, SystemFunction update) {
+    // A system goes one phase after the latest earlier system it conflicts with
+    std::size_t phase = 0;
+    for (std::size_t p = 0; p < phases_.size(); ++p) {
+        for (std::size_t other : phases_[p]) {
+            if (access.conflictsWith(systems_[other].access)) {
+                phase = p + 1;
+            }
+        }
+    }
+
+    systems_.push_back({ name, access, std::move(update) });
+    if (phase == phases_.size()) {
+        phases_.emplace_back();
+    }
+    phases_[phase].push_back(systems_.size() - 1);
+}
+
+void SystemScheduler::run(World& world, gl::JobSystem& jobs, float deltaTime) {
+    for (const std::vector<std::size_t>& phase : phases_) {
+        // A lone system, main-thread ones included, runs on this thread
+        if (phase.size() == 1) {
+            systems_[phase[0]].update(world, jobs, deltaTime);
+            continue;
+        }
+        jobs.parallelFor(phase.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                systems_[phase[i]].update(world, jobs, deltaTime);
+            }
+        });
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef SYSTEM_SCHEDULER_HPP
+#define SYSTEM_SCHEDULER_HPP
+
+#include "ComponentType.hpp"
+#include "World.hpp"
+#include "gl/job_system.hpp"
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Component access of a system, as masks of component type ids. A
+// main-thread system (GL, input, arbitrary entities) conflicts with every
+// other, so it has a phase to itself and run() calls it on its own thread.
+struct SystemAccess {
+    ComponentMask reads = 0;
+    ComponentMask writes = 0;
+    bool mainThread = false;
+
+    // Two systems conflict when either writes something the other touches
+    bool conflictsWith(const SystemAccess& other) const {
+        return mainThread || other.mainThread ||
+            (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+    }
+};
+
+template<typename... Ts>
+struct Reads {};
+
+template<typename... Ts>
+struct Writes {};
+
+struct MainThread {};
+
+namespace detail {
+
+    template<typename... Ts>
+    void addAccess(SystemAccess& access, Reads<Ts...>) {
+        access.reads |= (ComponentMask(0) | ... | getComponentMask<Ts>());
+    }
+
+    template<typename... Ts>
+    void addAccess(SystemAccess& access, Writes<Ts...>) {
+        access.writes |= (ComponentMask(0) | ... | getComponentMask<Ts>());
+    }
+
+    inline void addAccess(SystemAccess& access, MainThread) {
+        access.mainThread = true;
+    }
+
+} // namespace detail
+
+// Access set from Reads<...>, Writes<...> and MainThread:
+//     makeSystemAccess<Writes<Position>, Reads<Velocity>>()
+template<typename... Lists>
+SystemAccess makeSystemAccess() {
+    SystemAccess access;
+    (detail::addAccess(access, Lists{}), ...);
+    return access;
+}
+
+// Runs World systems once per frame on a job system. Systems keep their
+// registration order wherever their component access conflicts; the rest
+// share a phase and run at the same time. Inside a system, World work can
+// be split further with World::parallelEachChunk.
+class SystemScheduler {
+public:
+    using SystemFunction = std::function<void(World& world, gl::JobSystem& jobs, float deltaTime)>;
+
+    void addSystem(const std::string& name, const SystemAccess& access, SystemFunction update);
+
+    void run(World& world, gl::JobSystem& jobs, float deltaTime);
+
+    std::size_t getSystemCount() const { return systems_.size(); }
+
+    // Systems per phase, by registration index; phases run one after another
+    const std::vector<std::vector<std::size_t>>& getPhases() const { return phases_; }
+    const std::string& getSystemName(std::size_t system) const { return systems_[system].name; }
+
+private:
+    struct System {
+        std::string name;
+        SystemAccess access;
+        SystemFunction update;
+    };
+
+    std::vector<System> systems_;
+    std::vector<std::vector<std::size_t>> phases_;
+};
+
+#endif // SYSTEM_SCHEDULER_HPP
@@ -0,0 +1,188 @@
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+TaskGraph::TaskId TaskGraph::addTask(const std::string& name, std::function<void()> fn,
+    Affinity affinity, std::initializer_list<TaskId> dependencies) {
+    const TaskId id = tasks_.size();
+    tasks_.emplace_back(name, std::move(fn), affinity);
+    for (TaskId dependency : dependencies) {
+        addDependency(id, dependency);
+    }
+    compiled_ = false;
+    return id;
+}
+
+void TaskGraph::addDependency(TaskId task, TaskId dependency) {
+    if (task >= tasks_.size() || dependency >= tasks_.size() || task == dependency) {
+        throw std::invalid_argument("TaskGraph dependency between unknown or identical tasks");
+    }
+    tasks_[task].dependencies.push_back(dependency);
+    tasks_[dependency].dependents.push_back(task);
+    compiled_ = false;
+}
+
+void TaskGraph::compile() {
+    // Kahn's algorithm; anything left over sits on a cycle
+    std::vector<std::size_t> pending(tasks_.size());
+    order_.clear();
+    for (TaskId id = 0; id < tasks_.size(); ++id) {
+        pending[id] = tasks_[id].dependencies.size();
+        if (pending[id] == 0) {
+            order_.push_back(id);
+        }
+    }
+    for (std::size_t i = 0; i < order_.size(); ++i) {
+        for (TaskId dependent : tasks_[order_[i]].dependents) {
+            if (--pending[dependent] == 0) {
+                order_.push_back(dependent);
+            }
+        }
+    }
+    if (order_.size() != tasks_.size()) {
+        throw std::logic_error("TaskGraph has a dependency cycle");
+    }
+
+    remaining_ = std::make_unique<std::atomic<std::size_t>[]>(tasks_.size());
+    mainReady_.reserve(tasks_.size());
+    compiled_ = true;
+}
+
+void TaskGraph::run(gl::JobSystem& jobs) {
+    if (!compiled_) {
+        compile();
+    }
+
+    for (TaskId id = 0; id < tasks_.size(); ++id) {
+        remaining_[id].store(tasks_[id].dependencies.size(), std::memory_order_relaxed);
+    }
+    completed_.store(0, std::memory_order_relaxed);
+    failed_.store(false, std::memory_order_relaxed);
+    failure_ = nullptr;
+    runStart_ = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    for (TaskId id : order_) {
+        if (tasks_[id].dependencies.empty()) {
+            schedule(id, jobs);
+        }
+    }
+
+    // Run main-thread tasks as they become ready and help with jobs otherwise
+    while (completed_.load(std::memory_order_acquire) < tasks_.size()) {
+        TaskId ready = tasks_.size();
+        {
+            std::lock_guard<std::mutex> lock(mainMutex_);
+            if (!mainReady_.empty()) {
+                ready = mainReady_.back();
+                mainReady_.pop_back();
+            }
+        }
+        if (ready < tasks_.size()) {
+            execute(ready, jobs);
+        }
+        else if (!jobs.runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+    jobs.wait(jobCounter_);
+    runSeconds_ = now();
+
+    if (failure_) {
+        std::rethrow_exception(failure_);
+    }
+}
+
+void TaskGraph::schedule(TaskId task, gl::JobSystem& jobs) {
+    if (tasks_[task].affinity == Affinity::MainThread) {
+        std::lock_guard<std::mutex> lock(mainMutex_);
+        mainReady_.push_back(task);
+    }
+    else {
+        jobs.run(jobCounter_, [this, task, &jobs] { execute(task, jobs); });
+    }
+}
+
+void TaskGraph::execute(TaskId task, gl::JobSystem& jobs) {
+    Task& t = tasks_[task];
+    t.start = now();
+    if (!failed_.load(std::memory_order_acquire)) {
+        try {
+            t.fn();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mainMutex_);
+            if (!failure_) {
+                failure_ = std::current_exception();
+            }
+            failed_.store(true, std::memory_order_release);
+        }
+    }
+    t.end = now();
+
+    for (TaskId dependent : t.dependents) {
+        if (remaining_[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(dependent, jobs);
+        }
+    }
+    completed_.fetch_add(1, std::memory_order_release);
+}
+
+double TaskGraph::now() const {
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch().count() - runStart_;
+    return std::chrono::duration<double>(std::chrono::steady_clock::duration(elapsed)).count();
+}
+
+std::vector<TaskGraph::TaskId> TaskGraph::getCriticalPath(double* seconds) const {
+    // Longest path by duration, walking tasks in topological order
+    std::vector<double> finish(tasks_.size(), 0.0);
+    std::vector<TaskId> previous(tasks_.size(), tasks_.size());
+    TaskId last = tasks_.size();
+    for (TaskId id : order_) {
+        double start = 0.0;
+        for (TaskId dependency : tasks_[id].dependencies) {
+            if (finish[dependency] > start) {
+                start = finish[dependency];
+                previous[id] = dependency;
+            }
+        }
+        finish[id] = start + getTaskSeconds(id);
+        if (last == tasks_.size() || finish[id] > finish[last]) {
+            last = id;
+        }
+    }
+
+    std::vector<TaskId> path;
+    for (TaskId id = last; id < tasks_.size(); id = previous[id]) {
+        path.push_back(id);
+    }
+    std::reverse(path.begin(), path.end());
+    if (seconds) {
+        *seconds = last < tasks_.size() ? finish[last] : 0.0;
+    }
+    return path;
+}
+
+std::string TaskGraph::describeCriticalPath() const {
+    double pathSeconds = 0.0;
+    const std::vector<TaskId> path = getCriticalPath(&pathSeconds);
+
+    double workSeconds = 0.0;
+    for (TaskId id = 0; id < tasks_.size(); ++id) {
+        workSeconds += getTaskSeconds(id);
+    }
+
+    std::string text;
+    char buffer[128];
+    for (TaskId id : path) {
+        std::snprintf(buffer, sizeof(buffer), "%s%s %.3f ms", text.empty() ? "" : " -> ",
+            tasks_[id].name.c_str(), getTaskSeconds(id) * 1e3);
+        text += buffer;
+    }
+    std::snprintf(buffer, sizeof(buffer), " | critical path %.3f ms, work %.3f ms, wall %.3f ms",
+        pathSeconds * 1e3, workSeconds * 1e3, runSeconds_ * 1e3);
+    return text + buffer;
+}
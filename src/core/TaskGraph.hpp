@@ -0,0 +1,91 @@
+#ifndef TASK_GRAPH_HPP
+#define TASK_GRAPH_HPP
+
+#include "gl/job_system.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A fixed set of tasks with dependencies, built once and run many times
+// (typically once per frame). Each run starts every task as soon as its
+// dependencies have finished: main-thread tasks on the thread calling
+// run(), the rest on the job system, so independent CPU work overlaps.
+// Task durations of the last run are kept for reporting the critical path.
+class TaskGraph {
+public:
+    using TaskId = std::size_t;
+
+    enum class Affinity {
+        AnyThread,
+        MainThread // Needs the GL context or window, which live on the main thread
+    };
+
+    TaskId addTask(const std::string& name, std::function<void()> fn,
+        Affinity affinity = Affinity::AnyThread, std::initializer_list<TaskId> dependencies = {});
+    void addDependency(TaskId task, TaskId dependency);
+
+    // Check for cycles and fix the execution order; run() compiles on first use
+    void compile();
+
+    // Run every task once. Must be called from the main thread. If a task
+    // throws, the tasks after it are skipped and the exception is rethrown
+    // once the run has drained.
+    void run(gl::JobSystem& jobs);
+
+    std::size_t getTaskCount() const { return tasks_.size(); }
+    const std::string& getTaskName(TaskId task) const { return tasks_[task].name; }
+
+    // Timings of the last run, in seconds
+    double getTaskSeconds(TaskId task) const { return tasks_[task].end - tasks_[task].start; }
+    double getRunSeconds() const { return runSeconds_; }
+
+    // Longest chain of dependent tasks in the last run, by task duration.
+    // A frame can't finish faster than this, however many threads it has.
+    std::vector<TaskId> getCriticalPath(double* seconds = nullptr) const;
+
+    // "Input 0.02 ms -> Update 0.10 ms -> ...", with totals
+    std::string describeCriticalPath() const;
+
+private:
+    struct Task {
+        Task(const std::string& name, std::function<void()> fn, Affinity affinity)
+            : name(name), fn(std::move(fn)), affinity(affinity) {}
+
+        std::string name;
+        std::function<void()> fn;
+        Affinity affinity;
+        std::vector<TaskId> dependencies;
+        std::vector<TaskId> dependents;
+        double start = 0.0;
+        double end = 0.0;
+    };
+
+    void schedule(TaskId task, gl::JobSystem& jobs);
+    void execute(TaskId task, gl::JobSystem& jobs);
+    double now() const;
+
+    std::vector<Task> tasks_;
+    std::vector<TaskId> order_; // Topological order, set by compile()
+    bool compiled_ = false;
+
+    // Per-run state
+    std::unique_ptr<std::atomic<std::size_t>[]> remaining_;
+    std::atomic<std::size_t> completed_{ 0 };
+    gl::JobCounter jobCounter_;
+    std::mutex mainMutex_;
+    std::vector<TaskId> mainReady_;
+    std::atomic<bool> failed_{ false };
+    std::exception_ptr failure_;
+    std::int64_t runStart_ = 0;
+    double runSeconds_ = 0.0;
+};
+
+#endif // TASK_GRAPH_HPP
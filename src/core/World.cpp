@@ -0,0 +1,226 @@
+#include "World.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+    std::size_t alignUp(std::size_t value, std::size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool byType(const ComponentInfo* a, const ComponentInfo* b) {
+        return a->id < b->id;
+    }
+
+} // namespace
+
+Archetype::Archetype(std::vector<const ComponentInfo*> components)
+    : components_(std::move(components)) {
+    std::sort(components_.begin(), components_.end(), byType);
+
+    columns_.fill(-1);
+    for (std::size_t column = 0; column < components_.size(); ++column) {
+        const ComponentInfo* component = components_[column];
+        mask_ |= ComponentMask(1) << component->id;
+        columns_[component->id] = static_cast<std::int8_t>(column);
+        if (component->alignment > COLUMN_ALIGNMENT) {
+            throw std::invalid_argument("Component alignment exceeds the chunk column alignment");
+        }
+    }
+
+    // Lay out one column per component plus the entity ids, each starting on
+    // a cache line, and fit as many rows as the chunk size allows
+    auto layout = [this](std::size_t capacity) {
+        std::size_t offset = 0;
+        offsets_.clear();
+        for (const ComponentInfo* component : components_) {
+            offsets_.push_back(offset);
+            offset = alignUp(offset + component->size * capacity, COLUMN_ALIGNMENT);
+        }
+        entityOffset_ = offset;
+        return alignUp(offset + sizeof(EntityId) * capacity, COLUMN_ALIGNMENT);
+    };
+
+    std::size_t rowBytes = sizeof(EntityId);
+    for (const ComponentInfo* component : components_) {
+        rowBytes += component->size;
+    }
+    const std::size_t padding = COLUMN_ALIGNMENT * (components_.size() + 1);
+    chunkCapacity_ = CHUNK_BYTES > padding ? std::max<std::size_t>(1, (CHUNK_BYTES - padding) / rowBytes) : 1;
+    chunkBytes_ = layout(chunkCapacity_);
+}
+
+Archetype::~Archetype() {
+    for (std::size_t row = size_; row-- > 0;) {
+        for (std::size_t column = 0; column < components_.size(); ++column) {
+            components_[column]->destroy(getComponent(row, static_cast<int>(column)));
+        }
+    }
+    for (std::byte* chunk : chunks_) {
+        ::operator delete(chunk, std::align_val_t(COLUMN_ALIGNMENT));
+    }
+}
+
+std::size_t Archetype::getChunkSize(std::size_t chunk) const {
+    const std::size_t first = chunk * chunkCapacity_;
+    return first < size_ ? std::min(chunkCapacity_, size_ - first) : 0;
+}
+
+void* Archetype::getComponent(std::size_t row, int column) const {
+    const std::size_t chunk = row / chunkCapacity_;
+    const std::size_t index = row % chunkCapacity_;
+    return static_cast<std::byte*>(getColumnData(chunk, column)) + index * components_[column]->size;
+}
+
+EntityId Archetype::getEntity(std::size_t row) const {
+    return getEntities(row / chunkCapacity_)[row % chunkCapacity_];
+}
+
+std::size_t Archetype::pushRow(EntityId entity) {
+    if (size_ == chunks_.size() * chunkCapacity_) {
+        chunks_.push_back(static_cast<std::byte*>(::operator new(chunkBytes_, std::align_val_t(COLUMN_ALIGNMENT))));
+    }
+    const std::size_t row = size_++;
+    getEntities(row / chunkCapacity_)[row % chunkCapacity_] = entity;
+    return row;
+}
+
+EntityId Archetype::removeRow(std::size_t row) {
+    const std::size_t last = size_ - 1;
+    EntityId moved = INVALID_ENTITY;
+    for (std::size_t column = 0; column < components_.size(); ++column) {
+        const ComponentInfo& component = *components_[column];
+        void* hole = getComponent(row, static_cast<int>(column));
+        component.destroy(hole);
+        if (row != last) {
+            void* source = getComponent(last, static_cast<int>(column));
+            component.moveConstruct(hole, source);
+            component.destroy(source);
+        }
+    }
+    if (row != last) {
+        moved = getEntity(last);
+        getEntities(row / chunkCapacity_)[row % chunkCapacity_] = moved;
+    }
+    --size_;
+
+    // Keep one empty chunk around so an entity bouncing across a chunk
+    // boundary doesn't allocate every time
+    while (chunks_.size() > 1 && (chunks_.size() - 2) * chunkCapacity_ >= size_) {
+        ::operator delete(chunks_.back(), std::align_val_t(COLUMN_ALIGNMENT));
+        chunks_.pop_back();
+    }
+    return moved;
+}
+
+World::World() {
+    findArchetype({}); // Entities without components
+}
+
+World::~World() = default;
+
+void World::destroy(EntityId entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    const std::uint32_t index = getEntityIndex(entity);
+    Location& location = locations_[index];
+    const EntityId moved = location.archetype->removeRow(location.row);
+    if (moved != INVALID_ENTITY) {
+        locations_[getEntityIndex(moved)].row = location.row;
+    }
+    const std::uint32_t generation = (getEntityGeneration(entity) + 1) & (INVALID_ENTITY >> ENTITY_INDEX_BITS);
+    location = { nullptr, 0, (generation << ENTITY_INDEX_BITS) | index };
+    freeEntities_.push_back(index);
+    --liveCount_;
+}
+
+bool World::isAlive(EntityId entity) const {
+    const std::uint32_t index = getEntityIndex(entity);
+    return index < locations_.size() && locations_[index].archetype != nullptr && locations_[index].id == entity;
+}
+
+EntityId World::allocateEntity() {
+    ++liveCount_;
+    if (!freeEntities_.empty()) {
+        const std::uint32_t index = freeEntities_.back();
+        freeEntities_.pop_back();
+        return locations_[index].id;
+    }
+    if (locations_.size() >= ENTITY_INDEX_MASK) {
+        --liveCount_;
+        throw std::length_error("World is out of entity ids");
+    }
+    const EntityId entity = static_cast<EntityId>(locations_.size());
+    locations_.push_back({ nullptr, 0, entity });
+    return entity;
+}
+
+Archetype* World::findArchetype(std::vector<const ComponentInfo*> components) {
+    ComponentMask key = 0;
+    for (const ComponentInfo* component : components) {
+        const ComponentMask bit = ComponentMask(1) << component->id;
+        if (key & bit) {
+            throw std::invalid_argument("An entity can't have two components of the same type");
+        }
+        key |= bit;
+    }
+
+    auto it = archetypeIndex_.find(key);
+    if (it != archetypeIndex_.end()) {
+        return it->second;
+    }
+    archetypes_.push_back(std::make_unique<Archetype>(std::move(components)));
+    Archetype* archetype = archetypes_.back().get();
+    archetypeIndex_.emplace(key, archetype);
+    return archetype;
+}
+
+Archetype* World::getArchetypeWith(Archetype* from, const ComponentInfo& component) {
+    if (Archetype* cached = from->addEdges[component.id]) {
+        return cached;
+    }
+    std::vector<const ComponentInfo*> components = from->getComponents();
+    components.push_back(&component);
+    Archetype* target = findArchetype(std::move(components));
+    from->addEdges[component.id] = target;
+    target->removeEdges[component.id] = from;
+    return target;
+}
+
+Archetype* World::getArchetypeWithout(Archetype* from, const ComponentInfo& component) {
+    if (Archetype* cached = from->removeEdges[component.id]) {
+        return cached;
+    }
+    std::vector<const ComponentInfo*> components = from->getComponents();
+    components.erase(std::remove(components.begin(), components.end(), &component), components.end());
+    Archetype* target = findArchetype(std::move(components));
+    from->removeEdges[component.id] = target;
+    target->addEdges[component.id] = from;
+    return target;
+}
+
+void World::moveEntity(EntityId entity, Archetype* target) {
+    Location& location = locations_[getEntityIndex(entity)];
+    Archetype* source = location.archetype;
+    const std::size_t sourceRow = location.row;
+    const std::size_t targetRow = target->pushRow(entity);
+
+    const auto& components = source->getComponents();
+    for (std::size_t column = 0; column < components.size(); ++column) {
+        const int targetColumn = target->getColumn(components[column]->id);
+        if (targetColumn >= 0) {
+            components[column]->moveConstruct(target->getComponent(targetRow, targetColumn),
+                source->getComponent(sourceRow, static_cast<int>(column)));
+        }
+    }
+
+    // Destroys the moved-from and dropped components alike
+    const EntityId moved = source->removeRow(sourceRow);
+    if (moved != INVALID_ENTITY) {
+        locations_[getEntityIndex(moved)].row = sourceRow;
+    }
+    location.archetype = target;
+    location.row = targetRow;
+}
@@ -0,0 +1,297 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include "ComponentType.hpp"
+#include "gl/job_system.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// World entity ids pack a slot index with a generation. destroy() bumps the
+// slot's generation, so an id kept past it stops resolving even after the
+// slot is reused (until the generation wraps, 1024 reuses later).
+using EntityId = std::uint32_t;
+constexpr std::uint32_t ENTITY_INDEX_BITS = 22;
+constexpr EntityId ENTITY_INDEX_MASK = (EntityId(1) << ENTITY_INDEX_BITS) - 1;
+constexpr EntityId INVALID_ENTITY = ~EntityId(0);
+
+inline std::uint32_t getEntityIndex(EntityId entity) { return entity & ENTITY_INDEX_MASK; }
+inline std::uint32_t getEntityGeneration(EntityId entity) { return entity >> ENTITY_INDEX_BITS; }
+
+// Size, alignment and lifetime operations of a component type, so archetypes
+// can store and move components without knowing their types
+struct ComponentInfo {
+    ComponentTypeId id;
+    std::size_t size;
+    std::size_t alignment;
+    void (*moveConstruct)(void* destination, void* source);
+    void (*destroy)(void* component);
+};
+
+template<typename T>
+const ComponentInfo& getComponentInfo() {
+    static const ComponentInfo info{
+        getComponentTypeId<T>(),
+        sizeof(T),
+        alignof(T),
+        [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); },
+        [](void* component) { static_cast<T*>(component)->~T(); }
+    };
+    return info;
+}
+
+// All entities with exactly the same set of component types. Components
+// live in fixed-size chunks as one array per type (structure of arrays), so
+// a system touching two components streams through two dense arrays.
+// Rows are kept packed: every chunk but the last is full, and removing a
+// row moves the last row into the hole.
+class Archetype {
+public:
+    static constexpr std::size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr std::size_t COLUMN_ALIGNMENT = 64;
+
+    explicit Archetype(std::vector<const ComponentInfo*> components);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const std::vector<const ComponentInfo*>& getComponents() const { return components_; }
+
+    ComponentMask getMask() const { return mask_; }
+
+    // Column holding a component type, or -1 when the archetype lacks it
+    int getColumn(ComponentTypeId id) const { return columns_[id]; }
+    bool hasComponent(ComponentTypeId id) const { return (mask_ >> id) & 1; }
+
+    std::size_t size() const { return size_; }
+    std::size_t getChunkCount() const { return chunks_.size(); }
+    std::size_t getChunkCapacity() const { return chunkCapacity_; }
+    std::size_t getChunkSize(std::size_t chunk) const;
+
+    void* getColumnData(std::size_t chunk, int column) const { return chunks_[chunk] + offsets_[column]; }
+    EntityId* getEntities(std::size_t chunk) const { return reinterpret_cast<EntityId*>(chunks_[chunk] + entityOffset_); }
+
+    void* getComponent(std::size_t row, int column) const;
+    EntityId getEntity(std::size_t row) const;
+
+    // Append a row for an entity; its components are left for the caller to construct
+    std::size_t pushRow(EntityId entity);
+
+    // Destroy a row's components and fill the hole with the last row.
+    // Returns the entity that moved into the row, or INVALID_ENTITY
+    EntityId removeRow(std::size_t row);
+
+    // Cached transitions to the archetype with one component added or removed
+    std::array<Archetype*, MAX_COMPONENT_TYPES> addEdges = {};
+    std::array<Archetype*, MAX_COMPONENT_TYPES> removeEdges = {};
+
+private:
+    std::vector<const ComponentInfo*> components_;
+    ComponentMask mask_ = 0;
+    std::array<std::int8_t, MAX_COMPONENT_TYPES> columns_;
+    std::vector<std::size_t> offsets_;
+    std::size_t entityOffset_ = 0;
+    std::size_t chunkBytes_ = 0;
+    std::size_t chunkCapacity_ = 0;
+    std::size_t size_ = 0;
+    std::vector<std::byte*> chunks_;
+};
+
+// Archetype storage for large numbers of plain-data entities. Unlike
+// Entity, which owns polymorphic components and updates them one virtual
+// call at a time, a World keeps every component type packed per archetype
+// and lets systems run over the arrays directly:
+//
+//     world.each<Position, const Velocity>([dt](Position& p, const Velocity& v) {
+//         p.value += v.value * dt;
+//     });
+//
+// Components must be movable. Creating, destroying, adding or removing
+// components moves rows around, so don't change the world from inside
+// each() or eachChunk().
+class World {
+public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    template<typename... Ts>
+    EntityId create(Ts... components) {
+        // Known component sets resolve with one mask lookup; duplicate
+        // types fall through so findArchetype can reject them
+        const ComponentMask mask = (ComponentMask(0) | ... | getComponentMask<Ts>());
+        auto known = archetypeIndex_.find(mask);
+        Archetype* archetype = known != archetypeIndex_.end() && std::popcount(mask) == static_cast<int>(sizeof...(Ts))
+            ? known->second
+            : findArchetype({ &getComponentInfo<Ts>()... });
+        const EntityId entity = allocateEntity();
+        const std::size_t row = archetype->pushRow(entity);
+        (construct<Ts>(archetype, row, std::move(components)), ...);
+        Location& location = locations_[getEntityIndex(entity)];
+        location.archetype = archetype;
+        location.row = row;
+        return entity;
+    }
+
+    void destroy(EntityId entity);
+    bool isAlive(EntityId entity) const;
+
+    template<typename T>
+    T* get(EntityId entity) const {
+        if (!isAlive(entity)) {
+            return nullptr;
+        }
+        const Location& location = locations_[getEntityIndex(entity)];
+        const int column = location.archetype->getColumn(getComponentTypeId<T>());
+        return column >= 0 ? static_cast<T*>(location.archetype->getComponent(location.row, column)) : nullptr;
+    }
+
+    template<typename T>
+    bool has(EntityId entity) const {
+        return isAlive(entity) && locations_[getEntityIndex(entity)].archetype->hasComponent(getComponentTypeId<T>());
+    }
+
+    // Add a component, or replace it when the entity already has one
+    template<typename T>
+    T* add(EntityId entity, T component) {
+        if (T* existing = get<T>(entity)) {
+            *existing = std::move(component);
+            return existing;
+        }
+        if (!isAlive(entity)) {
+            return nullptr;
+        }
+        Archetype* target = getArchetypeWith(locations_[getEntityIndex(entity)].archetype, getComponentInfo<T>());
+        moveEntity(entity, target);
+        const Location& location = locations_[getEntityIndex(entity)];
+        return construct<T>(location.archetype, location.row, std::move(component));
+    }
+
+    template<typename T>
+    void remove(EntityId entity) {
+        if (!has<T>(entity)) {
+            return;
+        }
+        moveEntity(entity, getArchetypeWithout(locations_[getEntityIndex(entity)].archetype, getComponentInfo<T>()));
+    }
+
+    // Call fn(Ts&...) or fn(EntityId, Ts&...) for every entity that has all of Ts
+    template<typename... Ts, typename F>
+    void each(F&& fn) {
+        eachChunk<Ts...>([&fn](std::size_t count, const EntityId* entities, Ts*... components) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if constexpr (std::is_invocable_v<F&, EntityId, Ts&...>) {
+                    fn(entities[i], components[i]...);
+                }
+                else {
+                    fn(components[i]...);
+                }
+            }
+        });
+    }
+
+    // Call fn(count, entities, Ts*...) once per chunk, for loops that want
+    // the raw arrays (vectorization, prefetching, splitting across threads)
+    template<typename... Ts, typename F>
+    void eachChunk(F&& fn) {
+        const ComponentMask query = (ComponentMask(0) | ... | getComponentMask<std::remove_const_t<Ts>>());
+        for (const auto& archetype : archetypes_) {
+            if (archetype->size() == 0) {
+                continue;
+            }
+            if ((archetype->getMask() & query) != query) {
+                continue;
+            }
+            const int columns[] = { archetype->getColumn(getComponentTypeId<std::remove_const_t<Ts>>())..., 0 };
+            const std::size_t chunks = (archetype->size() + archetype->getChunkCapacity() - 1) / archetype->getChunkCapacity();
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                callChunk<Ts...>(fn, *archetype, chunk, columns, std::index_sequence_for<Ts...>());
+            }
+        }
+    }
+
+    // eachChunk with the chunks spread over a job system. fn runs
+    // concurrently on different chunks, so it may only write to the chunk
+    // it was given.
+    template<typename... Ts, typename F>
+    void parallelEachChunk(gl::JobSystem& jobs, F&& fn) {
+        struct ChunkRef {
+            const Archetype* archetype;
+            std::size_t chunk;
+            std::array<int, sizeof...(Ts) + 1> columns;
+        };
+
+        const ComponentMask query = (ComponentMask(0) | ... | getComponentMask<std::remove_const_t<Ts>>());
+        std::vector<ChunkRef> chunks;
+        for (const auto& archetype : archetypes_) {
+            if (archetype->size() == 0 || (archetype->getMask() & query) != query) {
+                continue;
+            }
+            const std::array<int, sizeof...(Ts) + 1> columns = { archetype->getColumn(getComponentTypeId<std::remove_const_t<Ts>>())..., 0 };
+            const std::size_t count = (archetype->size() + archetype->getChunkCapacity() - 1) / archetype->getChunkCapacity();
+            for (std::size_t chunk = 0; chunk < count; ++chunk) {
+                chunks.push_back({ archetype.get(), chunk, columns });
+            }
+        }
+
+        jobs.parallelFor(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const ChunkRef& ref = chunks[i];
+                callChunk<Ts...>(fn, *ref.archetype, ref.chunk, ref.columns.data(), std::index_sequence_for<Ts...>());
+            }
+        });
+    }
+
+    // Live entities
+    std::size_t size() const { return liveCount_; }
+    std::size_t getArchetypeCount() const { return archetypes_.size(); }
+
+private:
+    struct Location {
+        Archetype* archetype = nullptr; // Null while the slot is free
+        std::size_t row = 0;
+        EntityId id = 0; // Current id of the slot, or the next one while free
+    };
+
+    template<typename T>
+    T* construct(Archetype* archetype, std::size_t row, T&& component) {
+        void* slot = archetype->getComponent(row, archetype->getColumn(getComponentTypeId<T>()));
+        return new (slot) T(std::move(component));
+    }
+
+    template<typename... Ts, typename F, std::size_t... Is>
+    static void callChunk(F& fn, const Archetype& archetype, std::size_t chunk, const int* columns, std::index_sequence<Is...>) {
+        fn(archetype.getChunkSize(chunk), archetype.getEntities(chunk),
+            static_cast<Ts*>(archetype.getColumnData(chunk, columns[Is]))...);
+    }
+
+    EntityId allocateEntity();
+
+    // Archetype for an unordered set of component types, created on first use
+    Archetype* findArchetype(std::vector<const ComponentInfo*> components);
+    Archetype* getArchetypeWith(Archetype* from, const ComponentInfo& component);
+    Archetype* getArchetypeWithout(Archetype* from, const ComponentInfo& component);
+
+    // Move an entity's shared components to another archetype and drop the
+    // rest; components only the target has are left unconstructed
+    void moveEntity(EntityId entity, Archetype* target);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<ComponentMask, Archetype*> archetypeIndex_;
+
+    std::vector<Location> locations_; // Indexed by entity index
+    std::vector<std::uint32_t> freeEntities_;
+    std::size_t liveCount_ = 0;
+};
+
+#endif // WORLD_HPP
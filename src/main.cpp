@@ -1,8 +1,10 @@
 ﻿#include "window/Window.hpp"
 #include "core/Scene.hpp"
+#include "core/TaskGraph.hpp"
 #include "managers/ResourceManager.hpp"
 #include "profiling/Profiler.hpp"
 #include "gl/logger.hpp"
+#include "gl/job_system.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -133,8 +135,14 @@ int main() {
         window.captureCursor();
         gl::logDebug("Cursor captured");
 
+        // Job system for parallel scene updates: one worker per extra core,
+        // and the main thread joins in while it waits
+        gl::JobSystem jobSystem;
+        gl::logInfo("Job system: " + std::to_string(jobSystem.getConcurrency()) + " threads");
+
         // Create and initialize scene
         Scene scene(window, resourceManager);
+        scene.setJobSystem(&jobSystem);
         scene.init();
         gl::logInfo("Scene initialized");
 
@@ -142,6 +150,30 @@ int main() {
         Profiler profiler;
         gl::logDebug("Profiler created");
 
+        // The frame as a task graph, built once. Input, entity updates, GL
+        // submission and the swap stay on this thread; after animation the
+        // homography solve runs alongside culling and draw recording. It
+        // only hands the solve to the effect's worker, and Submit draws the
+        // newest finished decals, so Submit doesn't wait on it.
+        float deltaTime = 0.0f;
+        TaskGraph frameGraph;
+        using Affinity = TaskGraph::Affinity;
+        const auto inputTask = frameGraph.addTask("Input", [&] { window.pollEvents(); }, Affinity::MainThread);
+        const auto updateTask = frameGraph.addTask("Update", [&] { scene.updateEntities(deltaTime); },
+            Affinity::MainThread, { inputTask });
+        const auto animationTask = frameGraph.addTask("Animation", [&] { scene.animate(deltaTime); },
+            Affinity::AnyThread, { updateTask });
+        frameGraph.addTask("HomographySolve", [&] { scene.solveHomographies(); },
+            Affinity::AnyThread, { animationTask });
+        const auto cullTask = frameGraph.addTask("Culling", [&] { scene.cull(); },
+            Affinity::AnyThread, { animationTask });
+        const auto recordTask = frameGraph.addTask("RecordDraws", [&] { scene.recordDraws(); },
+            Affinity::AnyThread, { cullTask });
+        const auto submitTask = frameGraph.addTask("Submit", [&] { scene.submit(); },
+            Affinity::MainThread, { recordTask });
+        frameGraph.addTask("SwapBuffers", [&] { window.swapBuffers(); }, Affinity::MainThread, { submitTask });
+        frameGraph.compile();
+
         // Timing variables
         float lastFrame = 0.0f;
         float lastFPSUpdate = 0.0f;
@@ -157,7 +189,7 @@ int main() {
 
             // Calculate delta time
             float currentTime = static_cast<float>(glfwGetTime());
-            float deltaTime = currentTime - lastFrame;
+            deltaTime = currentTime - lastFrame;
             lastFrame = currentTime;
 
             // Calculate FPS
@@ -173,27 +205,11 @@ int main() {
                 gl::logDebug("FPS: " + std::to_string(static_cast<int>(fps)));
             }
 
-            // Process input
-            profiler.beginSection("Input");
-            window.pollEvents();
-            profiler.endSection("Input");
-
-            // Update scene
-            profiler.beginSection("Update");
-            scene.update(deltaTime);
-            profiler.endSection("Update");
-
-            // Render scene
-            profiler.beginSection("Render");
-            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            scene.render();
-            profiler.endSection("Render");
-
-            // Swap buffers
-            profiler.beginSection("SwapBuffers");
-            window.swapBuffers();
-            profiler.endSection("SwapBuffers");
+            // Input, update, render and swap
+            frameGraph.run(jobSystem);
+            for (TaskGraph::TaskId task = 0; task < frameGraph.getTaskCount(); ++task) {
+                profiler.addSectionTime(frameGraph.getTaskName(task), frameGraph.getTaskSeconds(task));
+            }
 
             // End frame profiling
             profiler.endFrame();
@@ -201,6 +217,7 @@ int main() {
             // Print profiler stats periodically
             if (currentTime - lastProfilerUpdate >= 5.0f) {
                 profiler.printStats();
+                gl::logInfo("Frame graph: " + frameGraph.describeCriticalPath());
                 lastProfilerUpdate = currentTime;
             }
 
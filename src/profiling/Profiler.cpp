@@ -38,15 +38,17 @@ void Profiler::endSection(const std::string& name)
 {
     auto it = sectionStartTimes_.find(name);
     if (it != sectionStartTimes_.end()) {
-        double sectionTime = glfwGetTime() - it->second;
-        if (sectionTimes_.find(name) == sectionTimes_.end()) {
-            sectionTimes_[name] = std::deque<double>();
-        }
-        sectionTimes_[name].push_back(sectionTime);
-        // Keep a rolling average
-        if (sectionTimes_[name].size() > 100) {
-            sectionTimes_[name].pop_front();
-        }
+        addSectionTime(name, glfwGetTime() - it->second);
+    }
+}
+
+void Profiler::addSectionTime(const std::string& name, double seconds)
+{
+    std::deque<double>& times = sectionTimes_[name];
+    times.push_back(seconds);
+    // Keep a rolling average
+    if (times.size() > 100) {
+        times.pop_front();
     }
 }
 
@@ -18,6 +18,9 @@ public:
     void beginSection(const std::string& name);
     void endSection(const std::string& name);
 
+    // Record a section timed elsewhere, e.g. a task run on another thread
+    void addSectionTime(const std::string& name, double seconds);
+
     // Reporting
     void printStats() const;
 
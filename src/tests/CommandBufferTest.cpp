@@ -0,0 +1,199 @@
+#include "Test.hpp"
+#include "../core/CommandBuffer.hpp"
+#include "../core/World.hpp"
+
+#include <array>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Value {
+        int value = 0;
+    };
+
+    struct Spawned {
+        int value = 0;
+    };
+
+    // Forces padding between a small header-aligned command and the next
+    struct alignas(64) Aligned {
+        int value = 0;
+    };
+
+    // Bigger than a command block, so it gets a block of its own
+    struct Big {
+        std::array<int, 8192> values = {};
+    };
+
+    // Replacing it with a failing one throws
+    struct Thrower {
+        bool fail = false;
+        Thrower() = default;
+        explicit Thrower(bool fail) : fail(fail) {}
+        Thrower(Thrower&&) noexcept = default;
+        Thrower& operator=(Thrower&& other) {
+            if (other.fail) {
+                throw std::runtime_error("Thrower");
+            }
+            fail = other.fail;
+            return *this;
+        }
+    };
+
+    // Live instances, to see that dropped payloads are destroyed
+    struct Counted {
+        static inline int live = 0;
+        Counted() { ++live; }
+        Counted(Counted&&) noexcept { ++live; }
+        Counted& operator=(Counted&&) noexcept = default;
+        ~Counted() { --live; }
+    };
+
+    // Several threads record into their own lanes at once; apply replays
+    // each lane in order, over as many blocks as it took
+    void testParallelRecording() {
+        constexpr int COUNT = 3000;
+        World world;
+        std::vector<EntityId> entities;
+        for (int i = 0; i < COUNT; ++i) {
+            entities.push_back(world.create(Value{ -1 }));
+        }
+
+        // One slice per thread; the latch keeps any thread from taking two,
+        // so every thread records into a lane of its own
+        constexpr int THREADS = 4;
+        gl::JobSystem jobs(THREADS - 1);
+        std::latch started(THREADS);
+        CommandBuffer commands;
+        jobs.parallelFor(THREADS, [&](std::size_t slice) {
+            started.arrive_and_wait();
+            for (int i = static_cast<int>(slice); i < COUNT; i += THREADS) {
+                commands.add(entities[i], Value{ i });
+                if (i % 3 == 0) {
+                    commands.destroy(entities[i]); // After the add, in the same lane
+                }
+                commands.create(Spawned{ i }, Aligned{ i });
+            }
+        });
+        test::check(commands.size() == COUNT * 2 + COUNT / 3, "every recorded command counted");
+
+        commands.apply(world);
+        test::check(commands.empty(), "buffer empty after apply");
+
+        int wrong = 0;
+        for (int i = 0; i < COUNT; ++i) {
+            const Value* value = world.get<Value>(entities[i]);
+            wrong += i % 3 == 0 ? world.isAlive(entities[i]) : (!value || value->value != i);
+        }
+        test::check(wrong == 0, "adds and destroys applied in recording order (" + std::to_string(wrong) + " wrong)");
+
+        std::vector<int> seen(COUNT, 0);
+        world.each<const Spawned, const Aligned>([&](const Spawned& spawned, const Aligned& aligned) {
+            if (spawned.value >= 0 && spawned.value < COUNT && aligned.value == spawned.value) {
+                ++seen[spawned.value];
+            }
+        });
+        int missing = 0;
+        for (int count : seen) {
+            missing += count != 1;
+        }
+        test::check(missing == 0, "every padded create applied once (" + std::to_string(missing) + " wrong)");
+        test::check(world.size() == COUNT - COUNT / 3 + COUNT, "world size after apply");
+    }
+
+    // Payloads larger than a block, between ordinary commands and again
+    // once the blocks are warm
+    void testOversizedPayload() {
+        World world;
+        const EntityId entity = world.create(Value{ 0 });
+        CommandBuffer commands;
+        for (int round = 0; round < 2; ++round) {
+            Big big;
+            for (std::size_t i = 0; i < big.values.size(); ++i) {
+                big.values[i] = static_cast<int>(i) + round;
+            }
+            commands.add(entity, Value{ 1 + round });
+            commands.add(entity, big);
+            commands.create(Value{ 10 + round });
+            commands.apply(world);
+
+            const Big* stored = world.get<Big>(entity);
+            bool intact = stored != nullptr;
+            for (std::size_t i = 0; intact && i < big.values.size(); ++i) {
+                intact = stored->values[i] == static_cast<int>(i) + round;
+            }
+            test::check(intact, "oversized payload applied intact, round " + std::to_string(round));
+            test::check(world.get<Value>(entity)->value == 1 + round, "command before it applied, round " + std::to_string(round));
+            test::check(world.size() == static_cast<std::size_t>(2 + round), "command after it applied, round " + std::to_string(round));
+        }
+    }
+
+    // Commands on entities gone by apply time do nothing, even when the
+    // slot has been reused
+    void testDeadEntity() {
+        World world;
+        const EntityId dead = world.create(Value{ 1 });
+        CommandBuffer commands;
+        commands.add(dead, Value{ 2 });
+        commands.add(dead, Spawned{ 2 });
+        commands.remove<Value>(dead);
+        commands.destroy(dead);
+
+        world.destroy(dead);
+        const EntityId reused = world.create(Value{ 3 });
+        commands.apply(world);
+
+        test::check(getEntityIndex(reused) == getEntityIndex(dead), "slot reused");
+        test::check(world.size() == 1 && world.get<Value>(reused) && world.get<Value>(reused)->value == 3,
+            "entity in the reused slot untouched");
+        test::check(!world.has<Spawned>(reused), "no component added through the stale id");
+    }
+
+    // A throwing command drops the rest, leaves the buffer empty and usable,
+    // and the exception reaches the caller
+    void testThrowingCommand() {
+        World world;
+        const EntityId first = world.create(Value{ 0 });
+        const EntityId thrower = world.create(Thrower{});
+        const EntityId last = world.create(Value{ 0 });
+
+        {
+            CommandBuffer commands;
+            commands.add(first, Value{ 1 });
+            commands.add(thrower, Thrower(true));
+            commands.add(last, Value{ 1 });
+            commands.create(Counted{});
+            commands.create(Counted{});
+
+            bool threw = false;
+            try {
+                commands.apply(world);
+            }
+            catch (const std::runtime_error&) {
+                threw = true;
+            }
+            test::check(threw, "exception rethrown from apply");
+            test::check(commands.empty(), "buffer empty after a throwing command");
+            test::check(world.get<Value>(first)->value == 1, "command before the throw applied");
+            test::check(world.get<Value>(last)->value == 0, "command after the throw dropped");
+            test::check(Counted::live == 0, "dropped payloads destroyed");
+
+            commands.add(last, Value{ 2 });
+            commands.apply(world);
+            test::check(world.get<Value>(last)->value == 2, "buffer usable after a throw");
+        }
+        test::check(Counted::live == 0, "no payloads left behind");
+    }
+
+} // namespace
+
+void runCommandBufferTests() {
+    test::printHeader("commands");
+    testParallelRecording();
+    testOversizedPayload();
+    testDeadEntity();
+    testThrowingCommand();
+}
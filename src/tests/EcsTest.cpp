@@ -0,0 +1,233 @@
+#include "Test.hpp"
+#include "../core/World.hpp"
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Big enough that a chunk holds only a few dozen, so a few hundred
+    // entities span several chunks
+    struct Payload {
+        int id = 0;
+        std::array<int, 63> padding = {};
+    };
+
+    struct Tag {
+        int id = 0;
+    };
+
+    // Live instances, to see that moves and destroys balance
+    struct Counted {
+        static inline int live = 0;
+        int id = 0;
+        explicit Counted(int id) : id(id) { ++live; }
+        Counted(Counted&& other) noexcept : id(other.id) { ++live; }
+        Counted& operator=(Counted&&) noexcept = default;
+        ~Counted() { --live; }
+    };
+
+    std::size_t getPayloadChunkCapacity() {
+        return Archetype({ &getComponentInfo<Payload>() }).getChunkCapacity();
+    }
+
+    // Every entity still finds its own components, wherever swap-removes
+    // have moved it
+    bool ownDataIntact(World& world, const std::vector<EntityId>& entities) {
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            const Payload* payload = world.get<Payload>(entities[i]);
+            if (!payload || payload->id != static_cast<int>(i) || payload->padding.back() != static_cast<int>(i)) {
+                return false;
+            }
+            const Tag* tag = world.get<Tag>(entities[i]);
+            if (tag && tag->id != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Adding and removing a component moves entities between archetypes;
+    // each move swap-removes from the source, across chunk boundaries
+    void testAddRemoveAcrossChunks() {
+        const std::size_t capacity = getPayloadChunkCapacity();
+        const int count = static_cast<int>(capacity * 3 + capacity / 2);
+
+        World world;
+        std::vector<EntityId> entities;
+        for (int i = 0; i < count; ++i) {
+            Payload payload{ i };
+            payload.padding.back() = i;
+            entities.push_back(world.create(payload, Counted{ i }));
+        }
+
+        // Every third from the front, then the back half from the back,
+        // so holes open in the middle of full and partial chunks alike
+        for (int i = 0; i < count; i += 3) {
+            world.add(entities[i], Tag{ i });
+        }
+        for (int i = count - 1; i >= count / 2; --i) {
+            world.add(entities[i], Tag{ i });
+        }
+        test::check(ownDataIntact(world, entities), "own data after adds");
+
+        int tagged = 0;
+        world.each<Payload, Tag>([&](Payload& payload, Tag& tag) {
+            tagged += payload.id == tag.id;
+        });
+        int expected = 0;
+        for (int i = 0; i < count; ++i) {
+            expected += i % 3 == 0 || i >= count / 2;
+        }
+        test::check(tagged == expected, "each visits every tagged entity once");
+
+        for (int i = 0; i < count; i += 2) {
+            world.remove<Tag>(entities[i]);
+        }
+        world.remove<Counted>(entities[1]);
+        test::check(ownDataIntact(world, entities), "own data after removes");
+        test::check(!world.has<Tag>(entities[0]) && world.has<Tag>(entities[3]), "has after removes");
+        test::check(!world.has<Counted>(entities[1]) && world.get<Counted>(entities[2])->id == 2, "removed component dropped");
+        test::check(Counted::live == count - 1, "no component leaked or lost in moves");
+        test::check(world.size() == static_cast<std::size_t>(count), "entity count unchanged by moves");
+    }
+
+    // Destroying from the middle of a chunk moves the archetype's last
+    // entity into the hole; both it and its id must follow
+    void testDestroyFromMiddle() {
+        const std::size_t capacity = getPayloadChunkCapacity();
+        const int count = static_cast<int>(capacity * 3);
+
+        World world;
+        std::vector<EntityId> entities;
+        for (int i = 0; i < count; ++i) {
+            Payload payload{ i };
+            payload.padding.back() = i;
+            entities.push_back(world.create(payload));
+        }
+
+        const int middle = static_cast<int>(capacity + capacity / 2);
+        const Payload* hole = world.get<Payload>(entities[middle]);
+        world.destroy(entities[middle]);
+        test::check(!world.isAlive(entities[middle]) && !world.get<Payload>(entities[middle]), "destroyed entity stops resolving");
+        const Payload* moved = world.get<Payload>(entities[count - 1]);
+        test::check(moved == hole && moved->id == count - 1 && moved->padding.back() == count - 1, "moved entity's get returns its own data");
+
+        std::vector<EntityId> survivors;
+        std::vector<int> survivorIds;
+        for (int i = 0; i < count; ++i) {
+            if (i == middle) continue;
+            if (i % 5 == 2) {
+                world.destroy(entities[i]);
+            }
+            else {
+                survivors.push_back(entities[i]);
+                survivorIds.push_back(i);
+            }
+        }
+
+        bool intact = true;
+        for (std::size_t i = 0; i < survivors.size(); ++i) {
+            const Payload* payload = world.get<Payload>(survivors[i]);
+            intact = intact && payload && payload->id == survivorIds[i] && payload->padding.back() == survivorIds[i];
+        }
+        test::check(intact, "survivors keep their own data");
+        test::check(world.size() == survivors.size(), "live count after destroys");
+
+        std::size_t visited = 0;
+        bool idsMatch = true;
+        world.each<Payload>([&](EntityId entity, Payload& payload) {
+            ++visited;
+            idsMatch = idsMatch && world.get<Payload>(entity) == &payload;
+        });
+        test::check(visited == survivors.size() && idsMatch, "each hands out ids matching the rows");
+    }
+
+    // removeRow swap-removes, reports the row it moved, and frees chunks
+    // as rows go, keeping one empty chunk as slack
+    void testChunkRelease() {
+        Archetype archetype({ &getComponentInfo<Payload>() });
+        const std::size_t capacity = archetype.getChunkCapacity();
+        const std::size_t count = capacity * 3 + 1;
+        for (std::size_t row = 0; row < count; ++row) {
+            archetype.pushRow(static_cast<EntityId>(row));
+            new (archetype.getComponent(row, 0)) Payload{ static_cast<int>(row) };
+        }
+        test::check(archetype.getChunkCount() == 4, "chunks allocated as rows are pushed");
+
+        test::check(archetype.removeRow(count - 1) == INVALID_ENTITY, "removing the last row moves nothing");
+        test::check(archetype.getChunkCount() == 4, "one empty chunk kept");
+
+        const EntityId moved = archetype.removeRow(capacity / 2);
+        test::check(moved == static_cast<EntityId>(count - 2), "removeRow reports the moved entity");
+        test::check(archetype.getEntity(capacity / 2) == moved
+            && static_cast<Payload*>(archetype.getComponent(capacity / 2, 0))->id == static_cast<int>(count - 2),
+            "moved row takes the hole");
+        test::check(archetype.getChunkCount() == 4, "partly full chunk kept");
+
+        while (archetype.size() > capacity * 2) {
+            archetype.removeRow(0);
+        }
+        test::check(archetype.getChunkCount() == 3, "second empty chunk released");
+
+        while (archetype.size() > 0) {
+            archetype.removeRow(0);
+        }
+        test::check(archetype.getChunkCount() == 1, "emptied archetype keeps a single chunk");
+
+        archetype.pushRow(0);
+        new (archetype.getComponent(0, 0)) Payload{ 7 };
+        test::check(archetype.getChunkCount() == 1 && archetype.getChunkSize(0) == 1, "kept chunk reused");
+    }
+
+    // A destroyed entity's id stops resolving, even once its slot is reused
+    void testStaleIds() {
+        World world;
+        const EntityId stale = world.create(Tag{ 1 });
+        world.destroy(stale);
+        const EntityId reused = world.create(Tag{ 2 });
+
+        test::check(getEntityIndex(reused) == getEntityIndex(stale) && reused != stale, "slot reused with a new generation");
+        test::check(!world.isAlive(stale) && !world.get<Tag>(stale) && !world.has<Tag>(stale), "stale id doesn't resolve");
+        test::check(!world.add(stale, Payload{}), "add through a stale id refused");
+
+        world.remove<Tag>(stale);
+        world.destroy(stale);
+        test::check(world.isAlive(reused) && world.get<Tag>(reused)->id == 2, "stale id can't touch the slot's new entity");
+        test::check(world.size() == 1, "live count untouched by stale ids");
+    }
+
+    // As documented, the generation wraps after 1024 reuses of a slot and
+    // the original id resolves again
+    void testGenerationWrap() {
+        constexpr int GENERATIONS = 1 << (32 - ENTITY_INDEX_BITS);
+        World world;
+        const EntityId first = world.create(Tag{ 0 });
+        EntityId current = first;
+        bool distinct = true;
+        for (int reuse = 1; reuse < GENERATIONS; ++reuse) {
+            world.destroy(current);
+            current = world.create(Tag{ reuse });
+            distinct = distinct && current != first && !world.isAlive(first);
+        }
+        test::check(distinct, "ids distinct until the generation wraps");
+
+        world.destroy(current);
+        current = world.create(Tag{ GENERATIONS });
+        test::check(current == first && world.isAlive(first), "generation wraps after 1024 reuses");
+    }
+
+} // namespace
+
+void runEcsTests() {
+    test::printHeader("ecs");
+    testAddRemoveAcrossChunks();
+    test::check(Counted::live == 0, "components destroyed with the world");
+    testDestroyFromMiddle();
+    testChunkRelease();
+    testStaleIds();
+    testGenerationWrap();
+}
@@ -0,0 +1,195 @@
+#include "Test.hpp"
+#include "gl/job_system.hpp"
+#include "../core/TaskGraph.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr std::size_t WORKERS = 3;
+
+    // Runs fn and reports whether it threw a std::runtime_error
+    template<typename F>
+    bool throwsRuntimeError(F&& fn) {
+        try {
+            fn();
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    // parallelFor from inside parallelFor, both flavours; the waits run
+    // other jobs, so this finishes however few threads there are
+    void testNestedParallelFor() {
+        gl::JobSystem jobs(WORKERS);
+        constexpr std::size_t OUTER = 16;
+        constexpr std::size_t INNER = 1000;
+        std::vector<std::size_t> sums(OUTER, 0);
+        jobs.parallelFor(OUTER, [&](std::size_t i) {
+            std::atomic<std::size_t> sum{ 0 };
+            jobs.parallelFor(INNER, 10, [&](std::size_t begin, std::size_t end) {
+                std::size_t local = 0;
+                for (std::size_t j = begin; j < end; ++j) {
+                    local += j;
+                }
+                sum += local;
+            });
+            sums[i] = sum;
+        });
+
+        bool correct = true;
+        for (std::size_t sum : sums) {
+            correct = correct && sum == INNER * (INNER - 1) / 2;
+        }
+        test::check(correct, "nested parallelFor sums");
+    }
+
+    // Two calls held on different threads by a latch, so the one that
+    // throws is on a worker or on the caller as chosen
+    void testParallelForThrows(bool onCaller) {
+        gl::JobSystem jobs(WORKERS);
+        const std::thread::id caller = std::this_thread::get_id();
+        std::latch bothStarted(2);
+        std::atomic<int> finished{ 0 };
+        const bool threw = throwsRuntimeError([&] {
+            jobs.parallelFor(2, [&](std::size_t) {
+                bothStarted.arrive_and_wait();
+                if ((std::this_thread::get_id() == caller) == onCaller) {
+                    throw std::runtime_error("parallelFor");
+                }
+                // Still running after the other call threw
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++finished;
+            });
+        });
+        const std::string where = onCaller ? " on the caller" : " on a worker";
+        test::check(threw, "exception rethrown from parallelFor" + where);
+        test::check(finished == 1, "parallelFor waited for the other call" + where);
+
+        std::atomic<std::size_t> calls{ 0 };
+        jobs.parallelFor(100, [&](std::size_t) { ++calls; });
+        test::check(calls == 100, "job system usable after a throw" + where);
+    }
+
+    void testRangedParallelForThrows() {
+        gl::JobSystem jobs(WORKERS);
+        const bool threw = throwsRuntimeError([&] {
+            jobs.parallelFor(1000, 1, [&](std::size_t begin, std::size_t end) {
+                if (begin <= 500 && 500 < end) {
+                    throw std::runtime_error("parallelFor");
+                }
+            });
+        });
+        test::check(threw, "exception rethrown from ranged parallelFor");
+    }
+
+    void testSubmit() {
+        gl::JobSystem jobs(WORKERS);
+        std::future<int> value = jobs.submit([] { return 42; });
+        std::future<void> failure = jobs.submit([] { throw std::runtime_error("submit"); });
+        test::check(value.get() == 42, "submit returns the result");
+        test::check(throwsRuntimeError([&] { failure.get(); }), "submit carries the exception");
+    }
+
+    void testTaskGraphCycles() {
+        TaskGraph graph;
+        const auto a = graph.addTask("A", [] {});
+        const auto b = graph.addTask("B", [] {}, TaskGraph::Affinity::AnyThread, { a });
+        const auto c = graph.addTask("C", [] {}, TaskGraph::Affinity::AnyThread, { b });
+        graph.compile();
+        graph.addDependency(a, c);
+
+        bool cycle = false;
+        try {
+            graph.compile();
+        }
+        catch (const std::logic_error&) {
+            cycle = true;
+        }
+        test::check(cycle, "dependency cycle rejected");
+
+        bool self = false;
+        try {
+            graph.addDependency(b, b);
+        }
+        catch (const std::invalid_argument&) {
+            self = true;
+        }
+        test::check(self, "self-dependency rejected");
+    }
+
+    // Tasks run after their dependencies, main-thread ones on the caller
+    void testTaskGraphOrder() {
+        gl::JobSystem jobs(WORKERS);
+        const std::thread::id caller = std::this_thread::get_id();
+        std::atomic<int> step{ 0 };
+        int input = -1, left = -1, right = -1, submit = -1;
+        bool submitOnCaller = false;
+
+        TaskGraph graph;
+        const auto inputTask = graph.addTask("Input", [&] { input = step++; }, TaskGraph::Affinity::MainThread);
+        const auto leftTask = graph.addTask("Left", [&] { left = step++; }, TaskGraph::Affinity::AnyThread, { inputTask });
+        const auto rightTask = graph.addTask("Right", [&] { right = step++; }, TaskGraph::Affinity::AnyThread, { inputTask });
+        graph.addTask("Submit", [&] {
+            submit = step++;
+            submitOnCaller = std::this_thread::get_id() == caller;
+        }, TaskGraph::Affinity::MainThread, { leftTask, rightTask });
+
+        for (int run = 0; run < 20; ++run) {
+            step = 0;
+            graph.run(jobs);
+            test::check(input == 0 && left > 0 && right > 0 && submit == 3, "tasks after their dependencies, run " + std::to_string(run));
+            test::check(submitOnCaller, "main-thread task on the caller, run " + std::to_string(run));
+        }
+    }
+
+    // A parallelFor throwing on a worker inside a task, as a system's
+    // would: the run rethrows, dependents are skipped, the next run is clean
+    void testTaskGraphException() {
+        gl::JobSystem jobs(WORKERS);
+        bool fail = true;
+        bool dependentRan = false;
+
+        TaskGraph graph;
+        const auto systemTask = graph.addTask("System", [&] {
+            const std::thread::id taskThread = std::this_thread::get_id();
+            std::latch bothStarted(2);
+            jobs.parallelFor(2, [&](std::size_t) {
+                bothStarted.arrive_and_wait();
+                if (fail && std::this_thread::get_id() != taskThread) {
+                    throw std::runtime_error("system");
+                }
+            });
+        });
+        graph.addTask("Dependent", [&] { dependentRan = true; }, TaskGraph::Affinity::MainThread, { systemTask });
+
+        test::check(throwsRuntimeError([&] { graph.run(jobs); }), "task exception rethrown from run");
+        test::check(!dependentRan, "dependent of the failed task skipped");
+
+        fail = false;
+        graph.run(jobs);
+        test::check(dependentRan, "next run completes");
+    }
+
+} // namespace
+
+void runJobSystemTests() {
+    test::printHeader("jobs");
+    testNestedParallelFor();
+    testParallelForThrows(false);
+    testParallelForThrows(true);
+    testRangedParallelForThrows();
+    testSubmit();
+    testTaskGraphCycles();
+    testTaskGraphOrder();
+    testTaskGraphException();
+}
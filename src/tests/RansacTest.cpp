@@ -0,0 +1,94 @@
+#include "Test.hpp"
+#include "gl/ransac.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Row-major, as homographies are written on paper
+    glm::mat3 fromRows(const float (&m)[3][3]) {
+        return glm::transpose(glm::mat3(m[0][0], m[0][1], m[0][2],
+            m[1][0], m[1][1], m[1][2], m[2][0], m[2][1], m[2][2]));
+    }
+
+    glm::vec2 project(const glm::mat3& H, glm::vec2 p) {
+        const glm::vec3 q = H * glm::vec3(p, 1.0f);
+        return glm::vec2(q) / q.z;
+    }
+
+    float maxReprojectionError(const glm::mat3& H, const std::vector<glm::vec2>& src,
+        const std::vector<glm::vec2>& dst) {
+        float worst = 0.0f;
+        for (size_t i = 0; i < src.size(); ++i) {
+            worst = std::max(worst, glm::length(project(H, src[i]) - dst[i]));
+        }
+        return worst;
+    }
+
+    // A 10x10 grid at [1000, 1090]^2 with exact correspondences through H
+    void makeGrid(const glm::mat3& H, std::vector<glm::vec2>& src, std::vector<glm::vec2>& dst) {
+        for (int y = 0; y < 10; ++y) {
+            for (int x = 0; x < 10; ++x) {
+                src.push_back(glm::vec2(1000.0f + 10.0f * x, 1000.0f + 10.0f * y));
+                dst.push_back(project(H, src.back()));
+            }
+        }
+    }
+
+    // Data on the far side of H's horizon line from the source origin: Z is
+    // negative there once H is scaled to h22 = 1
+    void testBeyondHorizonFromOrigin() {
+        const glm::mat3 H = fromRows({ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { -0.002f, 0.0f, 1.0f } });
+        std::vector<glm::vec2> src, dst;
+        makeGrid(H, src, dst);
+
+        const gl::RansacResult result = gl::estimateHomographyRansac(src, dst);
+        test::check(result.success, "estimate beyond the horizon from the origin");
+        test::check(result.inlierCount == src.size(),
+            "every exact correspondence is an inlier (" + std::to_string(result.inlierCount) + " of 100)");
+        test::check(maxReprojectionError(result.homography, src, dst) < 0.01f, "estimate reprojects the grid");
+    }
+
+    // Same data with a fifth of the correspondences replaced by outliers
+    void testBeyondHorizonWithOutliers() {
+        const glm::mat3 H = fromRows({ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { -0.002f, 0.0f, 1.0f } });
+        std::vector<glm::vec2> src, dst;
+        makeGrid(H, src, dst);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> offset(50.0f, 200.0f);
+        for (size_t i = 0; i < dst.size(); i += 5) {
+            dst[i] += glm::vec2(offset(rng), -offset(rng));
+        }
+
+        const gl::RansacResult result = gl::estimateHomographyRansac(src, dst);
+        test::check(result.success && result.inlierCount == 80,
+            "outliers rejected beyond the horizon (" + std::to_string(result.inlierCount) + " of 80 inliers)");
+        int maskErrors = result.inliers.size() == src.size() ? 0 : static_cast<int>(src.size());
+        for (size_t i = 0; i < result.inliers.size(); ++i) {
+            maskErrors += (result.inliers[i] != 0) != (i % 5 != 0);
+        }
+        test::check(maskErrors == 0, "inlier mask marks exactly the outliers (" + std::to_string(maskErrors) + " wrong)");
+    }
+
+    // Data on the origin's side, which worked before, still does
+    void testOriginSide() {
+        const glm::mat3 H = fromRows({ { 1.1f, 0.05f, 3.0f }, { -0.02f, 0.9f, -4.0f }, { 0.0002f, 0.0001f, 1.0f } });
+        std::vector<glm::vec2> src, dst;
+        makeGrid(H, src, dst);
+
+        const gl::RansacResult result = gl::estimateHomographyRansac(src, dst);
+        test::check(result.success && result.inlierCount == src.size(), "estimate on the origin's side");
+        test::check(maxReprojectionError(result.homography, src, dst) < 0.01f, "origin-side estimate reprojects the grid");
+    }
+
+} // namespace
+
+void runRansacTests() {
+    test::printHeader("ransac");
+    testBeyondHorizonFromOrigin();
+    testBeyondHorizonWithOutliers();
+    testOriginSide();
+}
@@ -0,0 +1,174 @@
+#include "Test.hpp"
+#include "../benchmarks/HeadlessContext.hpp"
+#include "../window/Window.hpp"
+#include "../core/Scene.hpp"
+#include "../managers/ResourceManager.hpp"
+#include "../components/camera/CameraComponent.hpp"
+#include "../components/geometry/MeshComponent.hpp"
+#include "../components/rendering/MeshRenderer.hpp"
+#include "../components/effects/HomographyEffect.hpp"
+
+#include <string>
+#include <thread>
+
+namespace {
+
+    constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+    // A camera, two cubes and a decal effect aimed at both. Nothing is
+    // loaded from disk: without shaders, meshes are culled and recorded
+    // but not drawn, and the effect solves and uploads without drawing.
+    class TargetScene : public Scene {
+    public:
+        using Scene::Scene;
+
+        EntityHandle camera;
+        EntityHandle cubes[2];
+        HomographyEffect* effect = nullptr;
+
+    protected:
+        void setupScene() override {
+            Entity* cameraEntity = createEntity("MainCamera");
+            cameraEntity->addComponent<CameraComponent>(glm::vec3(0.0f, 0.0f, 3.0f));
+            camera = cameraEntity->getHandle();
+
+            const glm::vec3 positions[] = { glm::vec3(-0.8f, 0.0f, 0.0f), glm::vec3(0.8f, 0.0f, 0.0f) };
+            for (int i = 0; i < 2; ++i) {
+                Entity* cubeEntity = createEntity("Cube");
+                auto mesh = cubeEntity->addComponent<MeshComponent>();
+                mesh->createCube();
+                mesh->setPosition(positions[i]);
+                mesh->setRotation(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+                mesh->setAutoRotate(true);
+                cubeEntity->addComponent<MeshRenderer>();
+                cubes[i] = cubeEntity->getHandle();
+            }
+
+            Entity* effectEntity = createEntity("HomographyEffect");
+            effectEntity->addComponent<MeshComponent>()->createQuad();
+            effect = effectEntity->addComponent<HomographyEffect>();
+            for (EntityHandle cube : cubes) {
+                effect->addTarget(cube);
+            }
+        }
+    };
+
+    // Decals are solved in the background; waiting before render makes the
+    // frame upload the solve it started
+    void stepFrame(TargetScene& scene) {
+        scene.update(DELTA_TIME);
+        scene.effect->waitForSolves();
+        scene.render();
+    }
+
+    // Components hold handles to other entities; destroying those entities
+    // must leave the next frame running on whatever is still alive
+    void testDestroyTarget(Window& window, ResourceManager& resources) {
+        TargetScene scene(window, resources);
+        scene.init();
+        stepFrame(scene);
+        const int bothCubes = scene.effect->getDecalCount();
+        test::check(bothCubes > 0, "decals for the two target cubes");
+
+        scene.destroyEntity(scene.cubes[0]);
+        stepFrame(scene);
+        const int oneCube = scene.effect->getDecalCount();
+        test::check(oneCube > 0 && oneCube < bothCubes,
+            "decals drop to the surviving cube (" + std::to_string(bothCubes) + " -> " + std::to_string(oneCube) + ")");
+
+        // Deferred, as a component would do it mid-update
+        scene.deferDestroyEntity(scene.cubes[1]);
+        stepFrame(scene);
+        test::check(scene.effect->getDecalCount() == 0, "no decals once every target is gone");
+    }
+
+    // Solves finish off the frame; when several have by the time render
+    // collects them, only the newest is uploaded
+    void testStaleSolvesDropped(Window& window, ResourceManager& resources) {
+        TargetScene scene(window, resources);
+        scene.init();
+        stepFrame(scene);
+        test::check(scene.effect->getDecalCount() > 0, "decals from the first solve");
+
+        // Two solves in flight: one cube, then none
+        scene.destroyEntity(scene.cubes[0]);
+        scene.update(DELTA_TIME);
+        scene.destroyEntity(scene.cubes[1]);
+        scene.update(DELTA_TIME);
+        scene.effect->waitForSolves();
+        scene.render();
+        test::check(scene.effect->getDecalCount() == 0, "stale one-cube solve dropped for the newer empty one");
+    }
+
+    void testDestroyCamera(Window& window, ResourceManager& resources) {
+        TargetScene scene(window, resources);
+        scene.init();
+        stepFrame(scene);
+        const int decals = scene.effect->getDecalCount();
+
+        scene.destroyEntity(scene.camera);
+        stepFrame(scene);
+        test::check(!scene.isAlive(scene.camera), "camera destroyed");
+        test::check(scene.effect->getDecalCount() == decals, "decals kept while there is no camera");
+
+        // Renderers looked the camera up by handle at init
+        Entity* cube = scene.getEntity(scene.cubes[0]);
+        cube->getComponent<MeshRenderer>()->render();
+        stepFrame(scene);
+        test::check(scene.getEntityCount() == 3, "cubes and effect still alive");
+    }
+
+    struct Marker {};
+
+    // The scene's own updates are systems: entity updates get the first
+    // phase to themselves, on the calling thread, and World systems follow
+    void testSystems(Window& window, ResourceManager& resources) {
+        gl::JobSystem jobs(2);
+        TargetScene scene(window, resources);
+        scene.setJobSystem(&jobs);
+        scene.init();
+
+        const std::thread::id mainThread = std::this_thread::get_id();
+        std::thread::id updateThread;
+        SystemScheduler& systems = scene.getSystems();
+        systems.addSystem("Marker", makeSystemAccess<Writes<Marker>>(), [](World&, gl::JobSystem&, float) {});
+        systems.addSystem("Input", makeSystemAccess<MainThread>(), [&](World&, gl::JobSystem&, float) {
+            updateThread = std::this_thread::get_id();
+        });
+        const auto& phases = systems.getPhases();
+        test::check(phases.size() == 3 && phases[0].size() == 1 && systems.getSystemName(phases[0][0]) == "EntityUpdates",
+            "entity updates in a phase of their own, first");
+        test::check(phases[2].size() == 1 && systems.getSystemName(phases[2][0]) == "Input",
+            "main-thread system after the others");
+
+        const glm::mat4 before = scene.getEntity(scene.cubes[0])->getComponent<MeshComponent>()->getModelMatrix();
+        stepFrame(scene);
+        const glm::mat4 after = scene.getEntity(scene.cubes[0])->getComponent<MeshComponent>()->getCachedModelMatrix();
+        test::check(updateThread == mainThread, "main-thread system ran on the calling thread");
+        test::check(before != after, "auto-rotating cube animated by the scene's systems");
+    }
+
+} // namespace
+
+void runSceneTests() {
+    test::printHeader("scene");
+
+    bench::HeadlessContext context;
+    if (!context.isValid()) {
+        test::skip(context.getDescription());
+        return;
+    }
+
+    // The scene needs a Window; the context above does the rendering
+    bench::HeadlessWindow window;
+    if (!window.isValid()) {
+        test::skip(window.getDescription());
+        return;
+    }
+    ResourceManager resources;
+
+    testDestroyTarget(window.get(), resources);
+    testStaleSolvesDropped(window.get(), resources);
+    testDestroyCamera(window.get(), resources);
+    testSystems(window.get(), resources);
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_HPP
+#define TEST_HPP
+
+#include <cstdio>
+#include <string>
+
+namespace test {
+
+    // Failed checks so far; main() exits non-zero when any failed
+    inline int failures = 0;
+
+    // Set when a suite can't run here, e.g. without an OpenGL context
+    inline bool skipped = false;
+
+    inline void skip(const std::string& reason) {
+        skipped = true;
+        std::printf("  SKIPPED: %s\n", reason.c_str());
+    }
+
+    inline void check(bool condition, const std::string& what) {
+        if (!condition) {
+            ++failures;
+            std::printf("  FAILED: %s\n", what.c_str());
+        }
+    }
+
+    inline void printHeader(const std::string& title) {
+        std::printf("\n== %s ==\n", title.c_str());
+    }
+
+} // namespace test
+
+// Suite entry points
+void runWarpTests();
+void runSceneTests();
+void runRansacTests();
+void runCommandBufferTests();
+void runJobSystemTests();
+void runEcsTests();
+
+#endif // TEST_HPP
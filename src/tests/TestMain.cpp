@@ -0,0 +1,56 @@
+#include "Test.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+    struct Suite {
+        const char* name;
+        void (*run)();
+    };
+
+    const Suite suites[] = {
+        { "warp", runWarpTests },
+        { "scene", runSceneTests },
+        { "ransac", runRansacTests },
+        { "commands", runCommandBufferTests },
+        { "jobs", runJobSystemTests },
+        { "ecs", runEcsTests },
+    };
+
+} // namespace
+
+// Usage: Tests [suite ...]   (runs every suite when none is given)
+int main(int argc, char** argv) {
+    bool ranAny = false;
+    for (const Suite& suite : suites) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], suite.name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            suite.run();
+            ranAny = true;
+        }
+    }
+
+    if (!ranAny) {
+        std::fprintf(stderr, "Unknown suite. Available:");
+        for (const Suite& suite : suites) {
+            std::fprintf(stderr, " %s", suite.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+
+    if (test::failures > 0) {
+        std::printf("\nSome checks failed\n");
+        return 1;
+    }
+    // 77 tells ctest the suite was skipped
+    std::printf("\n%s\n", test::skipped ? "Skipped" : "All checks passed");
+    return test::skipped ? 77 : 0;
+}
@@ -0,0 +1,108 @@
+#include "Test.hpp"
+#include "gl/warp.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    gl::Image makeNoiseImage(int width, int height, unsigned seed) {
+        gl::Image image(width, height, 4);
+        std::mt19937 rng(seed);
+        for (size_t i = 0; i < image.getSizeInBytes(); ++i) {
+            image.getData()[i] = static_cast<std::uint8_t>(rng());
+        }
+        return image;
+    }
+
+    // Sample positions on and around the edges of an axis [0, size), where
+    // nearest sampling switches between a pixel and the border
+    std::vector<float> edgePositions(int size) {
+        const float last = static_cast<float>(size);
+        std::vector<float> positions;
+        for (float p : { -1.0f, -0.75f, -0.5f, -0.25f, 0.0f, 0.25f, 0.5f,
+                         last - 1.5f, last - 1.0f, last - 0.75f, last - 0.5f, last - 0.25f, last }) {
+            positions.push_back(std::nextafter(p, -INFINITY));
+            positions.push_back(p);
+            positions.push_back(std::nextafter(p, INFINITY));
+        }
+        return positions;
+    }
+
+    int countDifferences(const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b) {
+        int differences = 0;
+        for (size_t i = 0; i < a.size(); i += 4) {
+            if (std::memcmp(&a[i], &b[i], 4) != 0) {
+                ++differences;
+            }
+        }
+        return differences;
+    }
+
+    // The vectorized nearest sampler (AVX2 where compiled in, else SSE) must
+    // pick the same pixel or border as the scalar one on every edge position
+    void testNearestBorderMatchesScalar() {
+        const gl::Image src = makeNoiseImage(37, 23, 5);
+        std::vector<float> us;
+        std::vector<float> vs;
+        for (float v : edgePositions(src.getHeight())) {
+            for (float u : edgePositions(src.getWidth())) {
+                us.push_back(u);
+                vs.push_back(v);
+            }
+        }
+        const int count = static_cast<int>(us.size());
+
+        gl::WarpOptions options;
+        options.filter = gl::WarpFilter::Nearest;
+        options.borderColor[0] = 1;
+        options.borderColor[1] = 2;
+        options.borderColor[2] = 3;
+        options.borderColor[3] = 4;
+
+        std::vector<std::uint8_t> scalar(us.size() * 4);
+        std::vector<std::uint8_t> vectorized(us.size() * 4);
+        options.vectorize = false;
+        gl::detail::sampleSpan(src, us.data(), vs.data(), count, scalar.data(), options);
+        options.vectorize = true;
+        gl::detail::sampleSpan(src, us.data(), vs.data(), count, vectorized.data(), options);
+
+        const int differences = countDifferences(scalar, vectorized);
+        test::check(differences == 0, "nearest sampler differs from scalar on " +
+            std::to_string(differences) + " of " + std::to_string(count) + " edge samples");
+    }
+
+    // Whole warps: the destination overhangs every source edge by a fraction
+    // of a pixel, so each border row and column lands on an edge position
+    void testNearestWarpMatchesScalar() {
+        const gl::Image src = makeNoiseImage(64, 48, 7);
+        for (float offset : { -0.75f, -0.5f, -0.25f, 0.25f, 0.5f }) {
+            const glm::mat3 H(1.0f, 0.0f, 0.0f,
+                              0.0f, 1.0f, 0.0f,
+                              offset, offset, 1.0f);
+            gl::Image scalar(src.getWidth() + 2, src.getHeight() + 2, 4);
+            gl::Image vectorized(src.getWidth() + 2, src.getHeight() + 2, 4);
+
+            gl::JobSystem serial(0);
+            gl::WarpOptions options;
+            options.filter = gl::WarpFilter::Nearest;
+            options.pool = &serial;
+            options.vectorize = false;
+            gl::warpPerspective(src, H, scalar, options);
+            options.vectorize = true;
+            gl::warpPerspective(src, H, vectorized, options);
+
+            test::check(std::memcmp(scalar.getData(), vectorized.getData(), scalar.getSizeInBytes()) == 0,
+                "nearest warp with offset " + std::to_string(offset) + " differs from scalar");
+        }
+    }
+
+} // namespace
+
+void runWarpTests() {
+    test::printHeader("warp");
+    testNearestBorderMatchesScalar();
+    testNearestWarpMatchesScalar();
+}